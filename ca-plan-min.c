@@ -0,0 +1,366 @@
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "mutation_plan.h"
+#include "plan_log.h"
+
+// Minimizes a crashing mutation at plan level. The record for one mutation is taken
+// from a plan log written with CA_MUTATOR_PLAN_LOG, and ddmin runs over its ops: each
+// candidate subset is applied to the parent input and the target is run on the
+// result. A run counts as a crash when the target dies from a signal other than the
+// timeout's SIGALRM, or exits with the --crash-exit code. As under afl-fuzz, ASan and
+// UBSan are told to abort on a report, so sanitizer findings die from SIGABRT rather
+// than exiting with an error code. Plans rarely hold more than a few ops, so this
+// takes dozens of executions where a byte-level reduction of the whole file takes
+// thousands.
+
+typedef struct {
+    // Parent input and the logged plan; `plan` is a view into the mapped log.
+    const uint8_t *input;
+    size_t input_len;
+    const normalized_plan_t *plan;
+
+    char **target_argv;
+    // Index of the "@@" argument replaced with `path`, or -1 to feed stdin.
+    int file_arg;
+    char path[64];
+    unsigned timeout;
+    // Exit status that counts as a crash, or -1.
+    int crash_exit;
+
+    uint8_t *out;
+    size_t out_capacity;
+    mutation_op_t *ops;
+    size_t executions;
+} min_ctx_t;
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "Usage: %s [--timeout S] [--crash-exit CODE] [--out F] <plan.log> "
+            "<mutation> <input_file> -- <target> [args...]\n"
+            "  <mutation> is the number printed by standalone-mutator and "
+            "ca-plan-replay;\n"
+            "  an @@ argument is replaced with the mutated file, else it goes to "
+            "stdin;\n"
+            "  --crash-exit also counts exiting with CODE (1-255) as a crash.\n",
+            argv0);
+}
+
+static bool read_file(const char *path, uint8_t **data, size_t *len) {
+    FILE *in = fopen(path, "rb");
+    if (!in) return false;
+    bool ok = fseek(in, 0, SEEK_END) == 0;
+    long size = ok ? ftell(in) : -1;
+    ok = ok && size >= 0 && fseek(in, 0, SEEK_SET) == 0;
+    uint8_t *buf = ok ? (uint8_t *)malloc(size > 0 ? (size_t)size : 1u) : NULL;
+    ok = buf && fread(buf, 1, (size_t)size, in) == (size_t)size;
+    fclose(in);
+    if (!ok) {
+        free(buf);
+        return false;
+    }
+    *data = buf;
+    *len = (size_t)size;
+    return true;
+}
+
+static bool write_file(const char *path, const uint8_t *data, size_t len) {
+    FILE *out = fopen(path, "wb");
+    if (!out) return false;
+    bool ok = fwrite(data, 1, len, out) == len;
+    return fclose(out) == 0 && ok;
+}
+
+// Applies the ops of `plan` listed in `keep` to the parent input into ctx->out.
+static bool min_apply(min_ctx_t *ctx, const size_t *keep, size_t keep_count,
+                      size_t *out_len) {
+    for (size_t i = 0; i < keep_count; ++i) ctx->ops[i] = ctx->plan->ops[keep[i]];
+    // A subset of a normalized plan is still normalized: dropping ops never
+    // introduces a conflict.
+    normalized_plan_t subset = {
+        .ops = ctx->ops,
+        .op_count = keep_count,
+        .extra_bytes = ctx->plan->extra_bytes,
+        .extra_bytes_len = ctx->plan->extra_bytes_len,
+    };
+    size_t len = 0;
+    if (mutation_plan_measure(&subset, ctx->input_len, &len) != CA_STATUS_OK) return false;
+    if (len > ctx->out_capacity) {
+        uint8_t *grown = (uint8_t *)realloc(ctx->out, len);
+        if (!grown) return false;
+        ctx->out = grown;
+        ctx->out_capacity = len;
+    }
+    return mutation_plan_apply(&subset, ctx->input, ctx->input_len, ctx->out,
+                               ctx->out_capacity, out_len, NULL) == CA_STATUS_OK;
+}
+
+// Appends `extra` to the sanitizer options in `name`, keeping the user's; later
+// options win, so these apply even over conflicting ones.
+static bool min_sanitizer_env(const char *name, const char *extra) {
+    const char *current = getenv(name);
+    if (!current || !*current) return setenv(name, extra, 1) == 0;
+    size_t len = strlen(current) + 1u + strlen(extra) + 1u;
+    char *value = (char *)malloc(len);
+    if (!value) return false;
+    snprintf(value, len, "%s:%s", current, extra);
+    bool ok = setenv(name, value, 1) == 0;
+    free(value);
+    return ok;
+}
+
+// Runs the target on ctx->out[0, len); returns the crashing signal or the
+// --crash-exit code, 0 when the target exits otherwise or times out, and -1 when it
+// cannot be run.
+static int min_run(min_ctx_t *ctx, size_t len) {
+    if (!write_file(ctx->path, ctx->out, len)) return -1;
+    ++ctx->executions;
+
+    pid_t pid = fork();
+    if (pid < 0) return -1;
+    if (pid == 0) {
+        int null_fd = open("/dev/null", O_RDWR);
+        int in_fd = ctx->file_arg < 0 ? open(ctx->path, O_RDONLY) : null_fd;
+        if (in_fd >= 0) dup2(in_fd, STDIN_FILENO);
+        if (null_fd >= 0) {
+            dup2(null_fd, STDOUT_FILENO);
+            dup2(null_fd, STDERR_FILENO);
+        }
+        if (ctx->file_arg >= 0) ctx->target_argv[ctx->file_arg] = ctx->path;
+        // The pending alarm survives exec and kills a hanging target.
+        alarm(ctx->timeout);
+        execvp(ctx->target_argv[0], ctx->target_argv);
+        _exit(127);
+    }
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) return -1;
+    }
+    if (WIFEXITED(status)) {
+        if (WEXITSTATUS(status) == 127) return -1;
+        return WEXITSTATUS(status) == ctx->crash_exit ? ctx->crash_exit : 0;
+    }
+    if (!WIFSIGNALED(status) || WTERMSIG(status) == SIGALRM) return 0;
+    return WTERMSIG(status);
+}
+
+// Whether the ops in `keep` still crash the target; -1 on a harness error.
+static int min_test(min_ctx_t *ctx, const size_t *keep, size_t keep_count) {
+    size_t len = 0;
+    if (!min_apply(ctx, keep, keep_count, &len)) return -1;
+    int sig = min_run(ctx, len);
+    return sig < 0 ? -1 : sig > 0;
+}
+
+// Zeller's ddmin over `keep`, which starts as every op and ends as a 1-minimal
+// crashing subset: removing any single op left makes the crash go away.
+static int min_ddmin(min_ctx_t *ctx, size_t *keep, size_t *keep_count) {
+    size_t *trial = (size_t *)malloc((*keep_count + 1u) * sizeof(*trial));
+    if (!trial) return -1;
+
+    size_t n = 2;
+    int result = 0;
+    while (*keep_count >= 2u && result >= 0) {
+        const size_t count = *keep_count;
+        if (n > count) n = count;
+        bool reduced = false;
+
+        // Try each chunk on its own, then each complement.
+        for (size_t pass = 0; pass < 2 && !reduced; ++pass) {
+            // With two chunks the complements are the chunks again.
+            if (pass == 1 && n == 2u) break;
+            for (size_t c = 0; c < n && !reduced; ++c) {
+                size_t begin = c * count / n;
+                size_t end = (c + 1u) * count / n;
+                size_t trial_count = 0;
+                for (size_t i = 0; i < count; ++i) {
+                    bool in_chunk = i >= begin && i < end;
+                    if (in_chunk == (pass == 0)) trial[trial_count++] = keep[i];
+                }
+                result = min_test(ctx, trial, trial_count);
+                if (result < 0) break;
+                if (result > 0) {
+                    memcpy(keep, trial, trial_count * sizeof(*keep));
+                    *keep_count = trial_count;
+                    n = pass == 0 ? 2u : (n > 2u ? n - 1u : 2u);
+                    reduced = true;
+                }
+            }
+        }
+        if (result < 0) break;
+        if (!reduced) {
+            if (n >= count) break;
+            n = n * 2u < count ? n * 2u : count;
+        }
+        result = 0;
+    }
+    free(trial);
+    return result < 0 ? -1 : 0;
+}
+
+static const char *min_op_name(uint8_t kind) {
+    static const char *const kNames[] = {
+        "?",          "BIT_FLIP",     "SET_BYTE",     "ADD_BYTE",
+        "SUB_BYTE",   "DELETE_RANGE", "INSERT_BYTES", "XOR_RANGE",
+        "FILL_RANGE", "COPY_RANGE",   "ADD_INT",      "SUB_INT",
+        "SET_INT",    "INSERT_FROM_ADD", "OVERWRITE_FROM_ADD",
+    };
+    return kind < sizeof(kNames) / sizeof(*kNames) ? kNames[kind] : "?";
+}
+
+int main(int argc, char **argv) {
+    const char *out_path = NULL;
+    unsigned timeout = 5;
+    int crash_exit = -1;
+    int arg = 1;
+    for (; arg + 1 < argc && strncmp(argv[arg], "--", 2) == 0 && argv[arg][2]; arg += 2) {
+        if (strcmp(argv[arg], "--out") == 0) {
+            out_path = argv[arg + 1];
+        } else if (strcmp(argv[arg], "--timeout") == 0) {
+            timeout = (unsigned)strtoul(argv[arg + 1], NULL, 10);
+        } else if (strcmp(argv[arg], "--crash-exit") == 0) {
+            char *end = NULL;
+            long code = strtol(argv[arg + 1], &end, 10);
+            // 127 is the shell's "command not found", which min_run treats as an error.
+            if (!*argv[arg + 1] || *end || code < 1 || code > 255 || code == 127) {
+                fprintf(stderr, "--crash-exit: invalid exit code %s\n", argv[arg + 1]);
+                return 1;
+            }
+            crash_exit = (int)code;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (argc - arg < 5 || strcmp(argv[arg + 3], "--") != 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    const char *log_path = argv[arg];
+    const uint64_t mutation = strtoull(argv[arg + 1], NULL, 10);
+    const char *input_path = argv[arg + 2];
+
+    min_ctx_t ctx = {.target_argv = &argv[arg + 4],
+                     .file_arg = -1,
+                     .timeout = timeout,
+                     .crash_exit = crash_exit};
+    for (int i = 1; ctx.target_argv[i]; ++i) {
+        if (strcmp(ctx.target_argv[i], "@@") == 0) ctx.file_arg = i;
+    }
+
+    if (!min_sanitizer_env("ASAN_OPTIONS", "abort_on_error=1") ||
+        !min_sanitizer_env("UBSAN_OPTIONS", "halt_on_error=1:abort_on_error=1")) {
+        fprintf(stderr, "failed to set sanitizer options\n");
+        return 1;
+    }
+
+    uint8_t *input = NULL;
+    size_t input_len = 0;
+    if (!read_file(input_path, &input, &input_len)) {
+        fprintf(stderr, "failed to read input file %s\n", input_path);
+        return 1;
+    }
+    plan_log_reader_t reader = {0};
+    if (plan_log_reader_open(log_path, &reader) != CA_STATUS_OK) {
+        fprintf(stderr, "failed to open plan log %s\n", log_path);
+        free(input);
+        return 1;
+    }
+
+    // Records print as mutation_id + 1, like standalone-mutator's mutation lines. A
+    // log appended to by several runs repeats ids, so the input picks the record.
+    const uint64_t input_hash = plan_log_hash(input, input_len);
+    plan_log_record_t record;
+    ca_status_t status;
+    bool seen = false;
+    while ((status = plan_log_next(&reader, &record)) == CA_STATUS_OK) {
+        if (record.mutation_id + 1u != mutation) continue;
+        seen = true;
+        if (record.input_len == input_len && record.input_hash == input_hash) break;
+    }
+
+    int exit_code = 1;
+    size_t *keep = NULL;
+    int fd = -1;
+    if (status != CA_STATUS_OK) {
+        if (seen) {
+            fprintf(stderr, "mutation %" PRIu64 ": %s is not its input\n", mutation,
+                    input_path);
+        } else {
+            fprintf(stderr, "mutation %" PRIu64 " is not in %s\n", mutation, log_path);
+        }
+        goto done;
+    }
+
+    ctx.input = input;
+    ctx.input_len = input_len;
+    ctx.plan = &record.plan;
+    const size_t op_count = record.plan.op_count;
+    keep = (size_t *)malloc((op_count + 1u) * sizeof(*keep));
+    ctx.ops = (mutation_op_t *)malloc((op_count + 1u) * sizeof(*ctx.ops));
+    snprintf(ctx.path, sizeof(ctx.path), "/tmp/ca-plan-min.XXXXXX");
+    fd = mkstemp(ctx.path);
+    if (!keep || !ctx.ops || fd < 0) {
+        fprintf(stderr, "setup failed\n");
+        goto done;
+    }
+    size_t keep_count = op_count;
+    for (size_t i = 0; i < op_count; ++i) keep[i] = i;
+
+    // The full plan must crash and the parent input must not.
+    int full = min_test(&ctx, keep, keep_count);
+    int parent = full > 0 ? min_test(&ctx, keep, 0) : 0;
+    if (full < 0 || parent < 0) {
+        fprintf(stderr, "cannot run target %s\n", ctx.target_argv[0]);
+        goto done;
+    }
+    if (full == 0 || parent > 0) {
+        fprintf(stderr, "mutation %" PRIu64 ": %s\n", mutation,
+                full == 0 ? "the logged plan does not crash the target"
+                          : "the parent input already crashes the target");
+        goto done;
+    }
+    if (min_ddmin(&ctx, keep, &keep_count) != 0) {
+        fprintf(stderr, "target run failed during minimization\n");
+        goto done;
+    }
+
+    printf("mutation %" PRIu64 ": %zu of %zu ops crash the target (%zu executions)\n",
+           mutation, keep_count, op_count, ctx.executions);
+    for (size_t i = 0; i < keep_count; ++i) {
+        const mutation_op_t *op = &record.plan.ops[keep[i]];
+        printf("  op#%zu kind=%s pos=%u len=%u arg=%u data_offset=%u\n", keep[i],
+               min_op_name(op->kind), op->pos, op->len, op->arg, op->data_offset);
+    }
+    size_t out_len = 0;
+    if (out_path && (!min_apply(&ctx, keep, keep_count, &out_len) ||
+                     !write_file(out_path, ctx.out, out_len))) {
+        fprintf(stderr, "failed to write %s\n", out_path);
+        goto done;
+    }
+    exit_code = 0;
+
+done:
+    if (fd >= 0) {
+        close(fd);
+        unlink(ctx.path);
+    }
+    plan_log_reader_close(&reader);
+    free(keep);
+    free(ctx.ops);
+    free(ctx.out);
+    free(input);
+    return exit_code;
+}
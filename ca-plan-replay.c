@@ -0,0 +1,182 @@
+#define _GNU_SOURCE
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mutation_plan.h"
+#include "plan_log.h"
+
+// Replays a plan log written with CA_MUTATOR_PLAN_LOG. Each record is applied to the
+// seed file whose hash and length match its input; the previous replayed output is
+// also a candidate, which covers campaigns that feed outputs back as inputs (like
+// standalone-mutator). Output lines match standalone-mutator's, so both runs can be
+// compared directly.
+
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    uint64_t hash;
+} replay_input_t;
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "Usage: %s [--out-dir D] <plan.log> <input_file>...\n", argv0);
+}
+
+static bool read_file(const char *path, replay_input_t *input) {
+    FILE *in = fopen(path, "rb");
+    if (!in) return false;
+    bool ok = fseek(in, 0, SEEK_END) == 0;
+    long size = ok ? ftell(in) : -1;
+    ok = ok && size >= 0 && fseek(in, 0, SEEK_SET) == 0;
+    uint8_t *data = ok ? (uint8_t *)malloc(size > 0 ? (size_t)size : 1u) : NULL;
+    ok = data && fread(data, 1, (size_t)size, in) == (size_t)size;
+    fclose(in);
+    if (!ok) {
+        free(data);
+        return false;
+    }
+    input->data = data;
+    input->len = (size_t)size;
+    input->hash = plan_log_hash(data, input->len);
+    return true;
+}
+
+static bool write_output(const char *dir, uint64_t index, const uint8_t *data,
+                         size_t len) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/id:%06" PRIu64, dir, index);
+    FILE *out = fopen(path, "wb");
+    if (!out) return false;
+    bool ok = fwrite(data, 1, len, out) == len;
+    return fclose(out) == 0 && ok;
+}
+
+static const replay_input_t *find_input(const replay_input_t *inputs, size_t count,
+                                        const replay_input_t *last,
+                                        const plan_log_record_t *record) {
+    if (last->data && last->hash == record->input_hash && last->len == record->input_len) {
+        return last;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (inputs[i].hash == record->input_hash && inputs[i].len == record->input_len) {
+            return &inputs[i];
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    const char *out_dir = NULL;
+    int first = 1;
+    if (argc > 2 && strcmp(argv[1], "--out-dir") == 0) {
+        out_dir = argv[2];
+        first = 3;
+    }
+    if (argc - first < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const char *log_path = argv[first];
+    size_t input_count = (size_t)(argc - first - 1);
+    replay_input_t *inputs = (replay_input_t *)calloc(input_count, sizeof(*inputs));
+    if (!inputs) {
+        fprintf(stderr, "calloc failed\n");
+        return 1;
+    }
+    bool error = false;
+    for (size_t i = 0; i < input_count && !error; ++i) {
+        if (!read_file(argv[first + 1 + (int)i], &inputs[i])) {
+            fprintf(stderr, "failed to read input file %s\n", argv[first + 1 + (int)i]);
+            error = true;
+        }
+    }
+
+    plan_log_reader_t reader = {0};
+    if (!error && plan_log_reader_open(log_path, &reader) != CA_STATUS_OK) {
+        fprintf(stderr, "failed to open plan log %s\n", log_path);
+        error = true;
+    }
+
+    size_t replayed = 0;
+    size_t missing = 0;
+    // `out` and `last` swap buffers so the previous output stays available as an
+    // input without a copy.
+    replay_input_t last = {0};
+    size_t last_capacity = 0;
+    uint8_t *out = NULL;
+    size_t out_capacity = 0;
+    while (!error) {
+        plan_log_record_t record;
+        ca_status_t status = plan_log_next(&reader, &record);
+        if (status == CA_STATUS_SKIP) break;
+        if (status != CA_STATUS_OK) {
+            fprintf(stderr, "truncated or malformed record at offset %zu\n",
+                    reader.offset);
+            error = true;
+            break;
+        }
+
+        const replay_input_t *input = find_input(inputs, input_count, &last, &record);
+        if (!input) {
+            fprintf(stderr, "mutation %" PRIu64 ": no input with hash %016" PRIu64
+                            " and length %" PRIu64 "\n",
+                    record.mutation_id + 1u, record.input_hash, record.input_len);
+            ++missing;
+            continue;
+        }
+
+        size_t out_len = 0;
+        status = mutation_plan_measure(&record.plan, input->len, &out_len);
+        if (status == CA_STATUS_OK && out_len > out_capacity) {
+            uint8_t *grown = (uint8_t *)realloc(out, out_len);
+            if (grown) {
+                out = grown;
+                out_capacity = out_len;
+            } else {
+                status = CA_STATUS_OUT_OF_MEMORY;
+            }
+        }
+        size_t written = 0;
+        bool changed = false;
+        if (status == CA_STATUS_OK) {
+            status = mutation_plan_apply(&record.plan, input->data, input->len, out,
+                                         out_capacity, &written, &changed);
+        }
+        if (status != CA_STATUS_OK || written != out_len) {
+            fprintf(stderr, "mutation %" PRIu64 ": plan does not apply\n",
+                    record.mutation_id + 1u);
+            error = true;
+            break;
+        }
+
+        uint64_t hash = plan_log_hash(out, written);
+        printf("\n--- mutation %" PRIu64 ": len=%zu (in_len=%zu, in_hash=%016" PRIu64
+               ", out_hash=%016" PRIu64 ") ---\n",
+               record.mutation_id + 1u, written, input->len, input->hash, hash);
+        if (out_dir && !write_output(out_dir, record.mutation_id + 1u, out, written)) {
+            fprintf(stderr, "failed to write mutation %" PRIu64 " to %s\n",
+                    record.mutation_id + 1u, out_dir);
+            error = true;
+        }
+
+        uint8_t *spare = last.data;
+        size_t spare_capacity = last_capacity;
+        last = (replay_input_t){.data = out, .len = written, .hash = hash};
+        last_capacity = out_capacity;
+        out = spare;
+        out_capacity = spare_capacity;
+        ++replayed;
+    }
+
+    plan_log_reader_close(&reader);
+    free(last.data);
+    free(out);
+    for (size_t i = 0; i < input_count; ++i) free(inputs[i].data);
+    free(inputs);
+    fprintf(stderr, "replay stats: replayed=%zu missing_inputs=%zu\n", replayed, missing);
+    return (error || missing > 0) ? 1 : 0;
+}
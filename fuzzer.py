@@ -216,7 +216,11 @@ def fuzz(input_corpus,
     os.environ['AFL_NO_WARN_INSTABILITY'] = '1'
 
     if not skip:
-        os.environ['AFL_DISABLE_TRIM'] = '1'
+        # The growing mutator trims from its cell activity in a few hundred steps
+        # at most; AFL++'s generic trimmer is too slow on large seeds.
+        custom_library = os.environ.get('AFL_CUSTOM_MUTATOR_LIBRARY', '')
+        if 'ca_mutator_growing' not in custom_library:
+            os.environ['AFL_DISABLE_TRIM'] = '1'
         os.environ['AFL_CMPLOG_ONLY_NEW'] = '1'
         if 'ADDITIONAL_ARGS' in os.environ:
             flags += os.environ['ADDITIONAL_ARGS'].split(' ')
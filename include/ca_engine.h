@@ -13,9 +13,92 @@ extern "C" {
 typedef struct mutation_plan mutation_plan_t;
 typedef struct ca_engine ca_engine_t;
 
+typedef enum {
+    // Growing engine: when the same input is mutated again, resume evolution from
+    // the previously evolved cell state instead of re-encoding from scratch.
+    CA_ENGINE_FLAG_LINEAGE = 1u << 0,
+    // Growing engine: after the first full step, only revisit cells whose stencil
+    // neighbourhood changed in the previous step or that drew no update. A cell
+    // settles once its activity stops moving, so settled cells no longer drift and
+    // the output differs from full stepping.
+    CA_ENGINE_FLAG_ACTIVE_SET = 1u << 1,
+    // Growing engine: for large inputs, evolve a multi-resolution pyramid where
+    // coarse levels select the regions that are encoded and decoded at 16-byte
+    // resolution.
+    CA_ENGINE_FLAG_PYRAMID = 1u << 2,
+    // Growing engine: emit only length-preserving ops (no insert/delete) so every
+    // mutation keeps the input length.
+    CA_ENGINE_FLAG_LENGTH_PRESERVING = 1u << 3,
+} ca_engine_flag_t;
+
+#define CA_GROWING_PARAMS_VERSION 3u
+
+// Op kinds decoded by the growing engine; `kind_weights[k]` weighs
+// mutation_op_kind_t `k + 1` (BIT_FLIP, SET_BYTE, ADD_BYTE, SUB_BYTE,
+// DELETE_RANGE, INSERT_BYTES) for k < CA_GROWING_BASE_KIND_COUNT, k = 6 the
+// integer ops (ADD_INT, SUB_INT, SET_INT) and k = 7 splices from the request's
+// `add_buf` (INSERT_FROM_ADD, OVERWRITE_FROM_ADD). The last two weigh 0 in the
+// v1 draw.
+#define CA_GROWING_BASE_KIND_COUNT 6u
+#define CA_GROWING_KIND_COUNT 8u
+#define CA_GROWING_MAX_KINDS 16u
+
+// How the growing engine places ops. CELL decodes every cell and keeps the top
+// `max_ops` by score (v1). The other modes draw `max_ops` distinct cells with
+// probability proportional to a per-cell weight (feature + 1, or the sum of the
+// external per-byte weights covered by the cell).
+typedef enum {
+    CA_GROW_POSITION_CELL = 0,
+    CA_GROW_POSITION_ACTIVITY,
+    CA_GROW_POSITION_ENTROPY,
+    CA_GROW_POSITION_PRINTABLE,
+    CA_GROW_POSITION_EXTERNAL,
+} ca_grow_position_mode_t;
+
+// Tuning parameters for the growing engine. Initialize with
+// ca_growing_params_init() and override individual fields; `version` guards
+// against callers built against a different layout.
+typedef struct {
+    uint32_t version;
+    // Bytes per cell.
+    uint32_t block_size;
+    // When non-zero, the block size doubles until the input needs at most this
+    // many cells.
+    uint32_t max_cells;
+    // Evolution runs `min_steps + rand_below(max_steps - min_steps + 1)` steps.
+    uint32_t min_steps;
+    uint32_t max_steps;
+    // Probability, in percent, that a cell is updated in a step.
+    uint32_t update_percent;
+    // Stencil weights for distances 1, 2, 4 and 8.
+    int32_t weights[4];
+    // max_ops = min(1 + cell_count / max_ops_divisor, max_ops_cap).
+    uint32_t max_ops_divisor;
+    uint32_t max_ops_cap;
+    // `ca_grow_position_mode_t`; added in version 2.
+    uint32_t position_mode;
+    // Relative op kind weights, see CA_GROWING_KIND_COUNT; all 0 keeps the v1
+    // `rand_below(256) % 6` draw. Added in version 3.
+    uint32_t kind_weights[CA_GROWING_MAX_KINDS];
+} ca_growing_params_t;
+
 typedef struct {
     // Reserved for future engine-local non-crypto context.
     void *user_context;
+    // Bitwise OR of `ca_engine_flag_t`; 0 keeps v1 behavior.
+    uint32_t flags;
+    // Growing engine: inputs of at least this many bytes are evolved and decoded
+    // through a randomly placed window of `window_cells` cells; 0 disables it.
+    size_t window_min_input;
+    // Window size in cells; 0 selects the engine default.
+    size_t window_cells;
+    // Growing engine: 0 keeps the single-threaded v1 RNG sequence. Any other value
+    // derives the update mask and decode draws from per-cell RNG streams (results
+    // depend on the seed but not on the thread count) and runs encode, masked
+    // updates and candidate generation on that many threads.
+    uint32_t worker_threads;
+    // Growing engine tuning; NULL selects the v1 defaults.
+    const ca_growing_params_t *growing_params;
 } ca_engine_config_t;
 
 typedef enum {
@@ -59,6 +142,8 @@ typedef struct {
     } value;
 } ca_output_t;
 
+void ca_growing_params_init(ca_growing_params_t *params);
+
 ca_status_t ca_engine_create_xor(const ca_engine_config_t *config, ca_rng_t rng,
                                 ca_engine_t **engine);
 ca_status_t ca_engine_create_growing(const ca_engine_config_t *config, ca_rng_t rng,
@@ -66,6 +151,18 @@ ca_status_t ca_engine_create_growing(const ca_engine_config_t *config, ca_rng_t
 ca_status_t ca_engine_mutate(ca_engine_t *engine,
                             const ca_mutate_request_t *request,
                             ca_output_t *output);
+// Mutates `request` and writes the final bytes into `dst`. `dst_cap` also bounds
+// the request's `max_output_len`. Buffer engines write their last generation
+// there directly. Plan engines apply their already normalized plan into `dst`; a
+// plan that would leave the input unchanged returns CA_STATUS_SKIP.
+ca_status_t ca_engine_mutate_into(ca_engine_t *engine, const ca_mutate_request_t *request,
+                                 uint8_t *dst, size_t dst_cap, size_t *out_len);
+// Plan session: ca_engine_begin prepares `request` once and every ca_engine_next
+// yields another output for it. The request input must stay valid and unchanged
+// until the next ca_engine_begin or ca_engine_mutate. Outputs follow the same
+// lifetime rules as ca_engine_mutate.
+ca_status_t ca_engine_begin(ca_engine_t *engine, const ca_mutate_request_t *request);
+ca_status_t ca_engine_next(ca_engine_t *engine, ca_output_t *output);
 void ca_engine_destroy(ca_engine_t *engine);
 
 #ifdef __cplusplus
@@ -6,4 +6,28 @@
 ca_status_t ca_engine_create_growing_impl(const ca_engine_config_t *config,
                                          ca_rng_t rng, ca_engine_t **engine);
 
+// Sets per-byte weights for CA_GROW_POSITION_EXTERNAL. The weights are copied;
+// bytes beyond `count` weigh 0. Passing count 0 clears them, and a call whose cells
+// all weigh 0 falls back to uniform cell weights.
+ca_status_t ca_growing_set_position_weights(ca_engine_t *engine, const uint32_t *weights,
+                                            size_t count);
+
+// Replaces the op kind weights (`count <= CA_GROWING_KIND_COUNT`, missing kinds weigh
+// 0) and rebuilds the alias table used by the decoder. All-zero weights restore the
+// v1 kind draw.
+ca_status_t ca_growing_set_kind_weights(ca_engine_t *engine, const uint32_t *weights,
+                                        size_t count);
+
+// Most cells ca_growing_cell_activity evolves; larger inputs get wider blocks.
+#define CA_GROWING_TRIM_MAX_CELLS 4096u
+
+// Encodes all of `input` at the configured block size, doubled until it needs at
+// most CA_GROWING_TRIM_MAX_CELLS cells, and evolves it like a full-resolution
+// mutation. `(*activity)[i]` is then the activity of bytes [i * block_size,
+// (i + 1) * block_size). The array is owned by the engine and valid until the next
+// call. Any open plan session ends.
+ca_status_t ca_growing_cell_activity(ca_engine_t *engine, const uint8_t *input,
+                                     size_t input_len, const uint8_t **activity,
+                                     size_t *cell_count, size_t *block_size);
+
 #endif  // CA_MUTATOR_GROWING_ENGINE_H_
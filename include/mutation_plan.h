@@ -1,6 +1,7 @@
 #ifndef CA_MUTATOR_MUTATION_PLAN_H_
 #define CA_MUTATOR_MUTATION_PLAN_H_
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -17,37 +18,66 @@ typedef enum {
     CA_OP_SUB_BYTE = 4,
     CA_OP_DELETE_RANGE = 5,
     CA_OP_INSERT_BYTES = 6,
+    // Range ops. XOR_RANGE and FILL_RANGE rewrite input bytes [pos, pos + len) in
+    // place; COPY_RANGE inserts a copy of input bytes [data_offset, data_offset + len)
+    // at `pos`, reading the original input, so a move is a copy plus a delete.
+    CA_OP_XOR_RANGE = 7,
+    CA_OP_FILL_RANGE = 8,
+    CA_OP_COPY_RANGE = 9,
+    // Integer ops on the `len`-byte (2, 4 or 8) field at `pos`, in the byte order
+    // `arg` selects. ADD_INT / SUB_INT wrap modulo the field width; SET_INT stores
+    // its value sign-extended to the width.
+    CA_OP_ADD_INT = 10,
+    CA_OP_SUB_INT = 11,
+    CA_OP_SET_INT = 12,
+    // Splice ops, reading the plan's `add_buf` by reference: INSERT_FROM_ADD inserts
+    // add_buf[data_offset, data_offset + len) at `pos`; OVERWRITE_FROM_ADD replaces
+    // input bytes [pos, pos + len) with them.
+    CA_OP_INSERT_FROM_ADD = 13,
+    CA_OP_OVERWRITE_FROM_ADD = 14,
 } mutation_op_kind_t;
 
+// Integer op `arg` flag; without it the field is little-endian.
+#define CA_OP_INT_BIG_ENDIAN 1u
+
+// Packed plan op, 16 bytes. Insert payloads are referenced by offset into the
+// owning plan's `extra_bytes`, so ops hold no pointers and plans can be copied or
+// serialized as plain memory.
 typedef struct {
-    mutation_op_kind_t kind;
     uint32_t pos;
     uint32_t len;
+    // INSERT_BYTES: offset of the `len` payload bytes in `extra_bytes`;
+    // XOR_RANGE: offset of the `arg`-byte key in `extra_bytes`;
+    // COPY_RANGE: input position of the copied bytes;
+    // INSERT_FROM_ADD / OVERWRITE_FROM_ADD: position of the bytes in `add_buf`;
+    // ADD_INT / SUB_INT: delta; SET_INT: value as int32_t.
+    uint32_t data_offset;
+    // mutation_op_kind_t.
+    uint8_t kind;
+    // BIT_FLIP: bit index; SET_BYTE: value; ADD_BYTE / SUB_BYTE: delta;
+    // XOR_RANGE: key length (1-255), repeated from `pos`; FILL_RANGE: fill byte;
+    // integer ops: CA_OP_INT_BIG_ENDIAN or 0.
+    uint8_t arg;
+    uint16_t reserved;
+} mutation_op_t;
+
+// Acceptance order of `ops[i]`, kept in a parallel array because only
+// normalization reads it.
+typedef struct {
     uint32_t score;
     uint32_t source_index;
-    union {
-        struct {
-            uint8_t bit_index;
-        } bit_flip;
-        struct {
-            uint8_t value;
-        } set_byte;
-        struct {
-            uint8_t delta;
-        } arithmetic;
-        struct {
-            const uint8_t *data;
-            size_t data_len;
-        } insert;
-    } arg;
-    size_t data_offset;
-} mutation_op_t;
+} mutation_op_rank_t;
 
 typedef struct mutation_plan {
     mutation_op_t *ops;
+    mutation_op_rank_t *ranks;
     size_t op_count;
     uint8_t *extra_bytes;
     size_t extra_bytes_len;
+    // Splice partner read by the *_FROM_ADD ops. Borrowed, never freed: normalize
+    // takes it from the limits, and it must stay valid while the plan is applied.
+    const uint8_t *add_buf;
+    size_t add_buf_len;
 } mutation_plan_t;
 
 typedef mutation_plan_t normalized_plan_t;
@@ -57,8 +87,59 @@ typedef struct {
     size_t max_output_len;
     size_t input_len;
     const uint8_t *input;
+    // Optional splice partner; without it *_FROM_ADD ops are dropped.
+    const uint8_t *add_buf;
+    size_t add_buf_len;
 } ca_plan_limits_t;
 
+// Scatter-gather view of an applied plan: the output is the concatenation of
+// `segments`, which point into the input, the plan's `extra_bytes` and `add_buf`, and
+// `patched`. Reused across calls; valid while the input and plan are unchanged.
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+} mutation_segment_t;
+
+typedef struct {
+    mutation_segment_t *segments;
+    size_t count;
+    size_t capacity;
+    uint8_t *patched;
+    size_t patched_capacity;
+    size_t total_len;
+} mutation_segments_t;
+
+// One entry of a gap buffer's undo journal: the bytes a replace overwrote or a delete
+// removed are kept in `saved` at `saved_offset`; `src` is the new bytes while the
+// plan is being applied.
+typedef struct {
+    uint8_t kind;
+    size_t pos;
+    size_t len;
+    size_t saved_offset;
+    const uint8_t *src;
+} mutation_gap_edit_t;
+
+// Persistent working copy of one input for in-place apply and revert. The content is
+// data[0, gap_start) followed by data[gap_end, capacity). Applying a plan moves the
+// gap to each delete and insert and overwrites point and range bytes in place, so the
+// work per mutation follows the edit and the distance between its length-changing
+// ops, not the input size. At most one plan is applied at a time.
+typedef struct {
+    uint8_t *data;
+    size_t capacity;
+    size_t gap_start;
+    size_t gap_end;
+    size_t len;
+    mutation_gap_edit_t *edits;
+    size_t edit_count;
+    size_t edit_capacity;
+    uint8_t *saved;
+    size_t saved_capacity;
+    uint8_t *scratch;
+    size_t scratch_capacity;
+} mutation_gap_buffer_t;
+
 ca_status_t mutation_plan_init(mutation_plan_t *plan);
 ca_status_t mutation_plan_add_bit_flip(mutation_plan_t *plan, uint32_t pos,
                                       uint8_t bit_mask, uint32_t score,
@@ -79,6 +160,31 @@ ca_status_t mutation_plan_add_insert_bytes(mutation_plan_t *plan, uint32_t pos,
                                           const uint8_t *data, uint32_t len,
                                           uint32_t score,
                                           uint32_t source_index);
+ca_status_t mutation_plan_add_xor_range(mutation_plan_t *plan, uint32_t pos,
+                                       uint32_t len, const uint8_t *key,
+                                       uint8_t key_len, uint32_t score,
+                                       uint32_t source_index);
+ca_status_t mutation_plan_add_fill_range(mutation_plan_t *plan, uint32_t pos,
+                                        uint32_t len, uint8_t value, uint32_t score,
+                                        uint32_t source_index);
+ca_status_t mutation_plan_add_copy_range(mutation_plan_t *plan, uint32_t pos,
+                                        uint32_t src_pos, uint32_t len,
+                                        uint32_t score, uint32_t source_index);
+ca_status_t mutation_plan_add_insert_from_add(mutation_plan_t *plan, uint32_t pos,
+                                             uint32_t add_pos, uint32_t len,
+                                             uint32_t score, uint32_t source_index);
+ca_status_t mutation_plan_add_overwrite_from_add(mutation_plan_t *plan, uint32_t pos,
+                                                uint32_t add_pos, uint32_t len,
+                                                uint32_t score, uint32_t source_index);
+ca_status_t mutation_plan_add_add_int(mutation_plan_t *plan, uint32_t pos,
+                                     uint8_t width, bool big_endian, uint32_t delta,
+                                     uint32_t score, uint32_t source_index);
+ca_status_t mutation_plan_add_sub_int(mutation_plan_t *plan, uint32_t pos,
+                                     uint8_t width, bool big_endian, uint32_t delta,
+                                     uint32_t score, uint32_t source_index);
+ca_status_t mutation_plan_add_set_int(mutation_plan_t *plan, uint32_t pos,
+                                     uint8_t width, bool big_endian, int32_t value,
+                                     uint32_t score, uint32_t source_index);
 void mutation_plan_destroy(mutation_plan_t *plan);
 
 void normalized_plan_free(normalized_plan_t *plan);
@@ -89,7 +195,48 @@ ca_status_t mutation_plan_measure(const normalized_plan_t *plan, size_t input_le
                                  size_t *output_len);
 ca_status_t mutation_plan_apply(const normalized_plan_t *plan, const uint8_t *input,
                                size_t input_len, uint8_t *output,
-                               size_t output_capacity, size_t *output_len);
+                               size_t output_capacity, size_t *output_len,
+                               bool *changed);
+ca_status_t mutation_plan_segments(const normalized_plan_t *plan, const uint8_t *input,
+                                  size_t input_len, mutation_segments_t *segments,
+                                  bool *changed);
+void mutation_segments_free(mutation_segments_t *segments);
+// Applies a length-preserving plan (point and range ops only) to `data` in place.
+ca_status_t mutation_plan_patch(const normalized_plan_t *plan, uint8_t *data,
+                               size_t len, bool *changed);
+// Copies `len` bytes into `buffer` as its content and clears its journal.
+ca_status_t mutation_gap_buffer_load(mutation_gap_buffer_t *buffer, const uint8_t *data,
+                                     size_t len);
+// Applies `plan`, a plan over the buffer's current content, in place and journals
+// what it overwrote. Fails with CA_STATUS_INVALID_ARGUMENT while a plan is applied.
+ca_status_t mutation_plan_apply_gap(const normalized_plan_t *plan,
+                                    mutation_gap_buffer_t *buffer, bool *changed);
+// Undoes the applied plan, if any, restoring the loaded content.
+void mutation_gap_buffer_revert(mutation_gap_buffer_t *buffer);
+// The content as at most two segments, before and after the gap; returns the count.
+size_t mutation_gap_buffer_view(const mutation_gap_buffer_t *buffer,
+                                mutation_segment_t segments[2]);
+// Moves the gap to the end and returns the content as one contiguous block.
+const uint8_t *mutation_gap_buffer_flatten(mutation_gap_buffer_t *buffer);
+void mutation_gap_buffer_free(mutation_gap_buffer_t *buffer);
+// Fuses `a`, a plan over an input of `input_len` bytes, and `b`, a plan over `a`'s
+// output, into one plan over the input with the same result as applying `a` then
+// `b`. `input` is optional: it is read when two point ops meet on one byte and have
+// no single-op form (such as a bit flip then an add), and for copy and XOR range
+// ops, which come out as literal inserts; without it those fail with
+// CA_STATUS_INVALID_ARGUMENT. Fill ranges and splice ops also come out as literal
+// inserts, so the result never reads an `add_buf`.
+ca_status_t mutation_plan_compose(const normalized_plan_t *a, const normalized_plan_t *b,
+                                 const uint8_t *input, size_t input_len,
+                                 normalized_plan_t *result);
+// Builds a plan over `old` whose apply gives `new_buf`: shared prefix and suffix are
+// kept, large unchanged regions are found by block hashing, and what is left goes
+// through a bounded edit-distance pass. `limits` is optional; only `max_ops` and
+// `max_output_len` are read. A plan over `max_ops` falls back to one replacement of
+// the changed middle. Identical buffers give an empty plan.
+ca_status_t mutation_plan_diff(const uint8_t *old, size_t old_len, const uint8_t *new_buf,
+                              size_t new_len, const ca_plan_limits_t *limits,
+                              normalized_plan_t *result);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,69 @@
+#ifndef CA_MUTATOR_PLAN_LOG_H_
+#define CA_MUTATOR_PLAN_LOG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ca_engine.h"
+#include "mutation_plan.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Append-only binary log of normalized plans, in host byte order:
+//
+//   file header:  "CAPLOG\0\0", u32 version, u32 sizeof(mutation_op_t)
+//   each record:  u32 record_len, u32 op_count, u32 payload_len, u32 reserved,
+//                 u64 mutation_id, u64 input_hash, u64 input_len,
+//                 op_count packed ops, payload_len extra bytes, zero padding
+//
+// `record_len` covers the whole record and is a multiple of 8, so ops in a mapped
+// log are always aligned. A plan replays with mutation_plan_apply against the input
+// whose plan_log_hash and length match the record.
+
+#define CA_PLAN_LOG_VERSION 1u
+
+typedef struct plan_log_writer plan_log_writer_t;
+
+// Opens `path` for appending, creating it with a file header when it is empty. An
+// existing file must start with a matching header.
+ca_status_t plan_log_writer_open(const char *path, plan_log_writer_t **writer);
+// Buffers one record; full buffers are written out as they fill.
+ca_status_t plan_log_append(plan_log_writer_t *writer, uint64_t mutation_id,
+                           uint64_t input_hash, size_t input_len,
+                           const normalized_plan_t *plan);
+ca_status_t plan_log_flush(plan_log_writer_t *writer);
+// Flushes and closes; NULL is ignored.
+void plan_log_writer_close(plan_log_writer_t *writer);
+
+typedef struct {
+    const uint8_t *base;
+    size_t size;
+    size_t offset;
+} plan_log_reader_t;
+
+typedef struct {
+    uint64_t mutation_id;
+    uint64_t input_hash;
+    uint64_t input_len;
+    // Read-only view into the mapped log with no ranks; valid until
+    // plan_log_reader_close and never passed to normalized_plan_free.
+    normalized_plan_t plan;
+} plan_log_record_t;
+
+// Maps `path` read-only and checks its file header.
+ca_status_t plan_log_reader_open(const char *path, plan_log_reader_t *reader);
+// Returns the next record, CA_STATUS_SKIP at the end of the log, or
+// CA_STATUS_INVALID_ARGUMENT for a truncated or malformed record.
+ca_status_t plan_log_next(plan_log_reader_t *reader, plan_log_record_t *record);
+void plan_log_reader_close(plan_log_reader_t *reader);
+
+// 64-bit FNV-1a, the input hash stored in records.
+uint64_t plan_log_hash(const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CA_MUTATOR_PLAN_LOG_H_
@@ -2,18 +2,22 @@
 #define _GNU_SOURCE
 #endif
 
+#include <errno.h>
 #include <limits.h>
 #include <stdint.h>
 #include <sys/types.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <afl-fuzz.h>
 #include <alloc-inl.h>
+#include "afl_fuzz_count.h"
 #include "ca_engine.h"
 #include "mutation_plan.h"
+#include "plan_log.h"
 
 #ifndef CA_ENGINE_VARIANT
 #error CA_ENGINE_VARIANT must be defined as 1 (xor) or 2 (growing)
@@ -29,6 +33,25 @@
 #error Unknown CA_ENGINE_VARIANT
 #endif
 
+// AFL++ only prepares a splice partner for mutators without afl_custom_splice_optout.
+// The growing engine uses it only with a non-zero splice kind weight, so it opts out
+// unless built with CA_MUTATOR_SPLICE=1 (make SPLICE=1).
+#ifndef CA_MUTATOR_SPLICE
+#define CA_MUTATOR_SPLICE 0
+#endif
+
+// Trim steps proposed per queue entry; AFL++'s own trimmer may take thousands.
+#define AFL_TRIM_MAX_STEPS 512u
+
+// A block-aligned DELETE_RANGE candidate, in the coordinates of the untrimmed entry.
+typedef struct {
+    size_t start;
+    size_t len;
+    // Mean cell activity over the range.
+    uint32_t activity;
+    bool removed;
+} afl_trim_step_t;
+
 typedef struct {
     afl_state_t *afl;
     ca_engine_t *engine;
@@ -38,6 +61,66 @@ typedef struct {
 
     uint64_t mutation_id;
     char description[128];
+
+    // Multi-plan mode: one ca_engine_begin per queue entry, then ca_engine_next
+    // for every afl_custom_fuzz call on the same entry and buffer.
+    int multi_plan;
+    int session_open;
+    const void *session_entry;
+    const uint8_t *session_buf;
+    size_t session_len;
+    size_t session_max_size;
+
+    // Length-preserving mode: plans hold only length-preserving ops (no
+    // insert/delete), so output is a copy of `buf` patched in place.
+    int length_preserving;
+
+    // Set when the last non-empty output is known to differ from its input (plan
+    // outputs); buffer outputs leave it clear.
+    int last_changed;
+
+    // Segment output (ca_mutator_fuzz_segments): the normalized plan and segment
+    // list stay alive until the next call.
+    normalized_plan_t segments_plan;
+    mutation_segments_t segments;
+    mutation_segment_t buffer_segment;
+
+    // In-place output (ca_mutator_fuzz_in_place): a working copy of the current
+    // queue entry and buffer, reverted at the start of the next call.
+    mutation_gap_buffer_t gap;
+    int gap_loaded;
+    const void *gap_entry;
+    const uint8_t *gap_buf;
+    size_t gap_len;
+    mutation_segment_t gap_segments[2];
+
+    // Record mode (CA_MUTATOR_PLAN_LOG): every produced plan is appended here.
+    plan_log_writer_t *plan_log;
+
+    // Trimming: the entry as trimmed so far, the candidate deletions ordered largest
+    // and least active first, and the one being tried.
+    uint8_t *trim_buf;
+    size_t trim_len;
+    afl_trim_step_t *trim_steps;
+    size_t trim_step_count;
+    size_t trim_cur;
+    size_t trim_out_len;
+
+    // Fuzz count: yield per queue entry, indexed by AFL++'s current_entry, and the
+    // round in progress, which ends at the next afl_custom_fuzz_count call. The
+    // cost sums give the campaign means over every call so far.
+    uint32_t fuzz_count_base;
+    uint64_t cost_exec_us_sum;
+    uint64_t cost_exec_samples;
+    uint64_t cost_len_sum;
+    uint64_t cost_len_samples;
+    afl_yield_t *yield;
+    size_t yield_capacity;
+    afl_yield_t yield_total;
+    int round_open;
+    uint32_t round_entry;
+    uint32_t round_discovered;
+    uint64_t round_start_us;
 } afl_mutator_t;
 
 static uint32_t afl_rng_below(void *context, uint32_t limit) {
@@ -57,6 +140,178 @@ static void *afl_plan_buf_realloc(afl_mutator_t *mutator, size_t needed) {
     return next;
 }
 
+static int afl_env_enabled(const char *name) {
+    const char *value = getenv(name);
+    return value && value[0] != '\0' && strcmp(value, "0") != 0;
+}
+
+// Names a variable the adapter cannot use; afl_custom_init then fails.
+static void afl_env_reject(const char *name, const char *value, const char *expected) {
+    fprintf(stderr, "%s: invalid %s=\"%s\" (expected %s)\n", CA_ENGINE_NAME, name,
+            value, expected);
+}
+
+// Parses the decimal value of `name` in [min, max]. Unset or empty leaves `*value`
+// alone; anything else that does not parse is rejected with a diagnostic.
+static int afl_env_number(const char *name, unsigned long long *value,
+                          unsigned long long min, unsigned long long max,
+                          const char *expected) {
+    const char *text = getenv(name);
+    if (!text || text[0] == '\0') return 1;
+    char *end = NULL;
+    errno = 0;
+    unsigned long long parsed = strtoull(text, &end, 10);
+    if (text[0] == '-' || !end || *end != '\0' || errno != 0 || parsed < min ||
+        parsed > max) {
+        afl_env_reject(name, text, expected);
+        return 0;
+    }
+    *value = parsed;
+    return 1;
+}
+
+static int afl_env_size(const char *name, size_t *value) {
+    unsigned long long parsed = *value;
+    if (!afl_env_number(name, &parsed, 0, SIZE_MAX, "a byte or cell count")) return 0;
+    *value = (size_t)parsed;
+    return 1;
+}
+
+// Overrides `*value` with the decimal value of `name` in [min, max] when it is set.
+static int afl_env_u32(const char *name, uint32_t *value, uint32_t min, uint32_t max,
+                       const char *expected) {
+    unsigned long long parsed = *value;
+    if (!afl_env_number(name, &parsed, min, max, expected)) return 0;
+    *value = (uint32_t)parsed;
+    return 1;
+}
+
+// Parses exactly `count` comma-separated integers in [min, max] from `name`.
+static int afl_env_list(const char *name, long *out, size_t count, long min, long max) {
+    const char *cursor = getenv(name);
+    if (!cursor || cursor[0] == '\0') return 0;
+    for (size_t i = 0; i < count; ++i) {
+        char *end = NULL;
+        long value = strtol(cursor, &end, 10);
+        if (end == cursor || value < min || value > max) return 0;
+        out[i] = value;
+        if (i + 1u < count && *end != ',') return 0;
+        cursor = (i + 1u < count) ? end + 1 : end;
+    }
+    return *cursor == '\0';
+}
+
+// Reads growing engine tuning from the environment on top of the defaults.
+// CA_MUTATOR_WEIGHTS takes four comma-separated stencil weights ("7,3,2,1") and
+// CA_MUTATOR_KIND_WEIGHTS eight op kind weights (see CA_GROWING_KIND_COUNT). Returns
+// 0, after naming the variable on stderr, when any of them is set but unusable.
+static int afl_env_growing_params(ca_growing_params_t *params) {
+    ca_growing_params_init(params);
+    int ok = afl_env_u32("CA_MUTATOR_BLOCK_SIZE", &params->block_size, 1u, UINT32_MAX,
+                         "a block size of at least 1");
+    ok &= afl_env_u32("CA_MUTATOR_MAX_CELLS", &params->max_cells, 0u, UINT32_MAX,
+                      "a cell count, 0 for no limit");
+    ok &= afl_env_u32("CA_MUTATOR_MIN_STEPS", &params->min_steps, 0u, UINT32_MAX,
+                      "a step count");
+    ok &= afl_env_u32("CA_MUTATOR_MAX_STEPS", &params->max_steps, 0u, UINT32_MAX,
+                      "a step count");
+    ok &= afl_env_u32("CA_MUTATOR_UPDATE_PERCENT", &params->update_percent, 0u, 100u,
+                      "a percentage from 0 to 100");
+    ok &= afl_env_u32("CA_MUTATOR_MAX_OPS_DIVISOR", &params->max_ops_divisor, 1u,
+                      UINT32_MAX, "a divisor of at least 1");
+    ok &= afl_env_u32("CA_MUTATOR_MAX_OPS_CAP", &params->max_ops_cap, 1u, UINT32_MAX,
+                      "an op count of at least 1");
+    if (ok && params->min_steps > params->max_steps) {
+        fprintf(stderr, "%s: CA_MUTATOR_MIN_STEPS=%u exceeds CA_MUTATOR_MAX_STEPS=%u\n",
+                CA_ENGINE_NAME, params->min_steps, params->max_steps);
+        ok = 0;
+    }
+
+    // Indexed by ca_grow_position_mode_t.
+    static const char *const kPositionModes[] = {"cell", "activity", "entropy",
+                                                 "printable", "external"};
+    const char *mode = getenv("CA_MUTATOR_POSITION_MODE");
+    if (mode && mode[0] != '\0') {
+        size_t i = 0;
+        while (i < sizeof(kPositionModes) / sizeof(*kPositionModes) &&
+               strcmp(mode, kPositionModes[i]) != 0) {
+            ++i;
+        }
+        if (i == sizeof(kPositionModes) / sizeof(*kPositionModes)) {
+            afl_env_reject("CA_MUTATOR_POSITION_MODE", mode,
+                           "cell, activity, entropy, printable or external");
+            ok = 0;
+        } else {
+            params->position_mode = (uint32_t)i;
+        }
+    }
+
+    long parsed[CA_GROWING_KIND_COUNT];
+    const char *weights = getenv("CA_MUTATOR_WEIGHTS");
+    if (afl_env_list("CA_MUTATOR_WEIGHTS", parsed, 4, INT32_MIN, INT32_MAX)) {
+        for (size_t i = 0; i < 4; ++i) params->weights[i] = (int32_t)parsed[i];
+    } else if (weights && weights[0] != '\0') {
+        afl_env_reject("CA_MUTATOR_WEIGHTS", weights, "four comma-separated integers");
+        ok = 0;
+    }
+    // Shorter lists, from before integer ops and splices existed, leave those at 0.
+    const char *kinds = getenv("CA_MUTATOR_KIND_WEIGHTS");
+    size_t count = CA_GROWING_KIND_COUNT;
+    for (; count >= CA_GROWING_BASE_KIND_COUNT; --count) {
+        if (afl_env_list("CA_MUTATOR_KIND_WEIGHTS", parsed, count, 0, (long)INT32_MAX)) {
+            for (size_t i = 0; i < count; ++i) {
+                params->kind_weights[i] = (uint32_t)parsed[i];
+            }
+            break;
+        }
+    }
+    if (count < CA_GROWING_BASE_KIND_COUNT && kinds && kinds[0] != '\0') {
+        afl_env_reject("CA_MUTATOR_KIND_WEIGHTS", kinds,
+                       "six to eight comma-separated non-negative integers");
+        ok = 0;
+    }
+    return ok;
+}
+
+#if CA_ENGINE_VARIANT == 2
+// Loads CA_MUTATOR_POSITION_WEIGHTS, one weight byte per input byte, for the
+// external position mode, which needs it.
+static int afl_env_position_weights(ca_engine_t *engine, uint32_t position_mode) {
+    const char *path = getenv("CA_MUTATOR_POSITION_WEIGHTS");
+    if (!path || path[0] == '\0') {
+        if (position_mode != CA_GROW_POSITION_EXTERNAL) return 1;
+        fprintf(stderr,
+                "%s: CA_MUTATOR_POSITION_MODE=external needs CA_MUTATOR_POSITION_WEIGHTS\n",
+                CA_ENGINE_NAME);
+        return 0;
+    }
+    FILE *in = fopen(path, "rb");
+    uint32_t *weights = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    int c = 0;
+    int ok = in != NULL;
+    while (ok && (c = fgetc(in)) != EOF) {
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2u : 4096u;
+            uint32_t *next = (uint32_t *)realloc(weights, capacity * sizeof(*weights));
+            if (!next) {
+                ok = 0;
+                break;
+            }
+            weights = next;
+        }
+        weights[count++] = (uint32_t)c;
+    }
+    ok = ok && !ferror(in) &&
+         ca_growing_set_position_weights(engine, weights, count) == CA_STATUS_OK;
+    if (in) fclose(in);
+    free(weights);
+    if (!ok) afl_env_reject("CA_MUTATOR_POSITION_WEIGHTS", path, "a readable file");
+    return ok;
+}
+#endif
+
 void *afl_custom_init(afl_state_t *afl, unsigned int seed) {
     (void)seed;
 
@@ -79,7 +334,36 @@ void *afl_custom_init(afl_state_t *afl, unsigned int seed) {
 
     ca_engine_config_t config = {
         .user_context = NULL,
+        .flags = 0,
     };
+    if (afl_env_enabled("CA_MUTATOR_LINEAGE")) {
+        config.flags |= CA_ENGINE_FLAG_LINEAGE;
+    }
+    if (afl_env_enabled("CA_MUTATOR_ACTIVE_SET")) {
+        config.flags |= CA_ENGINE_FLAG_ACTIVE_SET;
+    }
+    if (afl_env_enabled("CA_MUTATOR_PYRAMID")) {
+        config.flags |= CA_ENGINE_FLAG_PYRAMID;
+    }
+    if (afl_env_enabled("CA_MUTATOR_LENGTH_PRESERVING")) {
+        config.flags |= CA_ENGINE_FLAG_LENGTH_PRESERVING;
+        mutator->length_preserving = 1;
+    }
+    mutator->multi_plan = afl_env_enabled("CA_MUTATOR_MULTI_PLAN");
+    mutator->fuzz_count_base = AFL_FUZZ_COUNT_BASE;
+    ca_growing_params_t growing_params;
+    int env_ok = afl_env_size("CA_MUTATOR_WINDOW_MIN_INPUT", &config.window_min_input);
+    env_ok &= afl_env_size("CA_MUTATOR_WINDOW_CELLS", &config.window_cells);
+    env_ok &= afl_env_u32("CA_MUTATOR_THREADS", &config.worker_threads, 0u, UINT32_MAX,
+                          "a thread count");
+    env_ok &= afl_env_u32("CA_MUTATOR_FUZZ_COUNT", &mutator->fuzz_count_base, 0u,
+                          UINT32_MAX, "a fuzz count, 0 to turn adaptation off");
+    env_ok &= afl_env_growing_params(&growing_params);
+    if (!env_ok) {
+        free(mutator);
+        return NULL;
+    }
+    config.growing_params = &growing_params;
     ca_rng_t rng = {
         .below = afl_rng_below,
         .context = afl,
@@ -93,6 +377,23 @@ void *afl_custom_init(afl_state_t *afl, unsigned int seed) {
 #endif
 
     if (status != CA_STATUS_OK || !mutator->engine) {
+        fprintf(stderr, "%s: engine creation failed (status %d)\n", CA_ENGINE_NAME,
+                (int)status);
+        free(mutator);
+        return NULL;
+    }
+#if CA_ENGINE_VARIANT == 2
+    if (!afl_env_position_weights(mutator->engine, growing_params.position_mode)) {
+        ca_engine_destroy(mutator->engine);
+        free(mutator);
+        return NULL;
+    }
+#endif
+
+    const char *plan_log_path = getenv("CA_MUTATOR_PLAN_LOG");
+    if (plan_log_path && plan_log_path[0] != '\0' &&
+        plan_log_writer_open(plan_log_path, &mutator->plan_log) != CA_STATUS_OK) {
+        ca_engine_destroy(mutator->engine);
         free(mutator);
         return NULL;
     }
@@ -100,26 +401,122 @@ void *afl_custom_init(afl_state_t *afl, unsigned int seed) {
     return mutator;
 }
 
+static bool afl_plan_splices(const normalized_plan_t *plan) {
+    for (size_t i = 0; i < plan->op_count; ++i) {
+        if (plan->ops[i].kind == CA_OP_INSERT_FROM_ADD ||
+            plan->ops[i].kind == CA_OP_OVERWRITE_FROM_ADD) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Appends a produced mutation to the plan log, if one is open. A failed write closes
+// the log instead of failing the campaign. Splices read AFL++'s add_buf, which the
+// log does not keep, so plans with splices are logged with their bytes inlined.
+static void afl_plan_log_append(afl_mutator_t *mutator, const ca_mutate_request_t *request,
+                                const normalized_plan_t *plan) {
+    if (!mutator->plan_log) return;
+    normalized_plan_t detached = {0};
+    ca_status_t status = CA_STATUS_OK;
+    if (afl_plan_splices(plan)) {
+        const normalized_plan_t empty = {0};
+        status = mutation_plan_compose(&empty, plan, request->input, request->input_len,
+                                       &detached);
+        plan = &detached;
+    }
+    if (status == CA_STATUS_OK) {
+        status = plan_log_append(mutator->plan_log, request->mutation_id,
+                                 plan_log_hash(request->input, request->input_len),
+                                 request->input_len, plan);
+    }
+    normalized_plan_free(&detached);
+    if (status != CA_STATUS_OK) {
+        plan_log_writer_close(mutator->plan_log);
+        mutator->plan_log = NULL;
+    }
+}
+
+// Buffer outputs (XOR) are logged as a plan diffed against the input.
+static void afl_plan_log_buffer(afl_mutator_t *mutator, const ca_mutate_request_t *request,
+                                const uint8_t *data, size_t len) {
+    if (!mutator->plan_log) return;
+    normalized_plan_t plan = {0};
+    if (mutation_plan_diff(request->input, request->input_len, data, len, NULL, &plan) ==
+        CA_STATUS_OK) {
+        afl_plan_log_append(mutator, request, &plan);
+    }
+    normalized_plan_free(&plan);
+}
+
+// Multi-plan mode: one ca_engine_begin per queue entry and buffer, then
+// ca_engine_next for every call on it.
+static ca_status_t afl_session_next(afl_mutator_t *mutator,
+                                    const ca_mutate_request_t *request,
+                                    ca_output_t *output) {
+    const uint8_t *buf = request->input;
+    size_t buf_size = request->input_len;
+    size_t max_size = request->max_output_len;
+    ca_status_t status;
+    // AFL++ restores the buffer between calls of one custom-mutator stage, so
+    // the queue entry plus buffer identity is enough to keep the session. Without
+    // a queue entry (standalone runs) every call starts a new session.
+    const void *entry = mutator->afl ? (const void *)mutator->afl->queue_cur : NULL;
+    if (!mutator->session_open || !entry || entry != mutator->session_entry ||
+        buf != mutator->session_buf || buf_size != mutator->session_len ||
+        max_size != mutator->session_max_size) {
+        status = ca_engine_begin(mutator->engine, request);
+        mutator->session_open = (status == CA_STATUS_OK && entry != NULL);
+        mutator->session_entry = entry;
+        mutator->session_buf = buf;
+        mutator->session_len = buf_size;
+        mutator->session_max_size = max_size;
+    } else {
+        status = CA_STATUS_OK;
+    }
+    if (status == CA_STATUS_OK) {
+        status = ca_engine_next(mutator->engine, output);
+    }
+    return status;
+}
+
 size_t afl_custom_fuzz(void *data, uint8_t *buf, size_t buf_size, uint8_t **out_buf,
                       uint8_t *add_buf, size_t add_buf_size, size_t max_size) {
-    (void)add_buf;
-    (void)add_buf_size;
-
     afl_mutator_t *mutator = (afl_mutator_t *)data;
     if (!mutator || !buf || !out_buf) return 0;
     *out_buf = NULL;
+    mutator->last_changed = 0;
 
+    // The splice partner changes on every call, so multi-plan sessions, which keep
+    // one begin per queue entry, do not splice.
+    const bool splice = add_buf && add_buf_size > 0 && !mutator->multi_plan;
     ca_mutate_request_t request = {
         .input = buf,
         .input_len = buf_size,
-        .add_buf = NULL,
-        .add_buf_len = 0,
+        .add_buf = splice ? add_buf : NULL,
+        .add_buf_len = splice ? add_buf_size : 0,
         .max_output_len = max_size,
         .mutation_id = mutator->mutation_id++,
     };
 
+    ca_status_t status;
+    if (!mutator->multi_plan && !mutator->plan_log) {
+        // Single-shot calls write the final bytes straight into the adapter buffer.
+        // Record mode needs the normalized plan, so it takes the path below.
+        size_t written = 0;
+        if (max_size == 0 || !afl_plan_buf_realloc(mutator, max_size)) return 0;
+        status = ca_engine_mutate_into(mutator->engine, &request, mutator->plan_out_buf,
+                                       max_size, &written);
+        if (status != CA_STATUS_OK || written == 0) return 0;
+        // Plan outputs only come back when they differ from the input.
+        mutator->last_changed = CA_ENGINE_VARIANT == 2;
+        *out_buf = mutator->plan_out_buf;
+        return written;
+    }
+
     ca_output_t output = {0};
-    ca_status_t status = ca_engine_mutate(mutator->engine, &request, &output);
+    status = mutator->multi_plan ? afl_session_next(mutator, &request, &output)
+                                 : ca_engine_mutate(mutator->engine, &request, &output);
     if (status == CA_STATUS_SKIP || status == CA_STATUS_OUTPUT_TOO_LARGE) {
         *out_buf = NULL;
         return 0;
@@ -133,6 +530,8 @@ size_t afl_custom_fuzz(void *data, uint8_t *buf, size_t buf_size, uint8_t **out_
         if (!output.value.buffer.data) return 0;
         if (max_size != 0 && output.value.buffer.len > max_size) return 0;
         if (output.value.buffer.len == 0) return 0;
+        afl_plan_log_buffer(mutator, &request, output.value.buffer.data,
+                            output.value.buffer.len);
         *out_buf = (uint8_t *)output.value.buffer.data;
         return output.value.buffer.len;
     }
@@ -147,6 +546,8 @@ size_t afl_custom_fuzz(void *data, uint8_t *buf, size_t buf_size, uint8_t **out_
         .max_output_len = max_size,
         .input_len = buf_size,
         .input = buf,
+        .add_buf = request.add_buf,
+        .add_buf_len = request.add_buf_len,
     };
 
     normalized_plan_t normalized = {0};
@@ -168,6 +569,29 @@ size_t afl_custom_fuzz(void *data, uint8_t *buf, size_t buf_size, uint8_t **out_
         return 0;
     }
 
+    if (mutator->length_preserving) {
+        if (buf_size == 0 || buf_size > max_size ||
+            !afl_plan_buf_realloc(mutator, buf_size)) {
+            normalized_plan_free(&normalized);
+            *out_buf = NULL;
+            return 0;
+        }
+        memcpy(mutator->plan_out_buf, buf, buf_size);
+        bool changed = false;
+        status = mutation_plan_patch(&normalized, mutator->plan_out_buf, buf_size,
+                                    &changed);
+        if (status != CA_STATUS_OK || !changed) {
+            normalized_plan_free(&normalized);
+            *out_buf = NULL;
+            return 0;
+        }
+        afl_plan_log_append(mutator, &request, &normalized);
+        normalized_plan_free(&normalized);
+        mutator->last_changed = 1;
+        *out_buf = mutator->plan_out_buf;
+        return buf_size;
+    }
+
     size_t out_size = 0;
     status = mutation_plan_measure(&normalized, buf_size, &out_size);
     if (status == CA_STATUS_SKIP || status == CA_STATUS_OUTPUT_TOO_LARGE) {
@@ -199,24 +623,403 @@ size_t afl_custom_fuzz(void *data, uint8_t *buf, size_t buf_size, uint8_t **out_
     }
 
     size_t written = 0;
+    bool changed = false;
     status = mutation_plan_apply(&normalized, buf, buf_size, mutator->plan_out_buf,
-                                mutator->plan_out_capacity, &written);
-    normalized_plan_free(&normalized);
+                                mutator->plan_out_capacity, &written, &changed);
     if (status != CA_STATUS_OK || written != out_size || written > max_size) {
+        normalized_plan_free(&normalized);
         *out_buf = NULL;
         return 0;
     }
 
-    if (written == buf_size &&
-        (written == 0 || memcmp(mutator->plan_out_buf, buf, written) == 0)) {
+    if (!changed) {
+        normalized_plan_free(&normalized);
         *out_buf = NULL;
         return 0;
     }
+    afl_plan_log_append(mutator, &request, &normalized);
+    normalized_plan_free(&normalized);
+
+    mutator->last_changed = 1;
+    *out_buf = mutator->plan_out_buf;
+    return written;
+}
+
+// Not an AFL++ callback: like afl_custom_fuzz, but returns the mutation as a list of
+// segments that reference `buf`, the plan's inserted bytes and patched bytes, so a
+// host can hash or write it without materializing a copy. Returns the total length
+// (0 = skip); the segments stay valid until the next call.
+size_t ca_mutator_fuzz_segments(void *data, uint8_t *buf, size_t buf_size,
+                                const mutation_segment_t **segments,
+                                size_t *segment_count, size_t max_size) {
+    afl_mutator_t *mutator = (afl_mutator_t *)data;
+    if (!mutator || !buf || !segments || !segment_count) return 0;
+    *segments = NULL;
+    *segment_count = 0;
+    mutator->last_changed = 0;
+    normalized_plan_free(&mutator->segments_plan);
+
+    ca_mutate_request_t request = {
+        .input = buf,
+        .input_len = buf_size,
+        .max_output_len = max_size,
+        .mutation_id = mutator->mutation_id++,
+    };
+    ca_output_t output = {0};
+    ca_status_t status = mutator->multi_plan
+                             ? afl_session_next(mutator, &request, &output)
+                             : ca_engine_mutate(mutator->engine, &request, &output);
+    if (status != CA_STATUS_OK) return 0;
+
+    if (output.kind == CA_OUTPUT_BUFFER) {
+        if (!output.value.buffer.data || output.value.buffer.len == 0) return 0;
+        if (max_size != 0 && output.value.buffer.len > max_size) return 0;
+        afl_plan_log_buffer(mutator, &request, output.value.buffer.data,
+                            output.value.buffer.len);
+        mutator->buffer_segment = (mutation_segment_t){
+            .data = output.value.buffer.data,
+            .len = output.value.buffer.len,
+        };
+        *segments = &mutator->buffer_segment;
+        *segment_count = 1;
+        return output.value.buffer.len;
+    }
+    if (output.kind != CA_OUTPUT_PLAN || !output.value.plan) return 0;
+
+    ca_plan_limits_t limits = {
+        .max_ops = 0,
+        .max_output_len = max_size,
+        .input_len = buf_size,
+        .input = buf,
+    };
+    status = mutation_plan_normalize(output.value.plan, &limits, &mutator->segments_plan);
+    if (status != CA_STATUS_OK || mutator->segments_plan.op_count == 0) return 0;
+
+    bool changed = false;
+    status = mutation_plan_segments(&mutator->segments_plan, buf, buf_size,
+                                    &mutator->segments, &changed);
+    if (status != CA_STATUS_OK || !changed || mutator->segments.total_len == 0 ||
+        mutator->segments.total_len > max_size) {
+        return 0;
+    }
+
+    afl_plan_log_append(mutator, &request, &mutator->segments_plan);
+    mutator->last_changed = 1;
+    *segments = mutator->segments.segments;
+    *segment_count = mutator->segments.count;
+    return mutator->segments.total_len;
+}
+
+// Not an AFL++ callback: like ca_mutator_fuzz_segments, but applies the plan to a
+// working copy of `buf` that is kept across calls on the same queue entry and buffer
+// and reverted at the start of the next call, so a call costs about as much as its
+// edit rather than a copy of `buf`. Returns at most two segments; like a session,
+// every call outside a queue entry reloads the copy.
+size_t ca_mutator_fuzz_in_place(void *data, uint8_t *buf, size_t buf_size,
+                                const mutation_segment_t **segments,
+                                size_t *segment_count, size_t max_size) {
+    afl_mutator_t *mutator = (afl_mutator_t *)data;
+    if (!mutator || !buf || !segments || !segment_count) return 0;
+    *segments = NULL;
+    *segment_count = 0;
+    mutator->last_changed = 0;
+    normalized_plan_free(&mutator->segments_plan);
+
+    mutation_gap_buffer_revert(&mutator->gap);
+    const void *entry = mutator->afl ? (const void *)mutator->afl->queue_cur : NULL;
+    if (!mutator->gap_loaded || !entry || entry != mutator->gap_entry ||
+        buf != mutator->gap_buf || buf_size != mutator->gap_len) {
+        mutator->gap_loaded =
+            mutation_gap_buffer_load(&mutator->gap, buf, buf_size) == CA_STATUS_OK;
+        mutator->gap_entry = entry;
+        mutator->gap_buf = buf;
+        mutator->gap_len = buf_size;
+        if (!mutator->gap_loaded) return 0;
+    }
 
+    ca_mutate_request_t request = {
+        .input = buf,
+        .input_len = buf_size,
+        .max_output_len = max_size,
+        .mutation_id = mutator->mutation_id++,
+    };
+    ca_output_t output = {0};
+    ca_status_t status = mutator->multi_plan
+                             ? afl_session_next(mutator, &request, &output)
+                             : ca_engine_mutate(mutator->engine, &request, &output);
+    if (status != CA_STATUS_OK) return 0;
+
+    if (output.kind == CA_OUTPUT_BUFFER) {
+        if (!output.value.buffer.data || output.value.buffer.len == 0) return 0;
+        if (max_size != 0 && output.value.buffer.len > max_size) return 0;
+        afl_plan_log_buffer(mutator, &request, output.value.buffer.data,
+                            output.value.buffer.len);
+        mutator->buffer_segment = (mutation_segment_t){
+            .data = output.value.buffer.data,
+            .len = output.value.buffer.len,
+        };
+        *segments = &mutator->buffer_segment;
+        *segment_count = 1;
+        return output.value.buffer.len;
+    }
+    if (output.kind != CA_OUTPUT_PLAN || !output.value.plan) return 0;
+
+    ca_plan_limits_t limits = {
+        .max_ops = 0,
+        .max_output_len = max_size,
+        .input_len = buf_size,
+        .input = buf,
+    };
+    status = mutation_plan_normalize(output.value.plan, &limits, &mutator->segments_plan);
+    if (status != CA_STATUS_OK || mutator->segments_plan.op_count == 0) return 0;
+
+    bool changed = false;
+    status = mutation_plan_apply_gap(&mutator->segments_plan, &mutator->gap, &changed);
+    if (status != CA_STATUS_OK || !changed || mutator->gap.len == 0 ||
+        mutator->gap.len > max_size) {
+        return 0;
+    }
+
+    afl_plan_log_append(mutator, &request, &mutator->segments_plan);
+    mutator->last_changed = 1;
+    *segments = mutator->gap_segments;
+    *segment_count = mutation_gap_buffer_view(&mutator->gap, mutator->gap_segments);
+    return mutator->gap.len;
+}
+
+static uint64_t afl_now_us(void) {
+    struct timespec now;
+    if (clock_gettime(CLOCK_MONOTONIC, &now) != 0) return 0;
+    return (uint64_t)now.tv_sec * 1000000u + (uint64_t)now.tv_nsec / 1000u;
+}
+
+// Charges the queue growth and wall time since the previous call to the entry that
+// was fuzzed in between.
+static void afl_yield_close_round(afl_mutator_t *mutator, uint64_t now_us) {
+    afl_state_t *afl = mutator->afl;
+    if (!mutator->round_open) return;
+    mutator->round_open = 0;
+    if (mutator->round_entry >= mutator->yield_capacity) {
+        size_t capacity = mutator->yield_capacity ? mutator->yield_capacity : 64u;
+        while (capacity <= mutator->round_entry) capacity *= 2u;
+        afl_yield_t *next =
+            (afl_yield_t *)realloc(mutator->yield, capacity * sizeof(*next));
+        if (!next) return;
+        memset(next + mutator->yield_capacity, 0,
+               (capacity - mutator->yield_capacity) * sizeof(*next));
+        mutator->yield = next;
+        mutator->yield_capacity = capacity;
+    }
+    afl_yield_t round = {
+        .found = afl->queued_discovered - mutator->round_discovered,
+        .elapsed_us = now_us > mutator->round_start_us ? now_us - mutator->round_start_us
+                                                       : 0u,
+    };
+    afl_yield_t *entry = &mutator->yield[mutator->round_entry];
+    entry->found += round.found;
+    entry->elapsed_us += round.elapsed_us;
+    mutator->yield_total.found += round.found;
+    mutator->yield_total.elapsed_us += round.elapsed_us;
+}
+
+// Adds the current entry's calibrated execution time and length to the campaign
+// sums and returns its cost against the means, this entry included.
+static afl_cost_t afl_cost_sample(afl_mutator_t *mutator, size_t buf_size) {
+    const struct queue_entry *queue = mutator->afl->queue_cur;
+    afl_cost_t cost = {.len = buf_size};
+    if (queue && queue->exec_us != 0) {
+        cost.exec_us = queue->exec_us;
+        mutator->cost_exec_us_sum += queue->exec_us;
+        ++mutator->cost_exec_samples;
+    }
+    if (buf_size != 0) {
+        mutator->cost_len_sum += buf_size;
+        ++mutator->cost_len_samples;
+    }
+    if (mutator->cost_exec_samples != 0) {
+        cost.mean_exec_us = mutator->cost_exec_us_sum / mutator->cost_exec_samples;
+    }
+    if (mutator->cost_len_samples != 0) {
+        cost.mean_len = (size_t)(mutator->cost_len_sum / mutator->cost_len_samples);
+    }
+    return cost;
+}
+
+// Number of afl_custom_fuzz calls AFL++ makes for the current entry, from
+// afl_fuzz_count_compute: the base scaled by the entry's cost against the campaign
+// mean and by its observed yield. Each call also closes the previous round.
+// CA_MUTATOR_FUZZ_COUNT overrides the base; 0 turns yield adaptation off and every
+// entry gets AFL_FUZZ_COUNT_BASE scaled by its cost alone.
+uint32_t afl_custom_fuzz_count(void *data, const uint8_t *buf, size_t buf_size) {
+    (void)buf;
+    afl_mutator_t *mutator = (afl_mutator_t *)data;
+    if (!mutator || !mutator->afl) return AFL_FUZZ_COUNT_BASE;
+
+    const afl_cost_t cost = afl_cost_sample(mutator, buf_size);
+    if (mutator->fuzz_count_base == 0) {
+        return afl_fuzz_count_compute(AFL_FUZZ_COUNT_BASE, &cost, NULL, NULL);
+    }
+
+    const uint64_t now_us = afl_now_us();
+    afl_yield_close_round(mutator, now_us);
+    const uint32_t entry = mutator->afl->current_entry;
+    mutator->round_open = 1;
+    mutator->round_entry = entry;
+    mutator->round_discovered = mutator->afl->queued_discovered;
+    mutator->round_start_us = now_us;
+
+    const afl_yield_t none = {0};
+    const afl_yield_t *yield =
+        entry < mutator->yield_capacity ? &mutator->yield[entry] : &none;
+    return afl_fuzz_count_compute(mutator->fuzz_count_base, &cost, yield,
+                                  &mutator->yield_total);
+}
+
+// Not an AFL++ callback: lets the standalone harness account no-ops from the
+// adapter's own change tracking instead of comparing whole buffers.
+int ca_mutator_last_changed(void *data) {
+    afl_mutator_t *mutator = (afl_mutator_t *)data;
+    return mutator ? mutator->last_changed : 0;
+}
+
+#if CA_ENGINE_VARIANT == 2
+static int afl_trim_step_order(const void *left, const void *right) {
+    const afl_trim_step_t *a = (const afl_trim_step_t *)left;
+    const afl_trim_step_t *b = (const afl_trim_step_t *)right;
+    if (a->len != b->len) return a->len > b->len ? -1 : 1;
+    if (a->activity != b->activity) return a->activity < b->activity ? -1 : 1;
+    return (a->start > b->start) - (a->start < b->start);
+}
+
+// Returns the first step from `index` on that is still worth trying. Steps are
+// aligned runs of 2^k cells, so a step is either inside a removed one or disjoint
+// from it; a step that would remove all that is left is skipped too.
+static size_t afl_trim_next(const afl_mutator_t *mutator, size_t index) {
+    for (; index < mutator->trim_step_count; ++index) {
+        const afl_trim_step_t *step = &mutator->trim_steps[index];
+        bool covered = step->len >= mutator->trim_len;
+        for (size_t i = 0; i < mutator->trim_step_count && !covered; ++i) {
+            const afl_trim_step_t *done = &mutator->trim_steps[i];
+            covered = done->removed && step->start >= done->start &&
+                      step->start < done->start + done->len;
+        }
+        if (!covered) break;
+    }
+    return index;
+}
+
+// Proposes trims from the growing engine's cell activity: DELETE_RANGE plans over
+// aligned runs of 2^k cells, largest runs first and, within a size, least active
+// first. Returns the number of steps; 0 leaves the entry untrimmed.
+int32_t afl_custom_init_trim(void *data, uint8_t *buf, size_t buf_size) {
+    afl_mutator_t *mutator = (afl_mutator_t *)data;
+    if (!mutator || !buf) return 0;
+    mutator->trim_step_count = 0;
+    mutator->trim_cur = 0;
+    // The engine's grid is rebuilt for the entry, so a multi-plan session restarts.
+    mutator->session_open = 0;
+
+    const uint8_t *activity = NULL;
+    size_t cells = 0;
+    size_t block = 0;
+    if (ca_growing_cell_activity(mutator->engine, buf, buf_size, &activity, &cells,
+                                 &block) != CA_STATUS_OK ||
+        cells < 2) {
+        return 0;
+    }
+
+    uint8_t *copy = (uint8_t *)realloc(mutator->trim_buf, buf_size);
+    if (!copy) return 0;
+    mutator->trim_buf = copy;
+    memcpy(copy, buf, buf_size);
+    mutator->trim_len = buf_size;
+
+    // Runs of 1, 2, 4, ... cells, up to the largest that leaves some of the entry.
+    size_t top = 1;
+    while (top * 2u < cells) top <<= 1;
+    size_t count = 0;
+    for (size_t run = top; run > 0; run >>= 1) count += (cells + run - 1u) / run;
+    afl_trim_step_t *steps =
+        (afl_trim_step_t *)realloc(mutator->trim_steps, count * sizeof(*steps));
+    if (!steps) return 0;
+    mutator->trim_steps = steps;
+    count = 0;
+    // A run cut short by the end of the entry repeats the larger run's last step
+    // when both start at the same cell; it is only proposed once.
+    size_t tail = SIZE_MAX;
+    for (size_t run = top; run > 0; run >>= 1) {
+        for (size_t first = 0; first < cells; first += run) {
+            size_t last = first + run < cells ? first + run : cells;
+            if (last == cells) {
+                if (first == tail) continue;
+                tail = first;
+            }
+            uint32_t sum = 0;
+            for (size_t i = first; i < last; ++i) sum += activity[i];
+            size_t end = last * block < buf_size ? last * block : buf_size;
+            steps[count++] = (afl_trim_step_t){
+                .start = first * block,
+                .len = end - first * block,
+                .activity = sum / (uint32_t)(last - first),
+            };
+        }
+    }
+    qsort(steps, count, sizeof(*steps), afl_trim_step_order);
+    mutator->trim_step_count = count < AFL_TRIM_MAX_STEPS ? count : AFL_TRIM_MAX_STEPS;
+    mutator->trim_cur = afl_trim_next(mutator, 0);
+    return (int32_t)mutator->trim_step_count;
+}
+
+// Applies the current step's DELETE_RANGE to the entry as trimmed so far.
+size_t afl_custom_trim(void *data, uint8_t **out_buf) {
+    afl_mutator_t *mutator = (afl_mutator_t *)data;
+    if (!mutator || !out_buf) return 0;
+    // AFL++ treats a NULL buffer as fatal, so a failed step offers the entry as is.
+    *out_buf = mutator->trim_buf;
+    mutator->trim_out_len = 0;
+    if (mutator->trim_cur >= mutator->trim_step_count) return mutator->trim_len;
+
+    const afl_trim_step_t *step = &mutator->trim_steps[mutator->trim_cur];
+    size_t shift = 0;
+    for (size_t i = 0; i < mutator->trim_step_count; ++i) {
+        const afl_trim_step_t *done = &mutator->trim_steps[i];
+        if (done->removed && done->start < step->start) shift += done->len;
+    }
+    mutation_op_t op = {
+        .pos = (uint32_t)(step->start - shift),
+        .len = (uint32_t)step->len,
+        .kind = CA_OP_DELETE_RANGE,
+    };
+    const normalized_plan_t plan = {.ops = &op, .op_count = 1};
+    size_t written = 0;
+    if (!afl_plan_buf_realloc(mutator, mutator->trim_len) ||
+        mutation_plan_apply(&plan, mutator->trim_buf, mutator->trim_len,
+                            mutator->plan_out_buf, mutator->plan_out_capacity, &written,
+                            NULL) != CA_STATUS_OK) {
+        return mutator->trim_len;
+    }
+    mutator->trim_out_len = written;
     *out_buf = mutator->plan_out_buf;
     return written;
 }
 
+// Keeps an accepted trim and moves to the next step still worth trying.
+int32_t afl_custom_post_trim(void *data, unsigned char success) {
+    afl_mutator_t *mutator = (afl_mutator_t *)data;
+    if (!mutator) return 0;
+    if (mutator->trim_cur >= mutator->trim_step_count) {
+        return (int32_t)mutator->trim_step_count;
+    }
+    if (success && mutator->trim_out_len != 0) {
+        memcpy(mutator->trim_buf, mutator->plan_out_buf, mutator->trim_out_len);
+        mutator->trim_len = mutator->trim_out_len;
+        mutator->trim_steps[mutator->trim_cur].removed = true;
+    }
+    mutator->trim_cur = afl_trim_next(mutator, mutator->trim_cur + 1u);
+    return (int32_t)mutator->trim_cur;
+}
+#endif
+
 const char *afl_custom_describe(void *data, size_t max_description_len) {
     afl_mutator_t *mutator = (afl_mutator_t *)data;
     if (!mutator || max_description_len == 0) {
@@ -230,15 +1033,24 @@ const char *afl_custom_describe(void *data, size_t max_description_len) {
     return mutator->description;
 }
 
+#if CA_ENGINE_VARIANT == 1 || !CA_MUTATOR_SPLICE
 void afl_custom_splice_optout(void *data) {
     (void)data;
 }
+#endif
 
 void afl_custom_deinit(void *data) {
     afl_mutator_t *mutator = (afl_mutator_t *)data;
     if (!mutator) return;
 
     ca_engine_destroy(mutator->engine);
+    plan_log_writer_close(mutator->plan_log);
+    normalized_plan_free(&mutator->segments_plan);
+    mutation_segments_free(&mutator->segments);
+    mutation_gap_buffer_free(&mutator->gap);
+    free(mutator->trim_buf);
+    free(mutator->trim_steps);
+    free(mutator->yield);
     if (mutator->plan_out_buf) {
         afl_free(mutator->plan_out_buf);
     }
@@ -0,0 +1,30 @@
+#include "afl_fuzz_count.h"
+
+static double afl_fuzz_count_cost_factor(const afl_cost_t *cost) {
+    if (!cost) return 1.0;
+    double factor = 1.0;
+    if (cost->exec_us != 0 && cost->mean_exec_us != 0) {
+        factor = (double)cost->mean_exec_us / (double)cost->exec_us;
+    } else if (cost->len != 0 && cost->mean_len != 0) {
+        factor = (double)cost->mean_len / (double)cost->len;
+    }
+    const double span = (double)AFL_FUZZ_COUNT_COST_SPAN;
+    if (factor > span) factor = span;
+    if (factor < 1.0 / span) factor = 1.0 / span;
+    return factor;
+}
+
+uint32_t afl_fuzz_count_compute(uint32_t base, const afl_cost_t *cost,
+                                const afl_yield_t *entry, const afl_yield_t *total) {
+    double count = (double)base * afl_fuzz_count_cost_factor(cost);
+    if (entry && total) {
+        const double prior = (double)AFL_FUZZ_COUNT_PRIOR_US;
+        const double us_per_find =
+            ((double)total->elapsed_us + prior) / ((double)total->found + 1.0);
+        count *= ((double)entry->found * us_per_find + prior) /
+                 ((double)entry->elapsed_us + prior);
+    }
+    if (count < AFL_FUZZ_COUNT_MIN) count = AFL_FUZZ_COUNT_MIN;
+    if (count > AFL_FUZZ_COUNT_MAX) count = AFL_FUZZ_COUNT_MAX;
+    return (uint32_t)count;
+}
@@ -0,0 +1,51 @@
+#ifndef CA_MUTATOR_AFL_FUZZ_COUNT_H_
+#define CA_MUTATOR_AFL_FUZZ_COUNT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fuzz count for an average entry; AFL++'s HAVOC_CYCLES.
+#define AFL_FUZZ_COUNT_BASE 256u
+#define AFL_FUZZ_COUNT_MIN 16u
+#define AFL_FUZZ_COUNT_MAX 4096u
+// Weight of the campaign-wide yield in an entry's estimate, in microseconds of the
+// entry's own fuzzing; entries that have cost less than this stay near the base.
+#define AFL_FUZZ_COUNT_PRIOR_US 1000000u
+// Bounds of the cost factor: an entry at most this many times cheaper or dearer
+// than the mean gets at most this many times more or fewer rounds.
+#define AFL_FUZZ_COUNT_COST_SPAN 4u
+
+// What fuzzing one queue entry has produced so far. `elapsed_us` is wall time,
+// which stands in for CPU time: most of it is the target's executions, which the
+// adapter cannot measure directly.
+typedef struct {
+    uint64_t found;
+    uint64_t elapsed_us;
+} afl_yield_t;
+
+// One entry's cost against the campaign mean. Execution time is used when both
+// sides know it, input length otherwise; missing data counts as average.
+typedef struct {
+    uint64_t exec_us;
+    uint64_t mean_exec_us;
+    size_t len;
+    size_t mean_len;
+} afl_cost_t;
+
+// `base` scaled by the entry's cost factor (mean over its own cost, within
+// AFL_FUZZ_COUNT_COST_SPAN either way) and, when `entry` and `total` are given, by
+// its finds per microsecond over the campaign's, estimated with
+// AFL_FUZZ_COUNT_PRIOR_US of campaign-average fuzzing mixed in. The result is
+// clamped to AFL_FUZZ_COUNT_MIN..AFL_FUZZ_COUNT_MAX.
+uint32_t afl_fuzz_count_compute(uint32_t base, const afl_cost_t *cost,
+                                const afl_yield_t *entry, const afl_yield_t *total);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CA_MUTATOR_AFL_FUZZ_COUNT_H_
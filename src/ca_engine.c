@@ -1,6 +1,8 @@
 #include <stdlib.h>
+#include <string.h>
 
 #include "ca_engine_internal.h"
+#include "mutation_plan.h"
 
 #ifndef CA_ENGINE_VARIANT
 #define CA_ENGINE_VARIANT 0
@@ -30,6 +32,22 @@ ca_status_t ca_engine_create_growing(const ca_engine_config_t *config, ca_rng_t
 }
 #endif
 
+void ca_growing_params_init(ca_growing_params_t *params) {
+    if (!params) return;
+    *params = (ca_growing_params_t){
+        .version = CA_GROWING_PARAMS_VERSION,
+        .block_size = 16u,
+        .max_cells = 0u,
+        .min_steps = 1u,
+        .max_steps = 5u,
+        .update_percent = 60u,
+        .weights = {7, 3, 2, 1},
+        .max_ops_divisor = 64u,
+        .max_ops_cap = 8u,
+        .position_mode = CA_GROW_POSITION_CELL,
+    };
+}
+
 ca_status_t ca_engine_mutate(ca_engine_t *engine,
                             const ca_mutate_request_t *request,
                             ca_output_t *output) {
@@ -37,6 +55,102 @@ ca_status_t ca_engine_mutate(ca_engine_t *engine,
     return engine->mutate(engine->impl, request, output);
 }
 
+static bool ca_plan_preserves_length(const normalized_plan_t *plan) {
+    for (size_t i = 0; i < plan->op_count; ++i) {
+        mutation_op_kind_t kind = plan->ops[i].kind;
+        if (kind != CA_OP_BIT_FLIP && kind != CA_OP_SET_BYTE && kind != CA_OP_ADD_BYTE &&
+            kind != CA_OP_SUB_BYTE && kind != CA_OP_XOR_RANGE && kind != CA_OP_FILL_RANGE &&
+            kind != CA_OP_ADD_INT && kind != CA_OP_SUB_INT && kind != CA_OP_SET_INT &&
+            kind != CA_OP_OVERWRITE_FROM_ADD) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Applies `plan`, already normalized against `request`, straight into `dst`.
+// Length-preserving plans are a copy of the input patched in place. Plans that leave
+// the input unchanged skip.
+ca_status_t ca_engine_plan_into(const normalized_plan_t *plan,
+                                const ca_mutate_request_t *request, uint8_t *dst,
+                                size_t dst_cap, size_t *out_len) {
+    if (plan->op_count == 0) return CA_STATUS_SKIP;
+
+    ca_status_t status;
+    bool changed = false;
+    size_t written = 0;
+    if (ca_plan_preserves_length(plan)) {
+        if (request->input_len > dst_cap) {
+            status = CA_STATUS_OUTPUT_TOO_LARGE;
+        } else {
+            memcpy(dst, request->input, request->input_len);
+            written = request->input_len;
+            status = mutation_plan_patch(plan, dst, written, &changed);
+        }
+    } else {
+        status = mutation_plan_measure(plan, request->input_len, &written);
+        if (status == CA_STATUS_OK && written > dst_cap) {
+            status = CA_STATUS_OUTPUT_TOO_LARGE;
+        }
+        if (status == CA_STATUS_OK) {
+            status = mutation_plan_apply(plan, request->input, request->input_len,
+                                         dst, dst_cap, &written, &changed);
+        }
+    }
+    if (status != CA_STATUS_OK) return status;
+    if (!changed || written == 0) return CA_STATUS_SKIP;
+
+    *out_len = written;
+    return CA_STATUS_OK;
+}
+
+ca_status_t ca_engine_mutate_into(ca_engine_t *engine, const ca_mutate_request_t *request,
+                                 uint8_t *dst, size_t dst_cap, size_t *out_len) {
+    if (!engine || !request || !dst || dst_cap == 0 || !out_len) {
+        return CA_STATUS_INVALID_ARGUMENT;
+    }
+    *out_len = 0;
+
+    ca_mutate_request_t bounded = *request;
+    if (bounded.max_output_len > dst_cap) bounded.max_output_len = dst_cap;
+    if (engine->mutate_into) {
+        return engine->mutate_into(engine->impl, &bounded, dst, dst_cap, out_len);
+    }
+
+    ca_output_t output = {0};
+    ca_status_t status = engine->mutate(engine->impl, &bounded, &output);
+    if (status != CA_STATUS_OK) return status;
+
+    if (output.kind == CA_OUTPUT_PLAN) {
+        if (!output.value.plan) return CA_STATUS_INTERNAL_ERROR;
+        return ca_engine_plan_into(output.value.plan, &bounded, dst, dst_cap, out_len);
+    }
+    if (output.kind != CA_OUTPUT_BUFFER || !output.value.buffer.data) {
+        return CA_STATUS_INTERNAL_ERROR;
+    }
+    if (output.value.buffer.len > dst_cap) return CA_STATUS_OUTPUT_TOO_LARGE;
+    memcpy(dst, output.value.buffer.data, output.value.buffer.len);
+    *out_len = output.value.buffer.len;
+    return CA_STATUS_OK;
+}
+
+ca_status_t ca_engine_begin(ca_engine_t *engine, const ca_mutate_request_t *request) {
+    if (!engine || !request) return CA_STATUS_INVALID_ARGUMENT;
+    if (engine->begin) return engine->begin(engine->impl, request);
+    engine->session = *request;
+    engine->session_open = true;
+    return CA_STATUS_OK;
+}
+
+ca_status_t ca_engine_next(ca_engine_t *engine, ca_output_t *output) {
+    if (!engine || !output) return CA_STATUS_INVALID_ARGUMENT;
+    if (engine->next) return engine->next(engine->impl, output);
+    if (!engine->session_open) return CA_STATUS_INVALID_ARGUMENT;
+    ca_status_t status = engine->mutate(engine->impl, &engine->session, output);
+    ++engine->session.mutation_id;
+    return status;
+}
+
 void ca_engine_destroy(ca_engine_t *engine) {
     if (!engine) return;
     if (engine->destroy) {
@@ -1,7 +1,10 @@
 #ifndef CA_MUTATOR_CA_ENGINE_INTERNAL_H_
 #define CA_MUTATOR_CA_ENGINE_INTERNAL_H_
 
+#include <stdbool.h>
+
 #include "ca_engine.h"
+#include "mutation_plan.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -11,6 +14,12 @@ typedef ca_status_t (*ca_engine_destroy_fn)(void *impl);
 typedef ca_status_t (*ca_engine_mutate_fn)(void *impl,
                                           const ca_mutate_request_t *request,
                                           ca_output_t *output);
+typedef ca_status_t (*ca_engine_begin_fn)(void *impl, const ca_mutate_request_t *request);
+typedef ca_status_t (*ca_engine_next_fn)(void *impl, ca_output_t *output);
+typedef ca_status_t (*ca_engine_mutate_into_fn)(void *impl,
+                                               const ca_mutate_request_t *request,
+                                               uint8_t *dst, size_t dst_cap,
+                                               size_t *out_len);
 
 struct ca_engine {
     void *impl;
@@ -19,8 +28,23 @@ struct ca_engine {
 
     ca_engine_destroy_fn destroy;
     ca_engine_mutate_fn mutate;
+    // Optional plan session hooks; without them ca_engine_next falls back to
+    // `mutate` on the request saved by ca_engine_begin.
+    ca_engine_begin_fn begin;
+    ca_engine_next_fn next;
+    ca_mutate_request_t session;
+    bool session_open;
+    // Optional: writes the final bytes into a caller buffer. Without it,
+    // ca_engine_mutate_into copies buffer outputs and applies plans into `dst`.
+    ca_engine_mutate_into_fn mutate_into;
 };
 
+// Applies a plan the engine already normalized for `request` into `dst`; the plan
+// path of ca_engine_mutate_into, shared with engine mutate_into hooks.
+ca_status_t ca_engine_plan_into(const normalized_plan_t *plan,
+                                const ca_mutate_request_t *request, uint8_t *dst,
+                                size_t dst_cap, size_t *out_len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,152 @@
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "grow_pool.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+typedef struct {
+    grow_pool_t *pool;
+    size_t slot;
+} grow_worker_t;
+
+struct grow_pool {
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;
+    pthread_cond_t work_done;
+
+    pthread_t *threads;
+    grow_worker_t *workers;
+    size_t thread_count;
+    size_t started;
+
+    // Current job, published under `lock` with a new `generation`.
+    uint64_t generation;
+    size_t remaining;
+    size_t count;
+    grow_pool_fn fn;
+    void *context;
+    bool stop;
+};
+
+static void grow_pool_chunk(const grow_pool_t *pool, size_t slot, size_t *begin,
+                            size_t *end) {
+    *begin = (pool->count * slot) / pool->thread_count;
+    *end = (pool->count * (slot + 1u)) / pool->thread_count;
+}
+
+static void *grow_pool_worker(void *arg) {
+    grow_worker_t *worker = (grow_worker_t *)arg;
+    grow_pool_t *pool = worker->pool;
+    uint64_t seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->stop && pool->generation == seen) {
+            pthread_cond_wait(&pool->work_ready, &pool->lock);
+        }
+        if (pool->stop) break;
+        seen = pool->generation;
+
+        size_t begin = 0;
+        size_t end = 0;
+        grow_pool_chunk(pool, worker->slot, &begin, &end);
+        grow_pool_fn fn = pool->fn;
+        void *context = pool->context;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (begin < end) fn(context, begin, end);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->remaining == 0) {
+            pthread_cond_signal(&pool->work_done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+ca_status_t grow_pool_create(size_t threads, grow_pool_t **pool) {
+    if (!pool || threads == 0) return CA_STATUS_INVALID_ARGUMENT;
+    *pool = NULL;
+
+    grow_pool_t *p = (grow_pool_t *)calloc(1, sizeof(*p));
+    if (!p) return CA_STATUS_OUT_OF_MEMORY;
+    p->thread_count = threads;
+
+    if (threads > 1) {
+        p->threads = (pthread_t *)calloc(threads - 1u, sizeof(*p->threads));
+        p->workers = (grow_worker_t *)calloc(threads - 1u, sizeof(*p->workers));
+        if (!p->threads || !p->workers) {
+            free(p->threads);
+            free(p->workers);
+            free(p);
+            return CA_STATUS_OUT_OF_MEMORY;
+        }
+    }
+
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->work_ready, NULL);
+    pthread_cond_init(&p->work_done, NULL);
+
+    for (size_t i = 0; i + 1u < threads; ++i) {
+        p->workers[i].pool = p;
+        p->workers[i].slot = i + 1u;
+        if (pthread_create(&p->threads[i], NULL, grow_pool_worker, &p->workers[i]) != 0) {
+            grow_pool_destroy(p);
+            return CA_STATUS_INTERNAL_ERROR;
+        }
+        ++p->started;
+    }
+
+    *pool = p;
+    return CA_STATUS_OK;
+}
+
+void grow_pool_run(grow_pool_t *pool, size_t count, grow_pool_fn fn, void *context) {
+    if (!pool || !fn || count == 0) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->count = count;
+    pool->fn = fn;
+    pool->context = context;
+    pool->remaining = pool->started;
+    ++pool->generation;
+    pthread_cond_broadcast(&pool->work_ready);
+
+    size_t begin = 0;
+    size_t end = 0;
+    grow_pool_chunk(pool, 0, &begin, &end);
+    pthread_mutex_unlock(&pool->lock);
+
+    if (begin < end) fn(context, begin, end);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->remaining > 0) {
+        pthread_cond_wait(&pool->work_done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void grow_pool_destroy(grow_pool_t *pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < pool->started; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&pool->work_done);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->threads);
+    free(pool->workers);
+    free(pool);
+}
@@ -0,0 +1,29 @@
+#ifndef CA_MUTATOR_GROW_POOL_H_
+#define CA_MUTATOR_GROW_POOL_H_
+
+#include <stddef.h>
+
+#include "ca_engine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Processes the index range [begin, end).
+typedef void (*grow_pool_fn)(void *context, size_t begin, size_t end);
+
+typedef struct grow_pool grow_pool_t;
+
+// Starts `threads - 1` workers; the calling thread takes part in every run.
+ca_status_t grow_pool_create(size_t threads, grow_pool_t **pool);
+// Splits [0, count) into one contiguous chunk per thread and returns once every
+// chunk has been processed. Chunk boundaries depend only on `count` and the
+// thread count.
+void grow_pool_run(grow_pool_t *pool, size_t count, grow_pool_fn fn, void *context);
+void grow_pool_destroy(grow_pool_t *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CA_MUTATOR_GROW_POOL_H_
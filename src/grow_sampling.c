@@ -0,0 +1,115 @@
+#include "grow_sampling.h"
+
+#include <stdlib.h>
+
+ca_status_t grow_alias_build(grow_alias_t *table, const uint32_t *weights, size_t count) {
+    if (!table || !weights || count == 0 || count > GROW_ALIAS_MAX) {
+        return CA_STATUS_INVALID_ARGUMENT;
+    }
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < count; ++i) total += weights[i];
+    if (total == 0) return CA_STATUS_INVALID_ARGUMENT;
+
+    uint64_t scaled[GROW_ALIAS_MAX];
+    size_t small[GROW_ALIAS_MAX];
+    size_t large[GROW_ALIAS_MAX];
+    size_t small_count = 0;
+    size_t large_count = 0;
+    for (size_t i = 0; i < count; ++i) {
+        scaled[i] = (uint64_t)weights[i] * count * GROW_ALIAS_SCALE / total;
+        if (scaled[i] < GROW_ALIAS_SCALE) {
+            small[small_count++] = i;
+        } else {
+            large[large_count++] = i;
+        }
+    }
+
+    while (small_count > 0 && large_count > 0) {
+        size_t s = small[--small_count];
+        size_t l = large[large_count - 1u];
+        table->prob[s] = (uint32_t)scaled[s];
+        table->alias[s] = (uint8_t)l;
+        scaled[l] -= GROW_ALIAS_SCALE - scaled[s];
+        if (scaled[l] < GROW_ALIAS_SCALE) {
+            --large_count;
+            small[small_count++] = l;
+        }
+    }
+    // Whatever is left is full up to rounding.
+    while (large_count > 0) {
+        size_t l = large[--large_count];
+        table->prob[l] = GROW_ALIAS_SCALE;
+        table->alias[l] = (uint8_t)l;
+    }
+    while (small_count > 0) {
+        size_t s = small[--small_count];
+        table->prob[s] = GROW_ALIAS_SCALE;
+        table->alias[s] = (uint8_t)s;
+    }
+
+    table->count = (uint32_t)count;
+    return CA_STATUS_OK;
+}
+
+ca_status_t grow_fenwick_build(grow_fenwick_t *fenwick, const uint32_t *weights,
+                               size_t count) {
+    if (!fenwick || (!weights && count != 0)) return CA_STATUS_INVALID_ARGUMENT;
+
+    if (fenwick->capacity < count + 1u) {
+        uint64_t *tree =
+            (uint64_t *)realloc(fenwick->tree, (count + 1u) * sizeof(*tree));
+        if (!tree) return CA_STATUS_OUT_OF_MEMORY;
+        fenwick->tree = tree;
+        fenwick->capacity = count + 1u;
+    }
+
+    // Linear-time construction: every node pushes its partial sum to its parent.
+    fenwick->tree[0] = 0;
+    for (size_t i = 1; i <= count; ++i) {
+        fenwick->tree[i] = weights[i - 1u];
+    }
+    for (size_t i = 1; i <= count; ++i) {
+        size_t parent = i + (i & (~i + 1u));
+        if (parent <= count) fenwick->tree[parent] += fenwick->tree[i];
+    }
+
+    fenwick->count = count;
+    fenwick->top = 1;
+    while (fenwick->top <= count / 2u) fenwick->top <<= 1;
+    fenwick->total = 0;
+    for (size_t i = count; i > 0; i -= (i & (~i + 1u))) {
+        fenwick->total += fenwick->tree[i];
+    }
+    return CA_STATUS_OK;
+}
+
+void grow_fenwick_remove(grow_fenwick_t *fenwick, size_t index, uint64_t weight) {
+    if (!fenwick || index >= fenwick->count || weight == 0) return;
+    for (size_t i = index + 1u; i <= fenwick->count; i += (i & (~i + 1u))) {
+        fenwick->tree[i] -= weight;
+    }
+    fenwick->total -= weight;
+}
+
+size_t grow_fenwick_find(const grow_fenwick_t *fenwick, uint64_t target) {
+    size_t pos = 0;
+    for (size_t step = fenwick->top; step > 0; step >>= 1) {
+        size_t next = pos + step;
+        if (next <= fenwick->count && fenwick->tree[next] <= target) {
+            pos = next;
+            target -= fenwick->tree[next];
+        }
+    }
+    return pos;
+}
+
+void grow_fenwick_free(grow_fenwick_t *fenwick) {
+    if (!fenwick) return;
+    free(fenwick->tree);
+    fenwick->tree = NULL;
+    fenwick->count = 0;
+    fenwick->capacity = 0;
+    fenwick->top = 0;
+    fenwick->total = 0;
+}
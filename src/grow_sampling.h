@@ -0,0 +1,58 @@
+#ifndef CA_MUTATOR_GROW_SAMPLING_H_
+#define CA_MUTATOR_GROW_SAMPLING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ca_engine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fenwick (binary indexed) tree over non-negative integer weights. Building is
+// O(n); removing a weight and drawing an index proportional to weight are
+// O(log n).
+typedef struct {
+    uint64_t *tree;
+    size_t count;
+    size_t capacity;
+    // Highest power of two <= count, the start of every descent.
+    size_t top;
+    uint64_t total;
+} grow_fenwick_t;
+
+#define GROW_ALIAS_MAX 16u
+// Resolution of one alias column; draws are taken from [0, count * GROW_ALIAS_SCALE).
+#define GROW_ALIAS_SCALE 65536u
+
+// Walker/Vose alias table over at most GROW_ALIAS_MAX outcomes: one draw and one
+// lookup per sample.
+typedef struct {
+    uint32_t prob[GROW_ALIAS_MAX];
+    uint8_t alias[GROW_ALIAS_MAX];
+    uint32_t count;
+} grow_alias_t;
+
+// Fails with CA_STATUS_INVALID_ARGUMENT when all weights are 0.
+ca_status_t grow_alias_build(grow_alias_t *table, const uint32_t *weights, size_t count);
+
+static inline size_t grow_alias_pick(const grow_alias_t *table, uint32_t draw) {
+    uint32_t column = draw / GROW_ALIAS_SCALE;
+    return (draw % GROW_ALIAS_SCALE) < table->prob[column] ? column : table->alias[column];
+}
+
+ca_status_t grow_fenwick_build(grow_fenwick_t *fenwick, const uint32_t *weights,
+                               size_t count);
+// Subtracts `weight` from index `index`; `weight` must not exceed its current weight.
+void grow_fenwick_remove(grow_fenwick_t *fenwick, size_t index, uint64_t weight);
+// Returns the index whose cumulative weight range contains `target`
+// (`target < total`).
+size_t grow_fenwick_find(const grow_fenwick_t *fenwick, uint64_t target);
+void grow_fenwick_free(grow_fenwick_t *fenwick);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CA_MUTATOR_GROW_SAMPLING_H_
@@ -9,22 +9,47 @@
 
 #include "ca_engine_internal.h"
 #include "growing_engine.h"
+#include "grow_pool.h"
+#include "grow_sampling.h"
 #include "mutation_plan.h"
 
-#define CA_GROW_BLOCK_SIZE 16u
+#define CA_GROW_LINEAGE_MAX_STEPS 256u
+#define CA_GROW_QUIET_DELTA 64u
+#define CA_GROW_QUIET_ACTIVITY 4u
+
+#define CA_GROW_PYRAMID_MIN_INPUT (64u * 1024u)
+#define CA_GROW_PYRAMID_TOP_CELLS 1024u
+#define CA_GROW_PYRAMID_FANOUT_SHIFT 4u
+#define CA_GROW_PYRAMID_KEEP 4u
+#define CA_GROW_PYRAMID_SAMPLES 64u
+
+// Below this many cells the worker pool is not worth the wake-up cost.
+#define CA_GROW_PARALLEL_MIN_CELLS 1024u
+
+#define CA_GROW_WINDOW_DEFAULT_CELLS 4096u
+// Largest stencil distance read by grow_update_cell: the window halo is this many
+// cells per evolution step.
+#define CA_GROW_WINDOW_HALO 8u
+
+// Splice partners are encoded into at most this many cells; larger ones use
+// wider blocks.
+#define CA_GROW_SPLICE_MAX_CELLS 4096u
+// Add cells compared per splice op; the one closest in activity wins.
+#define CA_GROW_SPLICE_PROBES 4u
 
 typedef struct {
     uint16_t byte_sum;
     uint8_t printable;
-    uint8_t filled;
     uint8_t entropy;
     uint8_t activity;
+    uint32_t filled;
     uint16_t channels[6];
     size_t position;
 } growing_cell_t;
 
 typedef struct {
-    uint8_t *input;
+    // Borrowed from the current request; valid until the caller's plan session ends.
+    const uint8_t *input;
     size_t input_len;
     size_t block_size;
     size_t cell_count;
@@ -32,6 +57,80 @@ typedef struct {
     mutation_plan_t plan;
     growing_cell_t *cells;
 
+    // Pristine encodings of the last input and per-block hashes used to re-encode
+    // only the blocks that changed between consecutive calls.
+    growing_cell_t *encoded;
+    uint64_t *block_hashes;
+    size_t encoded_count;
+    size_t encoded_block_size;
+    // Copy of the input `encoded` was built from; a block is only reused when its
+    // bytes match, the hash just filters.
+    uint8_t *encoded_input;
+    size_t encoded_input_len;
+    size_t encoded_input_capacity;
+    uint64_t input_hash;
+
+    uint32_t flags;
+    ca_growing_params_t params;
+    // Lineage mode: `cells` holds the evolved state for `lineage_hash` after
+    // `lineage_steps` steps and is resumed when the same input comes back.
+    bool lineage_valid;
+    uint64_t lineage_hash;
+    uint32_t lineage_steps;
+
+    // Active-set mode: `active` lists the cells to revisit in the next step
+    // (`active_all` means every cell); `active_stamp` deduplicates the frontier.
+    size_t *active;
+    size_t *active_next;
+    size_t active_count;
+    bool active_all;
+    uint32_t *active_stamp;
+    uint32_t active_epoch;
+    growing_cell_t *pending;
+    size_t *pending_index;
+    size_t active_capacity;
+
+    // Window mode: inputs of at least `window_min_input` bytes only get
+    // `window_cells` cells (0 disables windowing).
+    size_t window_min_input;
+    size_t window_cells;
+
+    // Plan session opened by ca_growing_begin; `input` stays borrowed until the
+    // next begin.
+    ca_status_t session_status;
+    size_t session_max_ops;
+    size_t session_max_output_len;
+    uint64_t session_mutation_id;
+
+    // Derived-RNG mode (worker_threads > 0): the update mask and decode draws come
+    // from per-cell streams so results do not depend on the thread count; `pool`
+    // is set when more than one thread is requested.
+    bool derived_rng;
+    grow_pool_t *pool;
+
+    // Weighted position sampling (params.position_mode != CA_GROW_POSITION_CELL).
+    grow_fenwick_t position_tree;
+    uint32_t *position_weights;
+    size_t position_weights_capacity;
+    uint32_t *external_weights;
+    size_t external_weights_len;
+
+    // Op kind alias table, built from params.kind_weights; unused when all are 0.
+    grow_alias_t kind_table;
+    bool kind_table_ready;
+
+    // Splice partner of the current session, borrowed like `input`, and its cells,
+    // encoded but not evolved. Only set when the splice kind has a weight.
+    const uint8_t *add_buf;
+    size_t add_buf_len;
+    growing_cell_t *add_cells;
+    size_t add_cell_count;
+    size_t add_cell_capacity;
+
+    // Per-cell activity handed out by ca_growing_cell_activity.
+    uint8_t *trim_activity;
+    size_t trim_activity_capacity;
+
 #ifdef CA_GROWING_DEBUG
     size_t debug_raw_ops;
     size_t debug_candidate_ops;
@@ -45,6 +144,8 @@ typedef struct {
     size_t debug_removed_inserts;
     size_t debug_conflicts;
     size_t debug_rng_calls;
+    size_t debug_reencoded_cells;
+    size_t debug_active_updates;
 #endif
 } ca_growing_engine_t;
 
@@ -64,6 +165,8 @@ static void ca_growing_reset_state(ca_growing_engine_t *engine) {
     engine->debug_removed_inserts = 0;
     engine->debug_conflicts = 0;
     engine->debug_rng_calls = 0;
+    engine->debug_reencoded_cells = 0;
+    engine->debug_active_updates = 0;
 #endif
 }
 
@@ -79,23 +182,29 @@ static uint64_t grow_hash64(const uint8_t *data, size_t len) {
 }
 #endif
 
+// A decoded op and its acceptance rank, before it is added to the plan.
+typedef struct {
+    mutation_op_t op;
+    mutation_op_rank_t rank;
+} grow_candidate_t;
+
 static bool is_noop_candidate(const ca_growing_engine_t *engine,
                              const mutation_op_t *candidate) {
     if (!engine || !candidate) return true;
 
     if (candidate->kind == CA_OP_BIT_FLIP) {
-        if (candidate->arg.bit_flip.bit_index > 7u) return true;
+        if (candidate->arg > 7u) return true;
         return candidate->len != 1;
     }
 
     if (candidate->kind == CA_OP_SET_BYTE) {
         if (candidate->len != 1 || candidate->pos >= engine->input_len) return true;
         if (engine->input_len == 0) return true;
-        return engine->input[candidate->pos] == candidate->arg.set_byte.value;
+        return engine->input[candidate->pos] == candidate->arg;
     }
 
     if (candidate->kind == CA_OP_ADD_BYTE || candidate->kind == CA_OP_SUB_BYTE) {
-        return candidate->len != 1 || candidate->arg.arithmetic.delta == 0u;
+        return candidate->len != 1 || candidate->arg == 0u;
     }
 
     if (candidate->kind == CA_OP_DELETE_RANGE) {
@@ -106,12 +215,41 @@ static bool is_noop_candidate(const ca_growing_engine_t *engine,
 
     if (candidate->kind == CA_OP_INSERT_BYTES) {
         if (candidate->len == 0) return true;
-        if (candidate->pos > engine->input_len) return true;
-        if (candidate->arg.insert.data_len != 0 &&
-            candidate->arg.insert.data_len != candidate->len) {
+        return candidate->pos > engine->input_len;
+    }
+
+    if (candidate->kind == CA_OP_ADD_INT || candidate->kind == CA_OP_SUB_INT ||
+        candidate->kind == CA_OP_SET_INT) {
+        const uint32_t width = candidate->len;
+        if ((width != 2u && width != 4u && width != 8u) ||
+            (uint64_t)candidate->pos + width > engine->input_len) {
+            return true;
+        }
+        if (candidate->kind != CA_OP_SET_INT) return candidate->data_offset == 0u;
+        // SET_INT sign-extends its 32-bit value to the field width.
+        const uint64_t value = (uint64_t)(int64_t)(int32_t)candidate->data_offset;
+        const bool big_endian = (candidate->arg & CA_OP_INT_BIG_ENDIAN) != 0;
+        for (uint32_t b = 0; b < width; ++b) {
+            uint8_t byte = (uint8_t)(value >> (b * 8u));
+            if (engine->input[candidate->pos + (big_endian ? width - 1u - b : b)] != byte) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (candidate->kind == CA_OP_INSERT_FROM_ADD ||
+        candidate->kind == CA_OP_OVERWRITE_FROM_ADD) {
+        if (candidate->len == 0 || !engine->add_buf ||
+            (uint64_t)candidate->data_offset + candidate->len > engine->add_buf_len) {
             return true;
         }
-        return false;
+        if (candidate->kind == CA_OP_INSERT_FROM_ADD) {
+            return candidate->pos > engine->input_len;
+        }
+        if ((uint64_t)candidate->pos + candidate->len > engine->input_len) return true;
+        return memcmp(engine->input + candidate->pos,
+                      engine->add_buf + candidate->data_offset, candidate->len) == 0;
     }
 
     return true;
@@ -125,37 +263,81 @@ static uint32_t grow_below(ca_growing_engine_t *engine, uint32_t limit) {
     return engine->rng.below(engine->rng.context, limit);
 }
 
-static uint8_t grow_u8(ca_growing_engine_t *engine) {
-    return (uint8_t)grow_below(engine, 256u);
+static uint32_t grow_engine_below(void *context, uint32_t limit) {
+    return grow_below((ca_growing_engine_t *)context, limit);
+}
+
+// The engine RNG as a ca_rng_t, for helpers that can also draw from a per-cell stream.
+static ca_rng_t grow_engine_rng(ca_growing_engine_t *engine) {
+    return (ca_rng_t){.below = grow_engine_below, .context = engine};
+}
+
+static uint32_t grow_rng_below(ca_rng_t *rng, uint32_t limit) {
+    if (!rng->below || limit == 0) return 0u;
+    return rng->below(rng->context, limit);
 }
 
-static size_t grow_u32_range(ca_growing_engine_t *engine, size_t max_inclusive) {
-    if (!engine || max_inclusive == 0u) return 0u;
+static uint8_t grow_u8(ca_rng_t *rng) {
+    return (uint8_t)grow_rng_below(rng, 256u);
+}
+
+static size_t grow_u32_range(ca_rng_t *rng, size_t max_inclusive) {
+    if (!rng || max_inclusive == 0u) return 0u;
     if (max_inclusive > UINT32_MAX) {
-        return (size_t)grow_below(engine, UINT32_MAX);
+        return (size_t)grow_rng_below(rng, UINT32_MAX);
     }
-    return (size_t)grow_below(engine, (uint32_t)(max_inclusive + 1u));
+    return (size_t)grow_rng_below(rng, (uint32_t)(max_inclusive + 1u));
 }
 
-static size_t grow_span_pos(ca_growing_engine_t *engine, const growing_cell_t *cell) {
+static size_t grow_span_pos(ca_rng_t *rng, const growing_cell_t *cell) {
     if (!cell || cell->filled == 0) return 0u;
-    return (size_t)grow_below(engine, (uint32_t)cell->filled);
+    return (size_t)grow_rng_below(rng, (uint32_t)cell->filled);
+}
+
+static uint64_t grow_mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Per-cell splitmix64 stream derived from a per-call seed and the cell index, so
+// draws do not depend on which thread handles the cell.
+static uint32_t grow_cell_below(void *context, uint32_t limit) {
+    uint64_t *state = (uint64_t *)context;
+    *state += 0x9E3779B97F4A7C15ULL;
+    return (uint32_t)(((grow_mix64(*state) >> 32) * (uint64_t)limit) >> 32);
+}
+
+static uint64_t grow_cell_seed(uint64_t seed, size_t index) {
+    return grow_mix64(seed ^ ((uint64_t)index * 0xD6E8FEB86659FD93ULL));
+}
+
+static uint64_t grow_draw_seed(ca_growing_engine_t *engine) {
+    uint64_t hi = grow_below(engine, UINT32_MAX);
+    return (hi << 32) | grow_below(engine, UINT32_MAX);
+}
+
+static void grow_parallel_for(ca_growing_engine_t *engine, size_t count, grow_pool_fn fn,
+                              void *context) {
+    if (engine->pool && count >= CA_GROW_PARALLEL_MIN_CELLS) {
+        grow_pool_run(engine->pool, count, fn, context);
+    } else if (count > 0) {
+        fn(context, 0, count);
+    }
 }
 
 static uint8_t is_printable(uint8_t b) {
     return (b >= 0x20 && b <= 0x7E) ? 1u : 0u;
 }
 
-static void grow_encode_cell(ca_growing_engine_t *engine, growing_cell_t *cell,
-                            size_t index) {
-    size_t start = index * engine->block_size;
-    size_t end =
-        (start + engine->block_size > engine->input_len)
-            ? engine->input_len
-            : (start + engine->block_size);
+// Encodes `len` bytes of `data` at `start` into `cell`, reading every `stride`-th
+// byte. `index` is the block index at the cell's resolution.
+static void grow_encode_span(const uint8_t *data, growing_cell_t *cell, size_t start,
+                             size_t len, size_t index, size_t stride) {
+    size_t end = start + len;
 
     cell->position = start;
-    cell->filled = (uint8_t)(end - start);
+    cell->filled = (uint32_t)len;
     cell->byte_sum = 0;
     cell->printable = 0;
     cell->entropy = 0;
@@ -167,8 +349,8 @@ static void grow_encode_cell(ca_growing_engine_t *engine, growing_cell_t *cell,
         return;
     }
 
-    for (size_t i = start; i < end; ++i) {
-        uint8_t b = engine->input[i];
+    for (size_t i = start; i < end; i += stride) {
+        uint8_t b = data[i];
         cell->byte_sum ^= (uint16_t)b;
         cell->printable += is_printable(b);
         cell->entropy = (uint8_t)(cell->entropy + (uint8_t)(b ^ (uint8_t)i));
@@ -185,6 +367,125 @@ static void grow_encode_cell(ca_growing_engine_t *engine, growing_cell_t *cell,
     }
 }
 
+static void grow_encode_cell(ca_growing_engine_t *engine, growing_cell_t *cell,
+                            size_t index) {
+    size_t start = index * engine->block_size;
+    size_t end =
+        (start + engine->block_size > engine->input_len)
+            ? engine->input_len
+            : (start + engine->block_size);
+    if (start > end) start = end;
+
+    grow_encode_span(engine->input, cell, start, end - start, index, 1u);
+}
+
+static uint64_t grow_block_hash(const uint8_t *data, size_t len) {
+    uint64_t hash = 1469598103934665603ULL ^ (uint64_t)len;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 29;
+    }
+    for (; i < len; ++i) {
+        hash = (hash ^ (uint64_t)data[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+typedef struct {
+    ca_growing_engine_t *engine;
+    bool reuse;
+    // Only counted when the chunk runs on the calling thread.
+    size_t reencoded;
+} grow_encode_job_t;
+
+static void grow_encode_chunk(void *context, size_t begin, size_t end) {
+    grow_encode_job_t *job = (grow_encode_job_t *)context;
+    ca_growing_engine_t *engine = job->engine;
+    size_t reencoded = 0;
+
+    for (size_t i = begin; i < end; ++i) {
+        size_t start = i * engine->block_size;
+        size_t len = 0;
+        if (start < engine->input_len) {
+            len = engine->input_len - start;
+            if (len > engine->block_size) len = engine->block_size;
+        }
+
+        uint64_t hash = grow_block_hash(engine->input + (len ? start : 0), len);
+        if (job->reuse && engine->block_hashes[i] == hash) {
+            size_t old_len = 0;
+            if (start < engine->encoded_input_len) {
+                old_len = engine->encoded_input_len - start;
+                if (old_len > engine->block_size) old_len = engine->block_size;
+            }
+            if (old_len == len &&
+                (len == 0 ||
+                 memcmp(engine->encoded_input + start, engine->input + start, len) == 0)) {
+                continue;
+            }
+        }
+
+        grow_encode_cell(engine, &engine->encoded[i], i);
+        engine->block_hashes[i] = hash;
+        if (len) memcpy(engine->encoded_input + start, engine->input + start, len);
+        ++reencoded;
+    }
+
+    if (begin == 0) job->reencoded = reencoded;
+}
+
+// Encoded cells depend only on block bytes, block length and cell index, so a block
+// whose bytes match the previous call at the same index keeps its old encoding.
+// Also folds the block hashes into `input_hash`.
+static ca_status_t grow_encode_cells(ca_growing_engine_t *engine) {
+    if (engine->input_len > engine->encoded_input_capacity) {
+        uint8_t *next = (uint8_t *)realloc(engine->encoded_input, engine->input_len);
+        if (!next) return CA_STATUS_OUT_OF_MEMORY;
+        engine->encoded_input = next;
+        engine->encoded_input_capacity = engine->input_len;
+    }
+    bool reuse = engine->encoded && engine->block_hashes &&
+                 engine->encoded_count == engine->cell_count &&
+                 engine->encoded_block_size == engine->block_size;
+
+    if (!reuse) {
+        free(engine->encoded);
+        free(engine->block_hashes);
+        engine->encoded_count = 0;
+        engine->encoded =
+            (growing_cell_t *)malloc(engine->cell_count * sizeof(*engine->encoded));
+        engine->block_hashes =
+            (uint64_t *)malloc(engine->cell_count * sizeof(*engine->block_hashes));
+        if (!engine->encoded || !engine->block_hashes) {
+            free(engine->encoded);
+            free(engine->block_hashes);
+            engine->encoded = NULL;
+            engine->block_hashes = NULL;
+            return CA_STATUS_OUT_OF_MEMORY;
+        }
+        engine->encoded_count = engine->cell_count;
+        engine->encoded_block_size = engine->block_size;
+    }
+
+    grow_encode_job_t job = {.engine = engine, .reuse = reuse};
+    grow_parallel_for(engine, engine->cell_count, grow_encode_chunk, &job);
+    engine->encoded_input_len = engine->input_len;
+
+    engine->input_hash = 1469598103934665603ULL ^ (uint64_t)engine->input_len;
+    for (size_t i = 0; i < engine->cell_count; ++i) {
+        engine->input_hash =
+            (engine->input_hash ^ engine->block_hashes[i]) * 0x9E3779B97F4A7C15ULL;
+    }
+#ifdef CA_GROWING_DEBUG
+    engine->debug_reencoded_cells += job.reencoded;
+#endif
+
+    return CA_STATUS_OK;
+}
+
 static size_t grow_left(const ca_growing_engine_t *engine, size_t idx, size_t dist) {
     if (engine->cell_count == 0) return 0;
     if (dist == 0) return idx;
@@ -200,10 +501,10 @@ static size_t grow_right(const ca_growing_engine_t *engine, size_t idx, size_t d
 
 static void grow_update_cell(const ca_growing_engine_t *engine, const growing_cell_t *src,
                             growing_cell_t *dst, size_t idx) {
-    const int w1 = 7;
-    const int w2 = 3;
-    const int w4 = 2;
-    const int w8 = 1;
+    const int32_t w1 = engine->params.weights[0];
+    const int32_t w2 = engine->params.weights[1];
+    const int32_t w4 = engine->params.weights[2];
+    const int32_t w8 = engine->params.weights[3];
 
     uint32_t n1_l = src[grow_left(engine, idx, 1)].channels[0];
     uint32_t n1_r = src[grow_right(engine, idx, 1)].channels[0];
@@ -236,8 +537,50 @@ static void grow_update_cell(const ca_growing_engine_t *engine, const growing_ce
     }
 }
 
+typedef struct {
+    ca_growing_engine_t *engine;
+    growing_cell_t *next;
+    uint64_t seed;
+} grow_step_job_t;
+
+static void grow_step_chunk(void *context, size_t begin, size_t end) {
+    grow_step_job_t *job = (grow_step_job_t *)context;
+    ca_growing_engine_t *engine = job->engine;
+
+    memcpy(job->next + begin, engine->cells + begin, (end - begin) * sizeof(*job->next));
+    for (size_t i = begin; i < end; ++i) {
+        uint64_t state = grow_cell_seed(job->seed, i);
+        if (grow_cell_below(&state, 100u) < engine->params.update_percent) {
+            grow_update_cell(engine, engine->cells, &job->next[i], i);
+        }
+    }
+}
+
+// Derived-RNG variant of grow_step_cells: one seed per step, one mask draw per cell
+// from that cell's stream.
+static void grow_step_derived(ca_growing_engine_t *engine, uint32_t iterations) {
+    growing_cell_t *next =
+        (growing_cell_t *)malloc(engine->cell_count * sizeof(*next));
+    if (!next) return;
+
+    for (uint32_t step = 0; step < iterations; ++step) {
+        grow_step_job_t job = {.engine = engine, .next = next, .seed = grow_draw_seed(engine)};
+        grow_parallel_for(engine, engine->cell_count, grow_step_chunk, &job);
+
+        growing_cell_t *tmp = engine->cells;
+        engine->cells = next;
+        next = tmp;
+    }
+
+    free(next);
+}
+
 static void grow_step_cells(ca_growing_engine_t *engine, uint32_t iterations) {
     if (!engine || !engine->cells || engine->cell_count == 0 || iterations == 0) return;
+    if (engine->derived_rng) {
+        grow_step_derived(engine, iterations);
+        return;
+    }
 
     growing_cell_t *next =
         (growing_cell_t *)calloc(engine->cell_count, sizeof(*next));
@@ -251,7 +594,7 @@ static void grow_step_cells(ca_growing_engine_t *engine, uint32_t iterations) {
 
     for (uint32_t step = 0; step < iterations; ++step) {
         for (size_t i = 0; i < engine->cell_count; ++i) {
-            update_mask[i] = (grow_below(engine, 100u) < 60u);
+            update_mask[i] = (grow_below(engine, 100u) < engine->params.update_percent);
         }
         memcpy(next, engine->cells, engine->cell_count * sizeof(*next));
 
@@ -270,9 +613,137 @@ static void grow_step_cells(ca_growing_engine_t *engine, uint32_t iterations) {
     free(update_mask);
 }
 
+static uint16_t grow_channel_distance(uint16_t a, uint16_t b) {
+    uint16_t d = (uint16_t)(a - b);
+    uint16_t r = (uint16_t)(b - a);
+    return d < r ? d : r;
+}
+
+// A cell counts as changed when its activity moved by at least CA_GROW_QUIET_ACTIVITY
+// and one of the channels read by the stencil (0..3) moved by at least
+// CA_GROW_QUIET_DELTA. Channels drift by the stencil sum on every update, so they
+// alone never settle; activity saturates at 0 or 255, which quiet cells reach.
+static bool grow_cell_changed(const growing_cell_t *before, const growing_cell_t *after) {
+    uint32_t activity = before->activity > after->activity
+                            ? (uint32_t)(before->activity - after->activity)
+                            : (uint32_t)(after->activity - before->activity);
+    if (activity < CA_GROW_QUIET_ACTIVITY) return false;
+    for (size_t ch = 0; ch < 4; ++ch) {
+        if (grow_channel_distance(before->channels[ch], after->channels[ch]) >=
+            CA_GROW_QUIET_DELTA) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static ca_status_t grow_active_reserve(ca_growing_engine_t *engine) {
+    if (engine->active_capacity >= engine->cell_count) return CA_STATUS_OK;
+
+    size_t n = engine->cell_count;
+    size_t *active = (size_t *)realloc(engine->active, n * sizeof(*active));
+    if (active) engine->active = active;
+    size_t *active_next = (size_t *)realloc(engine->active_next, n * sizeof(*active_next));
+    if (active_next) engine->active_next = active_next;
+    growing_cell_t *pending = (growing_cell_t *)realloc(engine->pending, n * sizeof(*pending));
+    if (pending) engine->pending = pending;
+    size_t *pending_index =
+        (size_t *)realloc(engine->pending_index, n * sizeof(*pending_index));
+    if (pending_index) engine->pending_index = pending_index;
+    uint32_t *stamp = (uint32_t *)realloc(engine->active_stamp, n * sizeof(*stamp));
+    if (stamp) engine->active_stamp = stamp;
+
+    if (!active || !active_next || !pending || !pending_index || !stamp) {
+        return CA_STATUS_OUT_OF_MEMORY;
+    }
+
+    memset(engine->active_stamp, 0, n * sizeof(*engine->active_stamp));
+    engine->active_epoch = 0;
+    engine->active_capacity = n;
+    return CA_STATUS_OK;
+}
+
+static void grow_active_mark(ca_growing_engine_t *engine, size_t idx, size_t *count) {
+    if (engine->active_stamp[idx] == engine->active_epoch) return;
+    engine->active_stamp[idx] = engine->active_epoch;
+    engine->active_next[(*count)++] = idx;
+}
+
+// Active-set variant of grow_step_cells. Updates for the active cells are computed
+// from the current snapshot into `pending` and committed afterwards, so the step is
+// still not order-dependent; the cells that changed, every cell whose stencil reads
+// them and the active cells that drew no update form the next frontier. A cell
+// leaves it once an update stays under grow_cell_changed's threshold and is not
+// updated again until a neighbour changes, so its channels stop drifting there
+// and the output differs from full stepping. Without memory for the frontier this
+// falls back to full stepping.
+static void grow_step_active(ca_growing_engine_t *engine, uint32_t iterations) {
+    if (!engine || !engine->cells || engine->cell_count == 0 || iterations == 0) return;
+    if (grow_active_reserve(engine) != CA_STATUS_OK) {
+        engine->active_all = true;
+        grow_step_cells(engine, iterations);
+        return;
+    }
+
+    static const size_t kStencil[] = {1u, 2u, 4u, 8u};
+
+    for (uint32_t step = 0; step < iterations; ++step) {
+        if (engine->active_all) {
+            for (size_t i = 0; i < engine->cell_count; ++i) {
+                engine->active[i] = i;
+            }
+            engine->active_count = engine->cell_count;
+            engine->active_all = false;
+        }
+        if (engine->active_count == 0) break;
+
+        if (++engine->active_epoch == 0) {
+            memset(engine->active_stamp, 0,
+                   engine->active_capacity * sizeof(*engine->active_stamp));
+            engine->active_epoch = 1;
+        }
+
+        // A cell that loses the update draw has not settled, only waited; it stays
+        // in the frontier until an update shows whether it changes.
+        size_t next_count = 0;
+        size_t pending_count = 0;
+        for (size_t j = 0; j < engine->active_count; ++j) {
+            size_t idx = engine->active[j];
+            if (grow_below(engine, 100u) >= engine->params.update_percent) {
+                grow_active_mark(engine, idx, &next_count);
+                continue;
+            }
+            grow_update_cell(engine, engine->cells, &engine->pending[pending_count], idx);
+            engine->pending_index[pending_count] = idx;
+            ++pending_count;
+        }
+#ifdef CA_GROWING_DEBUG
+        engine->debug_active_updates += pending_count;
+#endif
+
+        for (size_t k = 0; k < pending_count; ++k) {
+            size_t idx = engine->pending_index[k];
+            bool changed = grow_cell_changed(&engine->cells[idx], &engine->pending[k]);
+            engine->cells[idx] = engine->pending[k];
+            if (!changed) continue;
+
+            grow_active_mark(engine, idx, &next_count);
+            for (size_t s = 0; s < sizeof(kStencil) / sizeof(*kStencil); ++s) {
+                grow_active_mark(engine, grow_left(engine, idx, kStencil[s]), &next_count);
+                grow_active_mark(engine, grow_right(engine, idx, kStencil[s]), &next_count);
+            }
+        }
+
+        size_t *tmp = engine->active;
+        engine->active = engine->active_next;
+        engine->active_next = tmp;
+        engine->active_count = next_count;
+    }
+}
+
 static int by_activity_desc_score(const void *left, const void *right) {
-    const mutation_op_t *a = (const mutation_op_t *)left;
-    const mutation_op_t *b = (const mutation_op_t *)right;
+    const mutation_op_rank_t *a = &((const grow_candidate_t *)left)->rank;
+    const mutation_op_rank_t *b = &((const grow_candidate_t *)right)->rank;
     if (a->score != b->score) {
         return (a->score < b->score) ? 1 : -1;
     }
@@ -297,128 +768,238 @@ static const char *grow_op_name(mutation_op_kind_t kind) {
             return "DELETE_RANGE";
         case CA_OP_INSERT_BYTES:
             return "INSERT_BYTES";
+        case CA_OP_XOR_RANGE:
+            return "XOR_RANGE";
+        case CA_OP_FILL_RANGE:
+            return "FILL_RANGE";
+        case CA_OP_COPY_RANGE:
+            return "COPY_RANGE";
+        case CA_OP_ADD_INT:
+            return "ADD_INT";
+        case CA_OP_SUB_INT:
+            return "SUB_INT";
+        case CA_OP_SET_INT:
+            return "SET_INT";
+        case CA_OP_INSERT_FROM_ADD:
+            return "INSERT_FROM_ADD";
+        case CA_OP_OVERWRITE_FROM_ADD:
+            return "OVERWRITE_FROM_ADD";
         default:
             return "UNKNOWN";
     }
 }
 #endif
 
-static ca_status_t growth_decode_ops(ca_growing_engine_t *engine,
-                                    size_t max_ops, size_t max_output_len,
-                                    mutation_plan_t *plan_out) {
-    if (!engine || !plan_out) return CA_STATUS_INVALID_ARGUMENT;
+// Number of op kinds the legacy uniform draw chooses from: length-preserving
+// mode stops before DELETE_RANGE and INSERT_BYTES. Integer ops are only drawn
+// through kind weights.
+static uint8_t grow_kind_span(const ca_growing_engine_t *engine) {
+    return (engine->flags & CA_ENGINE_FLAG_LENGTH_PRESERVING) ? 4u : 6u;
+}
 
-    if (mutation_plan_init(plan_out) != CA_STATUS_OK) {
-        return CA_STATUS_OUT_OF_MEMORY;
+// Whether kind index `k` may be drawn; length-preserving mode rules out deletes
+// and inserts. Splices stay allowed and only overwrite there.
+static bool grow_kind_allowed(const ca_growing_engine_t *engine, size_t k) {
+    return !(engine->flags & CA_ENGINE_FLAG_LENGTH_PRESERVING) || (k != 4u && k != 5u);
+}
+
+// AFL's interesting values: the 8-bit set, then the 16-bit and 32-bit additions.
+static const int32_t kGrowInteresting[] = {
+    -128, -1, 0, 1, 16, 32, 64, 100, 127,
+    -32768, -129, 128, 255, 256, 512, 1000, 1024, 4096, 32767,
+    INT32_MIN, -100663046, -32769, 32768, 65535, 65536, 100663045, INT32_MAX,
+};
+#define GROW_INTERESTING_16 19u
+
+// Decodes an integer op over the field at `candidate->op.pos`. The width comes
+// from channel 2 and shrinks to fit the input; the byte order is guessed from
+// which end of the field holds a zero byte (small values leave the high bytes
+// clear), falling back to channel 3.
+static void grow_decode_int(const ca_growing_engine_t *engine, ca_rng_t *rng,
+                            const growing_cell_t *cell, grow_candidate_t *candidate) {
+    static const uint8_t kWidths[3] = {2u, 4u, 8u};
+    uint32_t width = kWidths[cell->channels[2] % 3u];
+    while (width > engine->input_len) width >>= 1;
+    if (width < 2u) {
+        candidate->op.kind = CA_OP_ADD_BYTE;
+        candidate->op.arg = grow_u8(rng);
+        return;
     }
 
-    if (max_ops == 0) return CA_STATUS_OK;
-    if (engine->input_len == 0) {
-        if (max_output_len == 0) return CA_STATUS_SKIP;
-        uint8_t value = (uint8_t)grow_below((ca_growing_engine_t *)engine, 256u);
-        ca_status_t status =
-            mutation_plan_add_insert_bytes(plan_out, 0, &value, 1, 255, 0);
-        if (status != CA_STATUS_OK) {
-            mutation_plan_destroy(plan_out);
+    uint32_t pos = candidate->op.pos;
+    if ((size_t)pos + width > engine->input_len) {
+        pos = (uint32_t)(engine->input_len - width);
+    }
+    const uint8_t first = engine->input[pos];
+    const uint8_t last = engine->input[pos + width - 1u];
+    bool big_endian = (cell->channels[3] & 1u) != 0;
+    if (first == 0u && last != 0u) big_endian = true;
+    if (last == 0u && first != 0u) big_endian = false;
+
+    candidate->op.pos = pos;
+    candidate->op.len = width;
+    candidate->op.arg = big_endian ? CA_OP_INT_BIG_ENDIAN : 0u;
+    switch (grow_u8(rng) % 3u) {
+        case 0:
+            candidate->op.kind = CA_OP_ADD_INT;
+            candidate->op.data_offset = (uint32_t)grow_u32_range(rng, 34u) + 1u;
+            break;
+        case 1:
+            candidate->op.kind = CA_OP_SUB_INT;
+            candidate->op.data_offset = (uint32_t)grow_u32_range(rng, 34u) + 1u;
+            break;
+        default: {
+            const uint32_t count = width == 2u
+                                       ? GROW_INTERESTING_16
+                                       : (uint32_t)(sizeof(kGrowInteresting) /
+                                                    sizeof(*kGrowInteresting));
+            candidate->op.kind = CA_OP_SET_INT;
+            candidate->op.data_offset =
+                (uint32_t)kGrowInteresting[grow_u32_range(rng, count - 1u)];
+            break;
         }
-        return status;
     }
+    candidate->rank.score ^= (uint32_t)grow_u8(rng);
+}
 
-    mutation_op_t *candidates =
-        (mutation_op_t *)malloc(engine->cell_count * sizeof(*candidates));
-    if (!candidates) return CA_STATUS_OUT_OF_MEMORY;
+// Decodes a splice from the partner buffer for `cell`: of a few random add cells,
+// the one whose activity is closest to `cell`'s supplies the bytes, which overwrite
+// the cell or, when channel 4 says so and lengths may change, are inserted in front
+// of it. Falls back to a bit flip without a partner.
+static void grow_decode_splice(const ca_growing_engine_t *engine, ca_rng_t *rng,
+                               const growing_cell_t *cell, grow_candidate_t *candidate) {
+    const bool overwrite = (engine->flags & CA_ENGINE_FLAG_LENGTH_PRESERVING) ||
+                           (cell->channels[4] & 1u) != 0;
+    if (engine->add_cell_count == 0 || (overwrite && cell->filled == 0)) {
+        candidate->op.kind = CA_OP_BIT_FLIP;
+        candidate->op.arg = grow_u8(rng) & 7u;
+        return;
+    }
 
-    size_t candidate_count = 0;
-    for (size_t i = 0; i < engine->cell_count; ++i) {
-        const growing_cell_t *cell = &engine->cells[i];
-        uint32_t pos = (uint32_t)cell->position;
-        if (cell->filled > 0) {
-            pos += (uint32_t)grow_span_pos((ca_growing_engine_t *)engine, cell);
-            if (pos >= engine->input_len) {
-                pos = (uint32_t)(engine->input_len - 1u);
-            }
+    const growing_cell_t *best = NULL;
+    uint32_t best_distance = UINT32_MAX;
+    for (uint32_t probe = 0; probe < CA_GROW_SPLICE_PROBES; ++probe) {
+        const growing_cell_t *add =
+            &engine->add_cells[grow_u32_range(rng, engine->add_cell_count - 1u)];
+        uint32_t distance = add->activity > cell->activity
+                                ? (uint32_t)(add->activity - cell->activity)
+                                : (uint32_t)(cell->activity - add->activity);
+        if (distance < best_distance) {
+            best = add;
+            best_distance = distance;
         }
-    mutation_op_t candidate = (mutation_op_t){
-        .pos = pos,
-        .source_index = (uint32_t)i,
-        .score = (uint32_t)cell->activity,
-        .len = 1,
-        .arg = {
-            .insert = {
-                .data = NULL,
-                .data_len = 0,
-            },
-        },
-        .data_offset = 0,
-    };
+    }
+
+    size_t max_len = engine->add_buf_len - best->position;
+    if (overwrite) {
+        if (max_len > cell->filled) max_len = cell->filled;
+    } else if (max_len > 2u * (size_t)best->filled) {
+        max_len = 2u * (size_t)best->filled;
+    }
+    candidate->op.kind = overwrite ? CA_OP_OVERWRITE_FROM_ADD : CA_OP_INSERT_FROM_ADD;
+    candidate->op.pos = (uint32_t)cell->position;
+    candidate->op.data_offset = (uint32_t)best->position;
+    candidate->op.len = (uint32_t)(grow_u32_range(rng, max_len - 1u) + 1u);
+    candidate->rank.score ^= (uint32_t)grow_u8(rng);
+}
 
-        uint8_t kind_roll = grow_u8((ca_growing_engine_t *)engine) % 6u;
-        if (cell->filled == 0) {
-            kind_roll = 5u;
+// Builds the candidate op for cell `i`, drawing from `rng`.
+static void grow_decode_cell(const ca_growing_engine_t *engine, ca_rng_t *rng, size_t i,
+                             grow_candidate_t *candidate) {
+    const growing_cell_t *cell = &engine->cells[i];
+    uint32_t pos = (uint32_t)cell->position;
+    if (cell->filled > 0) {
+        pos += (uint32_t)grow_span_pos(rng, cell);
+        if (pos >= engine->input_len) {
+            pos = (uint32_t)(engine->input_len - 1u);
         }
+    }
+    *candidate = (grow_candidate_t){
+        .op = {.pos = pos, .len = 1},
+        .rank = {.score = (uint32_t)cell->activity, .source_index = (uint32_t)i},
+    };
 
-        switch (kind_roll) {
-            case 0: {
-                candidate.kind = CA_OP_BIT_FLIP;
-                candidate.arg.bit_flip.bit_index =
-                    grow_u8((ca_growing_engine_t *)engine) & 7u;
-                candidate.score ^= (uint32_t)grow_u8((ca_growing_engine_t *)engine);
-                break;
-            }
-            case 1:
-                candidate.kind = CA_OP_SET_BYTE;
-                candidate.arg.set_byte.value = grow_u8((ca_growing_engine_t *)engine);
-                candidate.score ^= (uint32_t)(cell->channels[0] ^ cell->channels[1]);
-                break;
-            case 2:
-                candidate.kind = CA_OP_ADD_BYTE;
-                candidate.arg.arithmetic.delta = grow_u8((ca_growing_engine_t *)engine);
-                candidate.score ^= (uint32_t)grow_u8((ca_growing_engine_t *)engine);
-                break;
-            case 3:
-                candidate.kind = CA_OP_SUB_BYTE;
-                candidate.arg.arithmetic.delta = grow_u8((ca_growing_engine_t *)engine);
-                candidate.score ^= (uint32_t)grow_u8((ca_growing_engine_t *)engine);
-                break;
-            case 4: {
-                candidate.kind = CA_OP_DELETE_RANGE;
-                if (cell->filled == 0u) {
-                    candidate.kind = CA_OP_BIT_FLIP;
-                    candidate.arg.bit_flip.bit_index =
-                        grow_u8((ca_growing_engine_t *)engine) & 7u;
-                    break;
-                }
-                size_t max_len = (size_t)cell->filled;
-                if (max_len > 8u) max_len = 8u;
-                candidate.len = (uint32_t)(grow_u32_range((ca_growing_engine_t *)engine, max_len - 1u) + 1u);
-                candidate.score ^= (uint32_t)candidate.len;
+    uint8_t kind_roll;
+    if (engine->kind_table_ready) {
+        uint32_t draw = grow_rng_below(rng, engine->kind_table.count * GROW_ALIAS_SCALE);
+        kind_roll = (uint8_t)grow_alias_pick(&engine->kind_table, draw);
+    } else {
+        kind_roll = grow_u8(rng) % grow_kind_span(engine);
+    }
+    if (cell->filled == 0 && !(engine->flags & CA_ENGINE_FLAG_LENGTH_PRESERVING)) {
+        kind_roll = 5u;
+    }
+
+    switch (kind_roll) {
+        case 0: {
+            candidate->op.kind = CA_OP_BIT_FLIP;
+            candidate->op.arg = grow_u8(rng) & 7u;
+            candidate->rank.score ^= (uint32_t)grow_u8(rng);
+            break;
+        }
+        case 1:
+            candidate->op.kind = CA_OP_SET_BYTE;
+            candidate->op.arg = grow_u8(rng);
+            candidate->rank.score ^= (uint32_t)(cell->channels[0] ^ cell->channels[1]);
+            break;
+        case 2:
+            candidate->op.kind = CA_OP_ADD_BYTE;
+            candidate->op.arg = grow_u8(rng);
+            candidate->rank.score ^= (uint32_t)grow_u8(rng);
+            break;
+        case 3:
+            candidate->op.kind = CA_OP_SUB_BYTE;
+            candidate->op.arg = grow_u8(rng);
+            candidate->rank.score ^= (uint32_t)grow_u8(rng);
+            break;
+        case 4: {
+            candidate->op.kind = CA_OP_DELETE_RANGE;
+            if (cell->filled == 0u) {
+                candidate->op.kind = CA_OP_BIT_FLIP;
+                candidate->op.arg = grow_u8(rng) & 7u;
                 break;
             }
-            case 5:
-            default:
-                candidate.kind = CA_OP_INSERT_BYTES;
-                candidate.len = (uint32_t)(grow_u32_range((ca_growing_engine_t *)engine, 2u) + 1u);
-                candidate.arg.insert.data_len = candidate.len;
-                candidate.score ^= (uint32_t)grow_u32_range((ca_growing_engine_t *)engine, 4u);
-                break;
+            size_t max_len = (size_t)cell->filled;
+            if (max_len > 8u) max_len = 8u;
+            candidate->op.len = (uint32_t)(grow_u32_range(rng, max_len - 1u) + 1u);
+            candidate->rank.score ^= (uint32_t)candidate->op.len;
+            break;
         }
+        case 6:
+            grow_decode_int(engine, rng, cell, candidate);
+            break;
+        case 7:
+            grow_decode_splice(engine, rng, cell, candidate);
+            break;
+        case 5:
+        default:
+            candidate->op.kind = CA_OP_INSERT_BYTES;
+            candidate->op.len = (uint32_t)(grow_u32_range(rng, 2u) + 1u);
+            candidate->rank.score ^= (uint32_t)grow_u32_range(rng, 4u);
+            break;
+    }
+}
 
-#ifdef CA_GROWING_DEBUG
-        ++engine->debug_raw_ops;
-#endif
-        if (is_noop_candidate(engine, &candidate)) {
-#ifdef CA_GROWING_DEBUG
-            ++engine->debug_rejected_ops;
-#endif
-            continue;
-        }
-#ifdef CA_GROWING_DEBUG
-        ++engine->debug_candidate_ops;
-#endif
-        candidates[candidate_count] = candidate;
-        ++candidate_count;
+typedef struct {
+    const ca_growing_engine_t *engine;
+    grow_candidate_t *candidates;
+    uint64_t seed;
+} grow_decode_job_t;
+
+static void grow_decode_chunk(void *context, size_t begin, size_t end) {
+    grow_decode_job_t *job = (grow_decode_job_t *)context;
+    for (size_t i = begin; i < end; ++i) {
+        uint64_t state = grow_cell_seed(job->seed, i);
+        ca_rng_t rng = {.below = grow_cell_below, .context = &state};
+        grow_decode_cell(job->engine, &rng, i, &job->candidates[i]);
     }
+}
 
+// Sorts candidates by score and appends the best `max_ops` to `plan_out`. Takes
+// ownership of `candidates`.
+static ca_status_t grow_emit_candidates(ca_growing_engine_t *engine,
+                                        grow_candidate_t *candidates, size_t candidate_count,
+                                        size_t max_ops, mutation_plan_t *plan_out) {
     if (candidate_count == 0) {
         free(candidates);
         return CA_STATUS_OK;
@@ -428,8 +1009,8 @@ static ca_status_t growth_decode_ops(ca_growing_engine_t *engine,
           by_activity_desc_score);
 
     for (size_t i = 0; i < candidate_count && i < max_ops; ++i) {
-        if (candidates[i].kind == CA_OP_INSERT_BYTES) {
-            uint32_t len = candidates[i].len;
+        if (candidates[i].op.kind == CA_OP_INSERT_BYTES) {
+            uint32_t len = candidates[i].op.len;
             if (len == 0u) len = 1u;
             uint8_t *bytes = (uint8_t *)malloc(len);
             if (!bytes) {
@@ -438,11 +1019,11 @@ static ca_status_t growth_decode_ops(ca_growing_engine_t *engine,
                 return CA_STATUS_OUT_OF_MEMORY;
             }
             for (uint32_t b = 0; b < len; ++b) {
-                bytes[b] = grow_u8((ca_growing_engine_t *)engine);
+                bytes[b] = (uint8_t)grow_below(engine, 256u);
             }
             ca_status_t st =
-                mutation_plan_add_insert_bytes(plan_out, candidates[i].pos, bytes, len,
-                                              candidates[i].score, candidates[i].source_index);
+                mutation_plan_add_insert_bytes(plan_out, candidates[i].op.pos, bytes, len,
+                                              candidates[i].rank.score, candidates[i].rank.source_index);
             free(bytes);
             if (st != CA_STATUS_OK) {
                 free(candidates);
@@ -452,11 +1033,37 @@ static ca_status_t growth_decode_ops(ca_growing_engine_t *engine,
             continue;
         }
 
-        if (candidates[i].kind == CA_OP_DELETE_RANGE) {
-            if (candidates[i].len == 0) continue;
+        if (candidates[i].op.kind == CA_OP_DELETE_RANGE) {
+            if (candidates[i].op.len == 0) continue;
             ca_status_t st = mutation_plan_add_delete_range(
-                plan_out, candidates[i].pos, candidates[i].len, candidates[i].score,
-                candidates[i].source_index);
+                plan_out, candidates[i].op.pos, candidates[i].op.len, candidates[i].rank.score,
+                candidates[i].rank.source_index);
+            if (st != CA_STATUS_OK) {
+                free(candidates);
+                mutation_plan_destroy(plan_out);
+                return st;
+            }
+            continue;
+        }
+
+        if (candidates[i].op.kind == CA_OP_BIT_FLIP) {
+            ca_status_t st = mutation_plan_add_bit_flip(plan_out, candidates[i].op.pos,
+                                                        candidates[i].op.arg,
+                                                        candidates[i].rank.score,
+                                                        candidates[i].rank.source_index);
+            if (st != CA_STATUS_OK) {
+                free(candidates);
+                mutation_plan_destroy(plan_out);
+                return st;
+            }
+            continue;
+        }
+
+        if (candidates[i].op.kind == CA_OP_SET_BYTE) {
+            ca_status_t st = mutation_plan_add_set_byte(plan_out, candidates[i].op.pos,
+                                                       candidates[i].op.arg,
+                                                       candidates[i].rank.score,
+                                                       candidates[i].rank.source_index);
             if (st != CA_STATUS_OK) {
                 free(candidates);
                 mutation_plan_destroy(plan_out);
@@ -465,11 +1072,11 @@ static ca_status_t growth_decode_ops(ca_growing_engine_t *engine,
             continue;
         }
 
-        if (candidates[i].kind == CA_OP_BIT_FLIP) {
-            ca_status_t st = mutation_plan_add_bit_flip(plan_out, candidates[i].pos,
-                                                        candidates[i].arg.bit_flip.bit_index,
-                                                        candidates[i].score,
-                                                        candidates[i].source_index);
+        if (candidates[i].op.kind == CA_OP_ADD_BYTE) {
+            ca_status_t st =
+                mutation_plan_add_add_byte(plan_out, candidates[i].op.pos,
+                                          (int8_t)candidates[i].op.arg,
+                                          candidates[i].rank.score, candidates[i].rank.source_index);
             if (st != CA_STATUS_OK) {
                 free(candidates);
                 mutation_plan_destroy(plan_out);
@@ -478,11 +1085,26 @@ static ca_status_t growth_decode_ops(ca_growing_engine_t *engine,
             continue;
         }
 
-        if (candidates[i].kind == CA_OP_SET_BYTE) {
-            ca_status_t st = mutation_plan_add_set_byte(plan_out, candidates[i].pos,
-                                                       candidates[i].arg.set_byte.value,
-                                                       candidates[i].score,
-                                                       candidates[i].source_index);
+        if (candidates[i].op.kind == CA_OP_ADD_INT || candidates[i].op.kind == CA_OP_SUB_INT ||
+            candidates[i].op.kind == CA_OP_SET_INT) {
+            const mutation_op_t *op = &candidates[i].op;
+            const uint8_t width = (uint8_t)op->len;
+            const bool big_endian = (op->arg & CA_OP_INT_BIG_ENDIAN) != 0;
+            ca_status_t st;
+            if (op->kind == CA_OP_ADD_INT) {
+                st = mutation_plan_add_add_int(plan_out, op->pos, width, big_endian,
+                                               op->data_offset, candidates[i].rank.score,
+                                               candidates[i].rank.source_index);
+            } else if (op->kind == CA_OP_SUB_INT) {
+                st = mutation_plan_add_sub_int(plan_out, op->pos, width, big_endian,
+                                               op->data_offset, candidates[i].rank.score,
+                                               candidates[i].rank.source_index);
+            } else {
+                st = mutation_plan_add_set_int(plan_out, op->pos, width, big_endian,
+                                               (int32_t)op->data_offset,
+                                               candidates[i].rank.score,
+                                               candidates[i].rank.source_index);
+            }
             if (st != CA_STATUS_OK) {
                 free(candidates);
                 mutation_plan_destroy(plan_out);
@@ -491,11 +1113,17 @@ static ca_status_t growth_decode_ops(ca_growing_engine_t *engine,
             continue;
         }
 
-        if (candidates[i].kind == CA_OP_ADD_BYTE) {
+        if (candidates[i].op.kind == CA_OP_INSERT_FROM_ADD ||
+            candidates[i].op.kind == CA_OP_OVERWRITE_FROM_ADD) {
+            const mutation_op_t *op = &candidates[i].op;
             ca_status_t st =
-                mutation_plan_add_add_byte(plan_out, candidates[i].pos,
-                                          (int8_t)candidates[i].arg.arithmetic.delta,
-                                          candidates[i].score, candidates[i].source_index);
+                op->kind == CA_OP_INSERT_FROM_ADD
+                    ? mutation_plan_add_insert_from_add(plan_out, op->pos, op->data_offset,
+                                                        op->len, candidates[i].rank.score,
+                                                        candidates[i].rank.source_index)
+                    : mutation_plan_add_overwrite_from_add(
+                          plan_out, op->pos, op->data_offset, op->len,
+                          candidates[i].rank.score, candidates[i].rank.source_index);
             if (st != CA_STATUS_OK) {
                 free(candidates);
                 mutation_plan_destroy(plan_out);
@@ -504,11 +1132,11 @@ static ca_status_t growth_decode_ops(ca_growing_engine_t *engine,
             continue;
         }
 
-        if (candidates[i].kind == CA_OP_SUB_BYTE) {
+        if (candidates[i].op.kind == CA_OP_SUB_BYTE) {
                 ca_status_t st =
-                mutation_plan_add_sub_byte(plan_out, candidates[i].pos,
-                                          (int8_t)candidates[i].arg.arithmetic.delta,
-                                          candidates[i].score, candidates[i].source_index);
+                mutation_plan_add_sub_byte(plan_out, candidates[i].op.pos,
+                                          (int8_t)candidates[i].op.arg,
+                                          candidates[i].rank.score, candidates[i].rank.source_index);
             if (st != CA_STATUS_OK) {
                 free(candidates);
                 mutation_plan_destroy(plan_out);
@@ -521,87 +1149,525 @@ static ca_status_t growth_decode_ops(ca_growing_engine_t *engine,
     return CA_STATUS_OK;
 }
 
+static uint64_t grow_below64(ca_growing_engine_t *engine, uint64_t limit) {
+    if (limit <= UINT32_MAX) return grow_below(engine, (uint32_t)limit);
+    uint64_t hi = grow_below(engine, UINT32_MAX);
+    return ((hi << 32) | grow_below(engine, UINT32_MAX)) % limit;
+}
+
+static uint32_t grow_position_weight(const ca_growing_engine_t *engine,
+                                     const growing_cell_t *cell) {
+    switch (engine->params.position_mode) {
+        case CA_GROW_POSITION_ACTIVITY:
+            return (uint32_t)cell->activity + 1u;
+        case CA_GROW_POSITION_ENTROPY:
+            return (uint32_t)cell->entropy + 1u;
+        case CA_GROW_POSITION_PRINTABLE:
+            return (uint32_t)cell->printable + 1u;
+        case CA_GROW_POSITION_EXTERNAL: {
+            uint64_t sum = 0;
+            size_t end = cell->position + cell->filled;
+            if (end > engine->external_weights_len) end = engine->external_weights_len;
+            for (size_t b = cell->position; b < end; ++b) {
+                sum += engine->external_weights[b];
+            }
+            return sum > UINT32_MAX ? UINT32_MAX : (uint32_t)sum;
+        }
+        default:
+            return 1u;
+    }
+}
+
+// Draws up to `max_ops` distinct cells in proportion to their position weights and
+// decodes one candidate per drawn cell. A drawn cell's weight is removed from the
+// tree, so each draw is O(log cell_count) and no full candidate sort is needed.
+static ca_status_t grow_sample_candidates(ca_growing_engine_t *engine, size_t max_ops,
+                                          grow_candidate_t *candidates, size_t *count_out) {
+    *count_out = 0;
+    if (engine->position_weights_capacity < engine->cell_count) {
+        uint32_t *weights = (uint32_t *)realloc(
+            engine->position_weights, engine->cell_count * sizeof(*weights));
+        if (!weights) return CA_STATUS_OUT_OF_MEMORY;
+        engine->position_weights = weights;
+        engine->position_weights_capacity = engine->cell_count;
+    }
+
+    uint32_t *weights = engine->position_weights;
+    bool any = false;
+    for (size_t i = 0; i < engine->cell_count; ++i) {
+        weights[i] = grow_position_weight(engine, &engine->cells[i]);
+        any = any || weights[i] != 0;
+    }
+    if (!any) {
+        for (size_t i = 0; i < engine->cell_count; ++i) weights[i] = 1u;
+    }
+
+    ca_status_t status =
+        grow_fenwick_build(&engine->position_tree, weights, engine->cell_count);
+    if (status != CA_STATUS_OK) return status;
+
+    ca_rng_t rng = grow_engine_rng(engine);
+    size_t count = 0;
+    for (size_t k = 0; k < max_ops && engine->position_tree.total > 0; ++k) {
+        size_t idx = grow_fenwick_find(&engine->position_tree,
+                                       grow_below64(engine, engine->position_tree.total));
+        grow_fenwick_remove(&engine->position_tree, idx, weights[idx]);
+
+        grow_candidate_t candidate;
+        grow_decode_cell(engine, &rng, idx, &candidate);
+#ifdef CA_GROWING_DEBUG
+        ++engine->debug_raw_ops;
+#endif
+        if (is_noop_candidate(engine, &candidate.op)) {
+#ifdef CA_GROWING_DEBUG
+            ++engine->debug_rejected_ops;
+#endif
+            continue;
+        }
+#ifdef CA_GROWING_DEBUG
+        ++engine->debug_candidate_ops;
+#endif
+        candidates[count++] = candidate;
+    }
+
+    *count_out = count;
+    return CA_STATUS_OK;
+}
+
+static ca_status_t growth_decode_ops(ca_growing_engine_t *engine,
+                                    size_t max_ops, size_t max_output_len,
+                                    mutation_plan_t *plan_out) {
+    if (!engine || !plan_out) return CA_STATUS_INVALID_ARGUMENT;
+
+    if (mutation_plan_init(plan_out) != CA_STATUS_OK) {
+        return CA_STATUS_OUT_OF_MEMORY;
+    }
+
+    if (max_ops == 0) return CA_STATUS_OK;
+    if (engine->input_len == 0) {
+        if (max_output_len == 0 || (engine->flags & CA_ENGINE_FLAG_LENGTH_PRESERVING)) {
+            return CA_STATUS_SKIP;
+        }
+        uint8_t value = (uint8_t)grow_below((ca_growing_engine_t *)engine, 256u);
+        ca_status_t status =
+            mutation_plan_add_insert_bytes(plan_out, 0, &value, 1, 255, 0);
+        if (status != CA_STATUS_OK) {
+            mutation_plan_destroy(plan_out);
+        }
+        return status;
+    }
+
+    if (engine->params.position_mode != CA_GROW_POSITION_CELL) {
+        grow_candidate_t *sampled = (grow_candidate_t *)malloc(max_ops * sizeof(*sampled));
+        if (!sampled) return CA_STATUS_OUT_OF_MEMORY;
+        size_t sampled_count = 0;
+        ca_status_t status = grow_sample_candidates(engine, max_ops, sampled, &sampled_count);
+        if (status != CA_STATUS_OK) {
+            free(sampled);
+            return status;
+        }
+        return grow_emit_candidates(engine, sampled, sampled_count, max_ops, plan_out);
+    }
+
+    grow_candidate_t *candidates =
+        (grow_candidate_t *)malloc(engine->cell_count * sizeof(*candidates));
+    if (!candidates) return CA_STATUS_OUT_OF_MEMORY;
+
+    grow_decode_job_t job = {.engine = engine, .candidates = candidates};
+    if (engine->derived_rng) {
+        job.seed = grow_draw_seed(engine);
+        grow_parallel_for(engine, engine->cell_count, grow_decode_chunk, &job);
+    } else {
+        ca_rng_t rng = grow_engine_rng(engine);
+        for (size_t i = 0; i < engine->cell_count; ++i) {
+            grow_decode_cell(engine, &rng, i, &candidates[i]);
+        }
+    }
+
+    size_t candidate_count = 0;
+    for (size_t i = 0; i < engine->cell_count; ++i) {
+        const grow_candidate_t candidate = candidates[i];
+#ifdef CA_GROWING_DEBUG
+        ++engine->debug_raw_ops;
+#endif
+        if (is_noop_candidate(engine, &candidate.op)) {
+#ifdef CA_GROWING_DEBUG
+            ++engine->debug_rejected_ops;
+#endif
+            continue;
+        }
+#ifdef CA_GROWING_DEBUG
+        ++engine->debug_candidate_ops;
+#endif
+        candidates[candidate_count] = candidate;
+        ++candidate_count;
+    }
+
+    return grow_emit_candidates(engine, candidates, candidate_count, max_ops, plan_out);
+}
+
 static ca_status_t ca_growing_destroy(void *impl) {
     ca_growing_engine_t *engine = (ca_growing_engine_t *)impl;
     if (!engine) return CA_STATUS_OK;
 
-    free(engine->input);
     mutation_plan_destroy(&engine->plan);
+    grow_pool_destroy(engine->pool);
+    grow_fenwick_free(&engine->position_tree);
+    free(engine->position_weights);
+    free(engine->external_weights);
+    free(engine->add_cells);
+    free(engine->trim_activity);
     free(engine->cells);
+    free(engine->encoded);
+    free(engine->block_hashes);
+    free(engine->encoded_input);
+    free(engine->active);
+    free(engine->active_next);
+    free(engine->active_stamp);
+    free(engine->pending);
+    free(engine->pending_index);
     free(engine);
     return CA_STATUS_OK;
 }
 
-static ca_status_t ca_growing_mutate(void *impl, const ca_mutate_request_t *request,
-                                    ca_output_t *output) {
+// Encodes the splice partner into `add_cells` with the session's block size, widened
+// until it needs at most CA_GROW_SPLICE_MAX_CELLS cells. Partner cells are only
+// looked up by activity, so they are not evolved.
+static ca_status_t grow_encode_add_cells(ca_growing_engine_t *engine) {
+    engine->add_cell_count = 0;
+    if (!engine->add_buf) return CA_STATUS_OK;
+
+    size_t block = engine->block_size;
+    size_t count = (engine->add_buf_len + block - 1u) / block;
+    while (count > CA_GROW_SPLICE_MAX_CELLS) {
+        block <<= 1;
+        count = (engine->add_buf_len + block - 1u) / block;
+    }
+    if (count > engine->add_cell_capacity) {
+        growing_cell_t *next =
+            (growing_cell_t *)realloc(engine->add_cells, count * sizeof(*next));
+        if (!next) return CA_STATUS_OUT_OF_MEMORY;
+        engine->add_cells = next;
+        engine->add_cell_capacity = count;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        size_t start = i * block;
+        size_t len = engine->add_buf_len - start;
+        if (len > block) len = block;
+        grow_encode_span(engine->add_buf, &engine->add_cells[i], start, len, i, 1u);
+    }
+    engine->add_cell_count = count;
+    return CA_STATUS_OK;
+}
+
+static uint32_t grow_draw_steps(ca_growing_engine_t *engine) {
+    const ca_growing_params_t *params = &engine->params;
+    return params->min_steps + grow_below(engine, params->max_steps - params->min_steps + 1u);
+}
+
+static ca_status_t grow_resize_cells(ca_growing_engine_t *engine, size_t count) {
+    growing_cell_t *next_cells =
+        (growing_cell_t *)realloc(engine->cells, count * sizeof(*engine->cells));
+    if (!next_cells) return CA_STATUS_OUT_OF_MEMORY;
+    engine->cells = next_cells;
+    engine->cell_count = count;
+    return CA_STATUS_OK;
+}
+
+// Full-resolution evolution: one cell per block over the whole input.
+static ca_status_t grow_evolve_cells(ca_growing_engine_t *engine, uint32_t *steps_out) {
+    bool resume = engine->lineage_valid && engine->cells &&
+                  engine->encoded_count == engine->cell_count;
+    engine->lineage_valid = false;
+
+    ca_status_t status = grow_resize_cells(engine, engine->cell_count);
+    if (status != CA_STATUS_OK) return status;
+
+    status = grow_encode_cells(engine);
+    if (status != CA_STATUS_OK) return status;
+
+    resume = resume && (engine->flags & CA_ENGINE_FLAG_LINEAGE) &&
+             engine->lineage_hash == engine->input_hash &&
+             engine->lineage_steps < CA_GROW_LINEAGE_MAX_STEPS;
+    if (!resume) {
+        memcpy(engine->cells, engine->encoded,
+               engine->cell_count * sizeof(*engine->cells));
+        engine->lineage_steps = 0;
+        engine->active_all = true;
+    }
+
+    uint32_t steps = grow_draw_steps(engine);
+    if (engine->flags & CA_ENGINE_FLAG_ACTIVE_SET) {
+        grow_step_active(engine, steps);
+    } else {
+        grow_step_cells(engine, steps);
+    }
+
+    if (engine->flags & CA_ENGINE_FLAG_LINEAGE) {
+        engine->lineage_valid = true;
+        engine->lineage_hash = engine->input_hash;
+        engine->lineage_steps += steps;
+    }
+
+    *steps_out = steps;
+    return CA_STATUS_OK;
+}
+
+// Keeps the `keep` most active cells of the current grid, returned in grid order.
+static size_t grow_pick_active(const ca_growing_engine_t *engine, size_t *picks,
+                              size_t keep) {
+    if (keep > engine->cell_count) keep = engine->cell_count;
+
+    for (size_t k = 0; k < keep; ++k) {
+        size_t best = engine->cell_count;
+        for (size_t j = 0; j < engine->cell_count; ++j) {
+            bool taken = false;
+            for (size_t t = 0; t < k && !taken; ++t) {
+                taken = (picks[t] == j);
+            }
+            if (taken) continue;
+            if (best == engine->cell_count ||
+                engine->cells[j].activity > engine->cells[best].activity) {
+                best = j;
+            }
+        }
+        picks[k] = best;
+    }
+
+    for (size_t k = 1; k < keep; ++k) {
+        size_t v = picks[k];
+        size_t t = k;
+        while (t > 0 && picks[t - 1] > v) {
+            picks[t] = picks[t - 1];
+            --t;
+        }
+        picks[t] = v;
+    }
+    return keep;
+}
+
+// Window evolution for large inputs: encodes `window_cells` blocks at a random offset
+// plus a halo of CA_GROW_WINDOW_HALO neighbours per step on each side, evolves that
+// grid, and keeps only the window for decoding. The grid wraps at its ends like the
+// full one, and each step carries the wrapped values at most CA_GROW_WINDOW_HALO
+// cells inward, so they never reach the window; at the ends of the input the halo
+// is cut short and the window wraps onto its own far side instead of the input's.
+// Cell positions stay absolute, so the decoded ops apply to the full input and
+// per-call cost does not depend on input size.
+static ca_status_t grow_evolve_window(ca_growing_engine_t *engine, uint32_t *steps_out) {
+    size_t total = engine->cell_count;
+    size_t window = engine->window_cells;
+    ca_rng_t rng = grow_engine_rng(engine);
+    size_t start = grow_u32_range(&rng, total - window);
+    uint32_t steps = grow_draw_steps(engine);
+    size_t halo = (size_t)steps * CA_GROW_WINDOW_HALO;
+    size_t lo = (start >= halo) ? (start - halo) : 0u;
+    size_t hi = (total - start - window > halo) ? (start + window + halo) : total;
+
+    // The grid no longer matches the full-input encoding, so there is nothing to
+    // resume afterwards.
+    engine->lineage_valid = false;
+
+    ca_status_t status = grow_resize_cells(engine, hi - lo);
+    if (status != CA_STATUS_OK) return status;
+    for (size_t j = 0; j < engine->cell_count; ++j) {
+        grow_encode_cell(engine, &engine->cells[j], lo + j);
+    }
+
+    grow_step_cells(engine, steps);
+
+    memmove(engine->cells, engine->cells + (start - lo), window * sizeof(*engine->cells));
+    engine->cell_count = window;
+
+    *steps_out = steps;
+    return CA_STATUS_OK;
+}
+
+// Multi-resolution evolution for large inputs. The coarsest level covers the whole
+// input with at most CA_GROW_PYRAMID_TOP_CELLS cells; every level keeps its
+// CA_GROW_PYRAMID_KEEP most active cells and expands them into their children one
+// level finer, down to `block_size` blocks that growth_decode_ops turns into
+// ops. Coarse cells are encoded from at most CA_GROW_PYRAMID_SAMPLES bytes, so the
+// work per level does not depend on input size and the number of levels grows with
+// log16(input_len).
+static ca_status_t grow_evolve_pyramid(ca_growing_engine_t *engine, uint32_t *steps_out) {
+    const size_t fanout = (size_t)1u << CA_GROW_PYRAMID_FANOUT_SHIFT;
+    const size_t input_len = engine->input_len;
+
+    const size_t base = engine->block_size;
+    size_t block = base;
+    while ((input_len + block - 1u) / block > CA_GROW_PYRAMID_TOP_CELLS) {
+        block <<= CA_GROW_PYRAMID_FANOUT_SHIFT;
+    }
+    size_t count = (input_len + block - 1u) / block;
+
+    size_t capacity = CA_GROW_PYRAMID_KEEP * fanout;
+    if (capacity < count) capacity = count;
+    size_t *blocks = (size_t *)malloc(capacity * sizeof(*blocks));
+    size_t *next_blocks = (size_t *)malloc(capacity * sizeof(*next_blocks));
+    if (!blocks || !next_blocks) {
+        free(blocks);
+        free(next_blocks);
+        return CA_STATUS_OUT_OF_MEMORY;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        blocks[i] = i;
+    }
+
+    // The level grids reuse `cells`, so there is no lineage to resume afterwards.
+    engine->lineage_valid = false;
+
+    uint32_t steps = grow_draw_steps(engine);
+    ca_status_t status = CA_STATUS_OK;
+    for (;;) {
+        status = grow_resize_cells(engine, count);
+        if (status != CA_STATUS_OK) break;
+        engine->block_size = block;
+
+        for (size_t j = 0; j < count; ++j) {
+            size_t start = blocks[j] * block;
+            size_t len = input_len - start;
+            if (len > block) len = block;
+            size_t stride = 1u;
+            if (len > CA_GROW_PYRAMID_SAMPLES) stride = len / CA_GROW_PYRAMID_SAMPLES;
+            grow_encode_span(engine->input, &engine->cells[j], start, len, blocks[j],
+                             stride);
+        }
+        grow_step_cells(engine, steps);
+
+        if (block == base) break;
+
+        size_t picks[CA_GROW_PYRAMID_KEEP];
+        size_t keep = grow_pick_active(engine, picks, CA_GROW_PYRAMID_KEEP);
+
+        size_t child_block = block >> CA_GROW_PYRAMID_FANOUT_SHIFT;
+        size_t child_total = (input_len + child_block - 1u) / child_block;
+        size_t next_count = 0;
+        for (size_t k = 0; k < keep; ++k) {
+            size_t first = blocks[picks[k]] << CA_GROW_PYRAMID_FANOUT_SHIFT;
+            for (size_t c = 0; c < fanout && first + c < child_total; ++c) {
+                next_blocks[next_count++] = first + c;
+            }
+        }
+
+        size_t *tmp = blocks;
+        blocks = next_blocks;
+        next_blocks = tmp;
+        count = next_count;
+        block = child_block;
+    }
+
+    free(blocks);
+    free(next_blocks);
+    if (status != CA_STATUS_OK) return status;
+
+    *steps_out = steps;
+    return CA_STATUS_OK;
+}
+
+// Encodes and evolves the cells for `request`; every following ca_growing_next
+// decodes a fresh plan from that state without evolving again.
+static ca_status_t ca_growing_begin(void *impl, const ca_mutate_request_t *request) {
     ca_growing_engine_t *engine = (ca_growing_engine_t *)impl;
-    if (!engine || !request || !output) return CA_STATUS_INVALID_ARGUMENT;
+    if (!engine || !request) return CA_STATUS_INVALID_ARGUMENT;
     if (!request->input && request->input_len != 0) return CA_STATUS_INVALID_ARGUMENT;
 
     ca_growing_reset_state(engine);
+    engine->session_status = CA_STATUS_INVALID_ARGUMENT;
     if (request->max_output_len == 0) {
+        engine->session_status = CA_STATUS_SKIP;
         return CA_STATUS_SKIP;
     }
 
+    engine->input = request->input;
     engine->input_len = request->input_len;
-    if (request->input_len > 0) {
-        uint8_t *next_input = (uint8_t *)realloc(engine->input, request->input_len);
-        if (!next_input) return CA_STATUS_OUT_OF_MEMORY;
-        engine->input = next_input;
-        memcpy(engine->input, request->input, request->input_len);
-    } else {
-        free(engine->input);
-        engine->input = NULL;
+    engine->add_buf = NULL;
+    engine->add_buf_len = 0;
+    if (request->add_buf && request->add_buf_len > 0 &&
+        engine->params.kind_weights[CA_GROWING_KIND_COUNT - 1u] != 0) {
+        engine->add_buf = request->add_buf;
+        engine->add_buf_len = request->add_buf_len;
     }
 
-    engine->block_size = CA_GROW_BLOCK_SIZE;
+    engine->block_size = engine->params.block_size;
     engine->cell_count =
         (request->input_len + engine->block_size - 1u) / engine->block_size;
+    while (engine->params.max_cells > 0 && engine->cell_count > engine->params.max_cells) {
+        engine->block_size <<= 1;
+        engine->cell_count =
+            (request->input_len + engine->block_size - 1u) / engine->block_size;
+    }
 
     if (engine->cell_count == 0) {
         engine->cell_count = 1;
     }
 
-    free(engine->cells);
-    engine->cells =
-        (growing_cell_t *)calloc(engine->cell_count, sizeof(*engine->cells));
-    if (!engine->cells) return CA_STATUS_OUT_OF_MEMORY;
-
-    for (size_t i = 0; i < engine->cell_count; ++i) {
-        grow_encode_cell(engine, &engine->cells[i], i);
+    size_t max_ops = 1u + (engine->cell_count / engine->params.max_ops_divisor);
+    if (max_ops > engine->params.max_ops_cap) max_ops = engine->params.max_ops_cap;
+
+    uint32_t steps = 0;
+    ca_status_t evolve_status;
+    if (engine->window_min_input > 0 && request->input_len >= engine->window_min_input &&
+        engine->cell_count > engine->window_cells) {
+        evolve_status = grow_evolve_window(engine, &steps);
+    } else if ((engine->flags & CA_ENGINE_FLAG_PYRAMID) &&
+               request->input_len >= CA_GROW_PYRAMID_MIN_INPUT) {
+        evolve_status = grow_evolve_pyramid(engine, &steps);
+    } else {
+        evolve_status = grow_evolve_cells(engine, &steps);
     }
+    if (evolve_status != CA_STATUS_OK) return evolve_status;
+    ca_status_t add_status = grow_encode_add_cells(engine);
+    if (add_status != CA_STATUS_OK) return add_status;
+
+    engine->session_status = CA_STATUS_OK;
+    engine->session_max_ops = max_ops;
+    engine->session_max_output_len = request->max_output_len;
+    engine->session_mutation_id = request->mutation_id;
+#ifdef CA_GROWING_DEBUG
+    engine->debug_steps = (size_t)steps;
+    engine->debug_cell_count = engine->cell_count;
+#else
+    (void)steps;
+#endif
+    return CA_STATUS_OK;
+}
 
-    uint32_t steps = 1u + grow_below(engine, 5u);
-    grow_step_cells(engine, steps);
+static ca_status_t ca_growing_next(void *impl, ca_output_t *output) {
+    ca_growing_engine_t *engine = (ca_growing_engine_t *)impl;
+    if (!engine || !output) return CA_STATUS_INVALID_ARGUMENT;
+    if (engine->session_status != CA_STATUS_OK) return engine->session_status;
 
-    size_t max_ops = 1u + (engine->cell_count / 64u);
-    if (max_ops > 8u) max_ops = 8u;
+    mutation_plan_destroy(&engine->plan);
+    const size_t max_ops = engine->session_max_ops;
 
 #ifdef CA_GROWING_DEBUG
     engine->debug_raw_ops = 0;
     engine->debug_candidate_ops = 0;
     engine->debug_rejected_ops = 0;
-    engine->debug_steps = (size_t)steps;
-    engine->debug_cell_count = engine->cell_count;
-    engine->debug_mutation_id = request->mutation_id;
+    engine->debug_accepted_ops = 0;
+    engine->debug_mutation_id = engine->session_mutation_id;
     engine->debug_removed_inserts = 0;
     engine->debug_conflicts = 0;
     engine->debug_output_hash = 0;
-    engine->debug_input_hash = grow_hash64(request->input, request->input_len);
+    engine->debug_input_hash = grow_hash64(engine->input, engine->input_len);
 #endif
 
     mutation_plan_t source_plan = {0};
-    ca_status_t decode_status =
-        growth_decode_ops(engine, max_ops, request->max_output_len, &source_plan);
+    ca_status_t decode_status = growth_decode_ops(
+        engine, max_ops, engine->session_max_output_len, &source_plan);
     if (decode_status != CA_STATUS_OK) {
         return decode_status;
     }
 
     ca_plan_limits_t limits = {
         .max_ops = max_ops,
-        .max_output_len = request->max_output_len,
-        .input_len = request->input_len,
-        .input = request->input,
+        .max_output_len = engine->session_max_output_len,
+        .input_len = engine->input_len,
+        .input = engine->input,
+        .add_buf = engine->add_buf,
+        .add_buf_len = engine->add_buf_len,
     };
 
     normalized_plan_t normalized = {0};
@@ -623,30 +1689,33 @@ static ca_status_t ca_growing_mutate(void *impl, const ca_mutate_request_t *requ
         mutation_op_t *op = &normalized.ops[i];
         fprintf(stderr,
                 "[growing] op#%zu kind=%s pos=%u len=%u score=%u src=%u",
-                i, grow_op_name(op->kind), op->pos, op->len, op->score,
-                op->source_index);
+                i, grow_op_name((mutation_op_kind_t)op->kind), op->pos, op->len,
+                normalized.ranks[i].score, normalized.ranks[i].source_index);
         if (op->kind == CA_OP_INSERT_BYTES) {
-            fprintf(stderr, " ins_len=%zu", (size_t)op->arg.insert.data_len);
+            fprintf(stderr, " ins_off=%u", op->data_offset);
         }
         fprintf(stderr, "\n");
     }
 #endif
 
     engine->plan.ops = normalized.ops;
+    engine->plan.ranks = normalized.ranks;
     engine->plan.op_count = normalized.op_count;
     engine->plan.extra_bytes = normalized.extra_bytes;
     engine->plan.extra_bytes_len = normalized.extra_bytes_len;
+    engine->plan.add_buf = normalized.add_buf;
+    engine->plan.add_buf_len = normalized.add_buf_len;
 
 #ifdef CA_GROWING_DEBUG
-    engine->debug_input_hash = grow_hash64(request->input, request->input_len);
     fprintf(stderr,
             "[growing] mutation=%" PRIu64
             " input_len=%zu steps=%zu cells=%zu raw=%zu candidate=%zu rejected=%zu accepted=%zu input_hash=%016" PRIx64
-            " rng_calls=%zu\n",
-            (uint64_t)request->mutation_id, request->input_len, engine->debug_steps,
+            " rng_calls=%zu reencoded=%zu active_updates=%zu\n",
+            engine->session_mutation_id, engine->input_len, engine->debug_steps,
             engine->debug_cell_count, engine->debug_raw_ops, engine->debug_candidate_ops,
             engine->debug_rejected_ops, engine->debug_accepted_ops, engine->debug_input_hash,
-            engine->debug_rng_calls);
+            engine->debug_rng_calls, engine->debug_reencoded_cells,
+            engine->debug_active_updates);
 #endif
 
     output->kind = CA_OUTPUT_PLAN;
@@ -654,18 +1723,91 @@ static ca_status_t ca_growing_mutate(void *impl, const ca_mutate_request_t *requ
     return CA_STATUS_OK;
 }
 
+static ca_status_t ca_growing_mutate(void *impl, const ca_mutate_request_t *request,
+                                    ca_output_t *output) {
+    if (!impl || !request || !output) return CA_STATUS_INVALID_ARGUMENT;
+    ca_status_t status = ca_growing_begin(impl, request);
+    if (status != CA_STATUS_OK) return status;
+    return ca_growing_next(impl, output);
+}
+
+// Applies the plan ca_growing_next normalized straight into `dst`, without going
+// through a second normalize.
+static ca_status_t ca_growing_mutate_into(void *impl, const ca_mutate_request_t *request,
+                                         uint8_t *dst, size_t dst_cap, size_t *out_len) {
+    ca_output_t output = {0};
+    ca_status_t status = ca_growing_mutate(impl, request, &output);
+    if (status != CA_STATUS_OK) return status;
+    return ca_engine_plan_into(output.value.plan, request, dst, dst_cap, out_len);
+}
+
+static ca_status_t grow_build_kind_table(ca_growing_engine_t *engine,
+                                         const uint32_t *weights) {
+    uint32_t effective[CA_GROWING_KIND_COUNT];
+    bool any = false;
+    for (size_t k = 0; k < CA_GROWING_KIND_COUNT; ++k) {
+        effective[k] = grow_kind_allowed(engine, k) ? weights[k] : 0u;
+        any = any || effective[k] != 0;
+    }
+    engine->kind_table_ready = false;
+    if (!any) return CA_STATUS_OK;
+
+    // Trailing zero weights for the integer and splice kinds are left out of the
+    // table, so weight sets that predate them keep drawing exactly as before.
+    size_t count = CA_GROWING_KIND_COUNT;
+    while (count > CA_GROWING_BASE_KIND_COUNT && effective[count - 1u] == 0) --count;
+    ca_status_t status = grow_alias_build(&engine->kind_table, effective, count);
+    engine->kind_table_ready = (status == CA_STATUS_OK);
+    return status;
+}
+
 ca_status_t ca_engine_create_growing_impl(const ca_engine_config_t *config, ca_rng_t rng,
                                          ca_engine_t **engine) {
     if (!engine || !rng.below) return CA_STATUS_INVALID_ARGUMENT;
-    (void)config;
+
+    ca_growing_params_t params;
+    ca_growing_params_init(&params);
+    if (config && config->growing_params) {
+        params = *config->growing_params;
+        if (params.version != CA_GROWING_PARAMS_VERSION || params.block_size == 0 ||
+            params.max_steps < params.min_steps || params.update_percent > 100u ||
+            params.max_ops_divisor == 0 || params.max_ops_cap == 0 ||
+            params.position_mode > CA_GROW_POSITION_EXTERNAL) {
+            return CA_STATUS_INVALID_ARGUMENT;
+        }
+    }
 
     ca_growing_engine_t *impl = (ca_growing_engine_t *)calloc(1, sizeof(*impl));
     if (!impl) return CA_STATUS_OUT_OF_MEMORY;
     impl->rng = rng;
-    impl->block_size = CA_GROW_BLOCK_SIZE;
+    impl->params = params;
+    impl->session_status = CA_STATUS_INVALID_ARGUMENT;
+    impl->flags = config ? config->flags : 0u;
+    ca_status_t kind_status = grow_build_kind_table(impl, params.kind_weights);
+    if (kind_status != CA_STATUS_OK) {
+        free(impl);
+        return kind_status;
+    }
+    if (config && config->worker_threads > 0) {
+        impl->derived_rng = true;
+        if (config->worker_threads > 1) {
+            ca_status_t status = grow_pool_create(config->worker_threads, &impl->pool);
+            if (status != CA_STATUS_OK) {
+                free(impl);
+                return status;
+            }
+        }
+    }
+    impl->block_size = params.block_size;
+    if (config && config->window_min_input > 0) {
+        impl->window_min_input = config->window_min_input;
+        impl->window_cells =
+            config->window_cells ? config->window_cells : CA_GROW_WINDOW_DEFAULT_CELLS;
+    }
 
     ca_engine_t *base = (ca_engine_t *)calloc(1, sizeof(*base));
     if (!base) {
+        grow_pool_destroy(impl->pool);
         free(impl);
         return CA_STATUS_OUT_OF_MEMORY;
     }
@@ -675,6 +1817,97 @@ ca_status_t ca_engine_create_growing_impl(const ca_engine_config_t *config, ca_r
     base->output_kind = CA_OUTPUT_PLAN;
     base->destroy = ca_growing_destroy;
     base->mutate = ca_growing_mutate;
+    base->begin = ca_growing_begin;
+    base->next = ca_growing_next;
+    base->mutate_into = ca_growing_mutate_into;
     *engine = base;
     return CA_STATUS_OK;
 }
+
+ca_status_t ca_growing_set_position_weights(ca_engine_t *engine, const uint32_t *weights,
+                                            size_t count) {
+    if (!engine || engine->mutate != ca_growing_mutate || (!weights && count != 0)) {
+        return CA_STATUS_INVALID_ARGUMENT;
+    }
+    ca_growing_engine_t *impl = (ca_growing_engine_t *)engine->impl;
+
+    uint32_t *copy = NULL;
+    if (count > 0) {
+        copy = (uint32_t *)malloc(count * sizeof(*copy));
+        if (!copy) return CA_STATUS_OUT_OF_MEMORY;
+        memcpy(copy, weights, count * sizeof(*copy));
+    }
+
+    free(impl->external_weights);
+    impl->external_weights = copy;
+    impl->external_weights_len = count;
+    return CA_STATUS_OK;
+}
+
+ca_status_t ca_growing_set_kind_weights(ca_engine_t *engine, const uint32_t *weights,
+                                        size_t count) {
+    if (!engine || engine->mutate != ca_growing_mutate || (!weights && count != 0) ||
+        count > CA_GROWING_KIND_COUNT) {
+        return CA_STATUS_INVALID_ARGUMENT;
+    }
+    ca_growing_engine_t *impl = (ca_growing_engine_t *)engine->impl;
+
+    uint32_t next[CA_GROWING_MAX_KINDS] = {0};
+    if (count > 0) memcpy(next, weights, count * sizeof(*next));
+    ca_status_t status = grow_build_kind_table(impl, next);
+    if (status != CA_STATUS_OK) return status;
+    memcpy(impl->params.kind_weights, next, sizeof(next));
+    return CA_STATUS_OK;
+}
+
+ca_status_t ca_growing_cell_activity(ca_engine_t *engine, const uint8_t *input,
+                                     size_t input_len, const uint8_t **activity,
+                                     size_t *cell_count, size_t *block_size) {
+    if (!engine || engine->mutate != ca_growing_mutate || (!input && input_len != 0) ||
+        !activity || !cell_count || !block_size) {
+        return CA_STATUS_INVALID_ARGUMENT;
+    }
+    ca_growing_engine_t *impl = (ca_growing_engine_t *)engine->impl;
+
+    // The grid is rebuilt for `input`, so neither the open session nor the lineage
+    // state survives.
+    ca_growing_reset_state(impl);
+    impl->session_status = CA_STATUS_INVALID_ARGUMENT;
+    impl->lineage_valid = false;
+    impl->input = input;
+    impl->input_len = input_len;
+    impl->add_buf = NULL;
+    impl->add_buf_len = 0;
+
+    size_t block = impl->params.block_size;
+    size_t count = (input_len + block - 1u) / block;
+    while (count > CA_GROWING_TRIM_MAX_CELLS) {
+        block <<= 1;
+        count = (input_len + block - 1u) / block;
+    }
+    *activity = NULL;
+    *cell_count = 0;
+    *block_size = block;
+    if (count == 0) return CA_STATUS_OK;
+
+    if (count > impl->trim_activity_capacity) {
+        uint8_t *next = (uint8_t *)realloc(impl->trim_activity, count);
+        if (!next) return CA_STATUS_OUT_OF_MEMORY;
+        impl->trim_activity = next;
+        impl->trim_activity_capacity = count;
+    }
+    impl->block_size = block;
+    ca_status_t status = grow_resize_cells(impl, count);
+    if (status != CA_STATUS_OK) return status;
+    for (size_t i = 0; i < count; ++i) {
+        grow_encode_cell(impl, &impl->cells[i], i);
+    }
+    grow_step_cells(impl, grow_draw_steps(impl));
+
+    for (size_t i = 0; i < count; ++i) {
+        impl->trim_activity[i] = impl->cells[i].activity;
+    }
+    *activity = impl->trim_activity;
+    *cell_count = count;
+    return CA_STATUS_OK;
+}
@@ -5,6 +5,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 static bool size_add_overflow(size_t a, size_t b, size_t *result) {
     if (result == NULL) return true;
     if (a > SIZE_MAX - b) return true;
@@ -19,50 +23,58 @@ static bool size_sub_underflow(size_t a, size_t b, size_t *result) {
     return false;
 }
 
-static ca_status_t append_to_plan(mutation_plan_t *plan, const mutation_plan_t *source,
-                                 const mutation_op_t *op) {
-    if (!plan || !source || !op) return CA_STATUS_INVALID_ARGUMENT;
-
-    mutation_op_t copy = *op;
-    copy.arg.insert.data = NULL;
-    copy.data_offset = 0;
-
-    if (op->kind == CA_OP_INSERT_BYTES) {
-        size_t data_len = op->arg.insert.data_len;
-        if (data_len == 0 || data_len != op->len) return CA_STATUS_INVALID_ARGUMENT;
+_Static_assert(sizeof(mutation_op_t) == 16, "mutation_op_t must stay packed");
 
-        const uint8_t *src_data = op->arg.insert.data;
-        const uint8_t *source_payload = source->extra_bytes;
-        if (source_payload != NULL && source->extra_bytes_len != 0 &&
-            op->data_offset <= source->extra_bytes_len &&
-            data_len <= source->extra_bytes_len - op->data_offset &&
-            src_data == source_payload + op->data_offset) {
-            src_data = source_payload + op->data_offset;
-        }
+// Bytes an op keeps in `extra_bytes`: an insert's payload or an XOR key.
+static uint32_t op_payload_len(const mutation_op_t *op) {
+    if (op->kind == CA_OP_INSERT_BYTES) return op->len;
+    if (op->kind == CA_OP_XOR_RANGE) return op->arg;
+    return 0;
+}
 
-        if (!src_data) return CA_STATUS_INVALID_ARGUMENT;
+// Appends `op` with its rank; for inserts and XOR ranges, `payload` holds the
+// payload or key bytes copied into the plan's arena.
+static ca_status_t append_to_plan(mutation_plan_t *plan, mutation_op_t op,
+                                  mutation_op_rank_t rank, const uint8_t *payload) {
+    if (!plan) return CA_STATUS_INVALID_ARGUMENT;
 
-        size_t new_len = 0;
-        if (size_add_overflow(plan->extra_bytes_len, data_len, &new_len)) {
+    // Copy and splice ops keep their source position in `data_offset`, integer ops
+    // their delta or value.
+    if (op.kind != CA_OP_COPY_RANGE && op.kind != CA_OP_ADD_INT &&
+        op.kind != CA_OP_SUB_INT && op.kind != CA_OP_SET_INT &&
+        op.kind != CA_OP_INSERT_FROM_ADD && op.kind != CA_OP_OVERWRITE_FROM_ADD) {
+        op.data_offset = 0;
+    }
+    op.reserved = 0;
+    const uint32_t payload_len = op_payload_len(&op);
+    if (op.kind == CA_OP_INSERT_BYTES || op.kind == CA_OP_XOR_RANGE) {
+        if (payload_len == 0 || !payload) return CA_STATUS_INVALID_ARGUMENT;
+        if (plan->extra_bytes_len > UINT32_MAX - payload_len) {
             return CA_STATUS_OUT_OF_MEMORY;
         }
 
+        size_t new_len = plan->extra_bytes_len + payload_len;
         uint8_t *new_extra = (uint8_t *)realloc(plan->extra_bytes, new_len);
-        if (!new_extra && new_len != 0) return CA_STATUS_OUT_OF_MEMORY;
-
-        memcpy(new_extra + plan->extra_bytes_len, src_data, data_len);
+        if (!new_extra) return CA_STATUS_OUT_OF_MEMORY;
         plan->extra_bytes = new_extra;
-        copy.data_offset = plan->extra_bytes_len;
-        copy.arg.insert.data = new_extra + copy.data_offset;
+
+        memcpy(new_extra + plan->extra_bytes_len, payload, payload_len);
+        op.data_offset = (uint32_t)plan->extra_bytes_len;
         plan->extra_bytes_len = new_len;
     }
 
-    mutation_op_t *new_ops =
-        (mutation_op_t *)realloc(plan->ops, (plan->op_count + 1) * sizeof(*plan->ops));
-    if (!new_ops && (plan->op_count + 1) != 0) return CA_STATUS_OUT_OF_MEMORY;
-
+    size_t count = plan->op_count + 1;
+    mutation_op_t *new_ops = (mutation_op_t *)realloc(plan->ops, count * sizeof(*plan->ops));
+    if (!new_ops) return CA_STATUS_OUT_OF_MEMORY;
     plan->ops = new_ops;
-    plan->ops[plan->op_count++] = copy;
+    mutation_op_rank_t *new_ranks =
+        (mutation_op_rank_t *)realloc(plan->ranks, count * sizeof(*plan->ranks));
+    if (!new_ranks) return CA_STATUS_OUT_OF_MEMORY;
+    plan->ranks = new_ranks;
+
+    plan->ops[plan->op_count] = op;
+    plan->ranks[plan->op_count] = rank;
+    plan->op_count = count;
     return CA_STATUS_OK;
 }
 
@@ -70,20 +82,27 @@ ca_status_t mutation_plan_init(mutation_plan_t *plan) {
     if (!plan) return CA_STATUS_INVALID_ARGUMENT;
 
     plan->ops = NULL;
+    plan->ranks = NULL;
     plan->op_count = 0;
     plan->extra_bytes = NULL;
     plan->extra_bytes_len = 0;
+    plan->add_buf = NULL;
+    plan->add_buf_len = 0;
     return CA_STATUS_OK;
 }
 
 void mutation_plan_destroy(mutation_plan_t *plan) {
     if (!plan) return;
     free(plan->ops);
+    free(plan->ranks);
     free(plan->extra_bytes);
     plan->ops = NULL;
+    plan->ranks = NULL;
     plan->extra_bytes = NULL;
     plan->op_count = 0;
     plan->extra_bytes_len = 0;
+    plan->add_buf = NULL;
+    plan->add_buf_len = 0;
 }
 
 ca_status_t mutation_plan_add_bit_flip(mutation_plan_t *plan, uint32_t pos,
@@ -95,15 +114,10 @@ ca_status_t mutation_plan_add_bit_flip(mutation_plan_t *plan, uint32_t pos,
         .kind = CA_OP_BIT_FLIP,
         .pos = pos,
         .len = 1,
-        .arg = {
-            .bit_flip = {
-                .bit_index = (uint8_t)(bit_index & 7u),
-            },
-        },
-        .score = score,
-        .source_index = source_index,
+        .arg = (uint8_t)(bit_index & 7u),
     };
-    return append_to_plan(plan, plan, &op);
+    mutation_op_rank_t rank = {.score = score, .source_index = source_index};
+    return append_to_plan(plan, op, rank, NULL);
 }
 
 ca_status_t mutation_plan_add_set_byte(mutation_plan_t *plan, uint32_t pos,
@@ -115,15 +129,10 @@ ca_status_t mutation_plan_add_set_byte(mutation_plan_t *plan, uint32_t pos,
         .kind = CA_OP_SET_BYTE,
         .pos = pos,
         .len = 1,
-        .arg = {
-            .set_byte = {
-                .value = value,
-            },
-        },
-        .score = score,
-        .source_index = source_index,
+        .arg = value,
     };
-    return append_to_plan(plan, plan, &op);
+    mutation_op_rank_t rank = {.score = score, .source_index = source_index};
+    return append_to_plan(plan, op, rank, NULL);
 }
 
 ca_status_t mutation_plan_add_add_byte(mutation_plan_t *plan, uint32_t pos,
@@ -135,15 +144,10 @@ ca_status_t mutation_plan_add_add_byte(mutation_plan_t *plan, uint32_t pos,
         .kind = CA_OP_ADD_BYTE,
         .pos = pos,
         .len = 1,
-        .arg = {
-            .arithmetic = {
-                .delta = (uint8_t)delta,
-            },
-        },
-        .score = score,
-        .source_index = source_index,
+        .arg = (uint8_t)delta,
     };
-    return append_to_plan(plan, plan, &op);
+    mutation_op_rank_t rank = {.score = score, .source_index = source_index};
+    return append_to_plan(plan, op, rank, NULL);
 }
 
 ca_status_t mutation_plan_add_sub_byte(mutation_plan_t *plan, uint32_t pos,
@@ -155,15 +159,10 @@ ca_status_t mutation_plan_add_sub_byte(mutation_plan_t *plan, uint32_t pos,
         .kind = CA_OP_SUB_BYTE,
         .pos = pos,
         .len = 1,
-        .arg = {
-            .arithmetic = {
-                .delta = (uint8_t)delta,
-            },
-        },
-        .score = score,
-        .source_index = source_index,
+        .arg = (uint8_t)delta,
     };
-    return append_to_plan(plan, plan, &op);
+    mutation_op_rank_t rank = {.score = score, .source_index = source_index};
+    return append_to_plan(plan, op, rank, NULL);
 }
 
 ca_status_t mutation_plan_add_delete_range(mutation_plan_t *plan, uint32_t pos,
@@ -175,10 +174,9 @@ ca_status_t mutation_plan_add_delete_range(mutation_plan_t *plan, uint32_t pos,
         .kind = CA_OP_DELETE_RANGE,
         .pos = pos,
         .len = len,
-        .score = score,
-        .source_index = source_index,
     };
-    return append_to_plan(plan, plan, &op);
+    mutation_op_rank_t rank = {.score = score, .source_index = source_index};
+    return append_to_plan(plan, op, rank, NULL);
 }
 
 ca_status_t mutation_plan_add_insert_bytes(mutation_plan_t *plan, uint32_t pos,
@@ -190,27 +188,137 @@ ca_status_t mutation_plan_add_insert_bytes(mutation_plan_t *plan, uint32_t pos,
         .kind = CA_OP_INSERT_BYTES,
         .pos = pos,
         .len = len,
-        .arg = {
-            .insert = {
-                .data = data,
-                .data_len = len,
-            },
-        },
-        .score = score,
-        .source_index = source_index,
-        .data_offset = 0,
     };
-    return append_to_plan(plan, plan, &op);
+    mutation_op_rank_t rank = {.score = score, .source_index = source_index};
+    return append_to_plan(plan, op, rank, data);
+}
+
+static ca_status_t add_splice_op(mutation_plan_t *plan, uint8_t kind, uint32_t pos,
+                                 uint32_t add_pos, uint32_t len, uint32_t score,
+                                 uint32_t source_index) {
+    if (!plan || len == 0) return CA_STATUS_INVALID_ARGUMENT;
+
+    mutation_op_t op = {
+        .kind = kind,
+        .pos = pos,
+        .len = len,
+        .data_offset = add_pos,
+    };
+    mutation_op_rank_t rank = {.score = score, .source_index = source_index};
+    return append_to_plan(plan, op, rank, NULL);
+}
+
+ca_status_t mutation_plan_add_insert_from_add(mutation_plan_t *plan, uint32_t pos,
+                                             uint32_t add_pos, uint32_t len,
+                                             uint32_t score, uint32_t source_index) {
+    return add_splice_op(plan, CA_OP_INSERT_FROM_ADD, pos, add_pos, len, score,
+                         source_index);
+}
+
+ca_status_t mutation_plan_add_overwrite_from_add(mutation_plan_t *plan, uint32_t pos,
+                                                uint32_t add_pos, uint32_t len,
+                                                uint32_t score, uint32_t source_index) {
+    return add_splice_op(plan, CA_OP_OVERWRITE_FROM_ADD, pos, add_pos, len, score,
+                         source_index);
+}
+
+static ca_status_t add_int_op(mutation_plan_t *plan, uint8_t kind, uint32_t pos,
+                              uint8_t width, bool big_endian, uint32_t operand,
+                              uint32_t score, uint32_t source_index) {
+    if (!plan || (width != 2u && width != 4u && width != 8u)) {
+        return CA_STATUS_INVALID_ARGUMENT;
+    }
+
+    mutation_op_t op = {
+        .kind = kind,
+        .pos = pos,
+        .len = width,
+        .data_offset = operand,
+        .arg = big_endian ? CA_OP_INT_BIG_ENDIAN : 0u,
+    };
+    mutation_op_rank_t rank = {.score = score, .source_index = source_index};
+    return append_to_plan(plan, op, rank, NULL);
+}
+
+ca_status_t mutation_plan_add_add_int(mutation_plan_t *plan, uint32_t pos,
+                                     uint8_t width, bool big_endian, uint32_t delta,
+                                     uint32_t score, uint32_t source_index) {
+    return add_int_op(plan, CA_OP_ADD_INT, pos, width, big_endian, delta, score,
+                      source_index);
+}
+
+ca_status_t mutation_plan_add_sub_int(mutation_plan_t *plan, uint32_t pos,
+                                     uint8_t width, bool big_endian, uint32_t delta,
+                                     uint32_t score, uint32_t source_index) {
+    return add_int_op(plan, CA_OP_SUB_INT, pos, width, big_endian, delta, score,
+                      source_index);
+}
+
+ca_status_t mutation_plan_add_set_int(mutation_plan_t *plan, uint32_t pos,
+                                     uint8_t width, bool big_endian, int32_t value,
+                                     uint32_t score, uint32_t source_index) {
+    return add_int_op(plan, CA_OP_SET_INT, pos, width, big_endian, (uint32_t)value, score,
+                      source_index);
+}
+
+ca_status_t mutation_plan_add_xor_range(mutation_plan_t *plan, uint32_t pos,
+                                       uint32_t len, const uint8_t *key,
+                                       uint8_t key_len, uint32_t score,
+                                       uint32_t source_index) {
+    if (!plan || !key || key_len == 0 || len == 0) return CA_STATUS_INVALID_ARGUMENT;
+
+    mutation_op_t op = {
+        .kind = CA_OP_XOR_RANGE,
+        .pos = pos,
+        .len = len,
+        .arg = key_len,
+    };
+    mutation_op_rank_t rank = {.score = score, .source_index = source_index};
+    return append_to_plan(plan, op, rank, key);
+}
+
+ca_status_t mutation_plan_add_fill_range(mutation_plan_t *plan, uint32_t pos,
+                                        uint32_t len, uint8_t value, uint32_t score,
+                                        uint32_t source_index) {
+    if (!plan || len == 0) return CA_STATUS_INVALID_ARGUMENT;
+
+    mutation_op_t op = {
+        .kind = CA_OP_FILL_RANGE,
+        .pos = pos,
+        .len = len,
+        .arg = value,
+    };
+    mutation_op_rank_t rank = {.score = score, .source_index = source_index};
+    return append_to_plan(plan, op, rank, NULL);
+}
+
+ca_status_t mutation_plan_add_copy_range(mutation_plan_t *plan, uint32_t pos,
+                                        uint32_t src_pos, uint32_t len,
+                                        uint32_t score, uint32_t source_index) {
+    if (!plan || len == 0) return CA_STATUS_INVALID_ARGUMENT;
+
+    mutation_op_t op = {
+        .kind = CA_OP_COPY_RANGE,
+        .pos = pos,
+        .len = len,
+        .data_offset = src_pos,
+    };
+    mutation_op_rank_t rank = {.score = score, .source_index = source_index};
+    return append_to_plan(plan, op, rank, NULL);
 }
 
 void normalized_plan_free(normalized_plan_t *plan) {
     if (!plan) return;
     free(plan->ops);
+    free(plan->ranks);
     free(plan->extra_bytes);
     plan->ops = NULL;
+    plan->ranks = NULL;
     plan->extra_bytes = NULL;
     plan->op_count = 0;
     plan->extra_bytes_len = 0;
+    plan->add_buf = NULL;
+    plan->add_buf_len = 0;
 }
 
 static bool op_is_point(const mutation_op_t *op) {
@@ -218,10 +326,73 @@ static bool op_is_point(const mutation_op_t *op) {
            op->kind == CA_OP_ADD_BYTE || op->kind == CA_OP_SUB_BYTE;
 }
 
+static bool op_is_int(const mutation_op_t *op) {
+    return op->kind == CA_OP_ADD_INT || op->kind == CA_OP_SUB_INT ||
+           op->kind == CA_OP_SET_INT;
+}
+
+// Length-preserving rewrites of input bytes [pos, pos + len): XOR and fill ranges,
+// splice overwrites, and integer ops, which own their whole field.
+static bool op_is_range(const mutation_op_t *op) {
+    return op->kind == CA_OP_XOR_RANGE || op->kind == CA_OP_FILL_RANGE ||
+           op->kind == CA_OP_OVERWRITE_FROM_ADD || op_is_int(op);
+}
+
+// Whether range op `op` reads the bytes it rewrites.
+static bool range_reads_input(const mutation_op_t *op) {
+    return op->kind != CA_OP_FILL_RANGE && op->kind != CA_OP_SET_INT &&
+           op->kind != CA_OP_OVERWRITE_FROM_ADD;
+}
+
+// Whether `op` reads add_buf[data_offset, data_offset + len).
+static bool op_reads_add(const mutation_op_t *op) {
+    return op->kind == CA_OP_INSERT_FROM_ADD || op->kind == CA_OP_OVERWRITE_FROM_ADD;
+}
+
+static bool add_span_valid(const mutation_op_t *op, size_t add_buf_len) {
+    return (uint64_t)op->data_offset + (uint64_t)op->len <= add_buf_len;
+}
+
+static uint64_t int_mask(uint32_t width) {
+    return width >= 8u ? UINT64_MAX : (UINT64_C(1) << (width * 8u)) - 1u;
+}
+
+static uint64_t int_load(const uint8_t *src, uint32_t width, bool big_endian) {
+    uint64_t value = 0;
+    for (uint32_t i = 0; i < width; ++i) {
+        value |= (uint64_t)src[big_endian ? i : width - 1u - i] << ((width - 1u - i) * 8u);
+    }
+    return value;
+}
+
+static void int_store(uint8_t *dst, uint32_t width, bool big_endian, uint64_t value) {
+    for (uint32_t i = 0; i < width; ++i) {
+        dst[big_endian ? width - 1u - i : i] = (uint8_t)(value >> (i * 8u));
+    }
+}
+
+// The value integer op `op` leaves in its field, given the field's bytes at `src`
+// (not read by SET_INT).
+static uint64_t int_result(const mutation_op_t *op, const uint8_t *src) {
+    const uint64_t mask = int_mask(op->len);
+    if (op->kind == CA_OP_SET_INT) {
+        return (uint64_t)(int64_t)(int32_t)op->data_offset & mask;
+    }
+    uint64_t value = int_load(src, op->len, (op->arg & CA_OP_INT_BIG_ENDIAN) != 0);
+    if (op->kind == CA_OP_ADD_INT) return (value + op->data_offset) & mask;
+    return (value - op->data_offset) & mask;
+}
+
+// Ops that add bytes in front of input position `pos`.
+static bool op_is_insert(const mutation_op_t *op) {
+    return op->kind == CA_OP_INSERT_BYTES || op->kind == CA_OP_COPY_RANGE ||
+           op->kind == CA_OP_INSERT_FROM_ADD;
+}
+
 static bool op_is_supported(const mutation_op_t *op) {
     if (!op) return false;
-    if (op_is_point(op)) return true;
-    return op->kind == CA_OP_DELETE_RANGE || op->kind == CA_OP_INSERT_BYTES;
+    if (op_is_point(op) || op_is_range(op) || op_is_insert(op)) return true;
+    return op->kind == CA_OP_DELETE_RANGE;
 }
 
 static bool delete_contains_pos(const mutation_op_t *del, uint32_t pos) {
@@ -239,9 +410,15 @@ static bool ranges_overlap(uint32_t a_pos, uint32_t a_len, uint32_t b_pos, uint3
     return (uint64_t)a_pos < b_end && (uint64_t)b_pos < a_end;
 }
 
+// Op and rank side by side; only used while normalization sorts.
+typedef struct {
+    mutation_op_t op;
+    mutation_op_rank_t rank;
+} plan_entry_t;
+
 static int cmp_score(const void *left, const void *right) {
-    const mutation_op_t *a = (const mutation_op_t *)left;
-    const mutation_op_t *b = (const mutation_op_t *)right;
+    const mutation_op_rank_t *a = &((const plan_entry_t *)left)->rank;
+    const mutation_op_rank_t *b = &((const plan_entry_t *)right)->rank;
     if (a->score != b->score) return (a->score < b->score) ? 1 : -1;
     if (a->source_index != b->source_index) {
         return (a->source_index < b->source_index) ? -1 : 1;
@@ -250,22 +427,34 @@ static int cmp_score(const void *left, const void *right) {
 }
 
 static int cmp_pos_then_source(const void *left, const void *right) {
-    const mutation_op_t *a = (const mutation_op_t *)left;
-    const mutation_op_t *b = (const mutation_op_t *)right;
-    if (a->pos != b->pos) return (a->pos < b->pos) ? -1 : 1;
-    if (a->source_index != b->source_index) {
-        return (a->source_index < b->source_index) ? -1 : 1;
+    const plan_entry_t *a = (const plan_entry_t *)left;
+    const plan_entry_t *b = (const plan_entry_t *)right;
+    if (a->op.pos != b->op.pos) return (a->op.pos < b->op.pos) ? -1 : 1;
+    if (a->rank.source_index != b->rank.source_index) {
+        return (a->rank.source_index < b->rank.source_index) ? -1 : 1;
     }
     return 0;
 }
 
+// A range op owns every byte it covers: any other op on those bytes blocks it, and
+// so does an insert strictly inside it. Inserts at its start go first and do not.
+static bool range_blocks(const mutation_op_t *range, const mutation_op_t *other) {
+    if (!op_is_range(range)) return false;
+    if (op_is_insert(other)) {
+        return other->pos > range->pos &&
+               (uint64_t)other->pos < (uint64_t)range->pos + range->len;
+    }
+    return ranges_overlap(range->pos, range->len, other->pos, other->len);
+}
+
 static bool op_conflicts(const mutation_op_t *candidate,
                         const normalized_plan_t *accepted) {
     for (size_t i = 0; i < accepted->op_count; ++i) {
         const mutation_op_t *cur = &accepted->ops[i];
 
-        if (candidate->kind == CA_OP_INSERT_BYTES && cur->kind == CA_OP_INSERT_BYTES &&
-            cur->pos == candidate->pos) {
+        if (range_blocks(candidate, cur) || range_blocks(cur, candidate)) return true;
+
+        if (op_is_insert(candidate) && op_is_insert(cur) && cur->pos == candidate->pos) {
             return true;
         }
 
@@ -289,7 +478,7 @@ static bool op_conflicts(const mutation_op_t *candidate,
             return true;
         }
 
-        if (candidate->kind == CA_OP_INSERT_BYTES && cur->kind == CA_OP_DELETE_RANGE &&
+        if (op_is_insert(candidate) && cur->kind == CA_OP_DELETE_RANGE &&
             candidate->pos > cur->pos && candidate->pos <
                 (uint32_t)(cur->pos + cur->len)) {
             return true;
@@ -306,8 +495,42 @@ static bool is_valid_for_input_len(const mutation_op_t *op,
     size_t input_len = limits->input_len;
 
     if (op->kind == CA_OP_INSERT_BYTES) {
-        return op->arg.insert.data_len > 0 && op->arg.insert.data != NULL &&
-               op->len == op->arg.insert.data_len && op->pos <= input_len;
+        return op->len > 0 && op->pos <= input_len;
+    }
+
+    if (op->kind == CA_OP_COPY_RANGE) {
+        return op->len > 0 && op->pos <= input_len &&
+               (uint64_t)op->data_offset + (uint64_t)op->len <= input_len;
+    }
+
+    if (op_reads_add(op)) {
+        if (op->len == 0 || !limits->add_buf || !add_span_valid(op, limits->add_buf_len)) {
+            return false;
+        }
+        if (op->kind == CA_OP_INSERT_FROM_ADD) return op->pos <= input_len;
+        if ((uint64_t)op->pos + (uint64_t)op->len > input_len) return false;
+        // An overwrite with the bytes already there is a no-op.
+        return limits->input == NULL ||
+               memcmp(limits->input + op->pos, limits->add_buf + op->data_offset,
+                      op->len) != 0;
+    }
+
+    if (op_is_int(op)) {
+        if ((op->len != 2u && op->len != 4u && op->len != 8u) ||
+            (op->arg & ~CA_OP_INT_BIG_ENDIAN) != 0u ||
+            (uint64_t)op->pos + (uint64_t)op->len > input_len) {
+            return false;
+        }
+        if (op->kind != CA_OP_SET_INT) return (op->data_offset & int_mask(op->len)) != 0u;
+        return limits->input == NULL ||
+               int_result(op, NULL) != int_load(limits->input + op->pos, op->len,
+                                                (op->arg & CA_OP_INT_BIG_ENDIAN) != 0);
+    }
+
+    if (op_is_range(op)) {
+        if (op->kind == CA_OP_XOR_RANGE && op->arg == 0u) return false;
+        return op->len > 0 && op->pos < input_len &&
+               (uint64_t)op->pos + (uint64_t)op->len <= input_len;
     }
 
     if (op->kind == CA_OP_DELETE_RANGE) {
@@ -318,15 +541,14 @@ static bool is_valid_for_input_len(const mutation_op_t *op,
     }
 
     if (op_is_point(op)) {
-        if (op->kind == CA_OP_BIT_FLIP && op->arg.bit_flip.bit_index >= 8u) {
+        if (op->kind == CA_OP_BIT_FLIP && op->arg >= 8u) {
             return false;
         }
-        if ((op->kind == CA_OP_ADD_BYTE || op->kind == CA_OP_SUB_BYTE) &&
-            op->arg.arithmetic.delta == 0u) {
+        if ((op->kind == CA_OP_ADD_BYTE || op->kind == CA_OP_SUB_BYTE) && op->arg == 0u) {
             return false;
         }
         if (op->kind == CA_OP_SET_BYTE && limits->input != NULL &&
-            input_len > 0 && limits->input[op->pos] == op->arg.set_byte.value) {
+            op->pos < input_len && limits->input[op->pos] == op->arg) {
             return false;
         }
         return op->len == 1 && op->pos < input_len;
@@ -339,7 +561,7 @@ ca_status_t mutation_plan_normalize(const mutation_plan_t *source,
                                    const ca_plan_limits_t *limits,
                                    normalized_plan_t *result) {
     if (!source || !limits || !result) return CA_STATUS_INVALID_ARGUMENT;
-    if (result->ops || result->extra_bytes) {
+    if (result->ops || result->ranks || result->extra_bytes) {
         normalized_plan_free(result);
     }
     *result = (normalized_plan_t){0};
@@ -348,45 +570,43 @@ ca_status_t mutation_plan_normalize(const mutation_plan_t *source,
         return CA_STATUS_OK;
     }
 
-    mutation_op_t *candidates =
-        (mutation_op_t *)malloc(source->op_count * sizeof(*candidates));
+    plan_entry_t *candidates =
+        (plan_entry_t *)malloc(source->op_count * sizeof(*candidates));
     if (!candidates) return CA_STATUS_OUT_OF_MEMORY;
 
     for (size_t i = 0; i < source->op_count; ++i) {
-        candidates[i] = source->ops[i];
-        if (candidates[i].source_index == 0) candidates[i].source_index = (uint32_t)(i + 1);
-        if (candidates[i].kind == CA_OP_INSERT_BYTES && candidates[i].arg.insert.data_len == 0) {
-            candidates[i].len = 0;
-            continue;
-        }
-        if (candidates[i].kind == CA_OP_INSERT_BYTES) {
-            candidates[i].arg.insert.data_len = candidates[i].len;
+        candidates[i].op = source->ops[i];
+        candidates[i].rank = source->ranks[i];
+        if (candidates[i].rank.source_index == 0) {
+            candidates[i].rank.source_index = (uint32_t)(i + 1);
         }
     }
 
-    mutation_plan_t source_view = {
-        .extra_bytes = source->extra_bytes,
-        .extra_bytes_len = source->extra_bytes_len,
-    };
-
     if (source->op_count > 1) {
         qsort(candidates, source->op_count, sizeof(*candidates), cmp_score);
     }
 
-    normalized_plan_t accepted = {0};
+    normalized_plan_t accepted = {.add_buf = limits->add_buf,
+                                  .add_buf_len = limits->add_buf ? limits->add_buf_len : 0};
     for (size_t i = 0; i < source->op_count; ++i) {
-        mutation_op_t candidate = candidates[i];
-
-        if (!is_valid_for_input_len(&candidate, limits)) continue;
-        if (candidate.kind == CA_OP_INSERT_BYTES &&
-            (candidate.arg.insert.data == NULL || candidate.arg.insert.data_len != candidate.len)) {
-            continue;
+        const mutation_op_t *candidate = &candidates[i].op;
+
+        if (!is_valid_for_input_len(candidate, limits)) continue;
+        const uint8_t *payload = NULL;
+        const uint32_t payload_len = op_payload_len(candidate);
+        if (payload_len > 0) {
+            if (candidate->data_offset > source->extra_bytes_len ||
+                payload_len > source->extra_bytes_len - candidate->data_offset) {
+                continue;
+            }
+            payload = source->extra_bytes + candidate->data_offset;
         }
         if (limits->max_ops != 0 && accepted.op_count >= limits->max_ops) break;
 
-        if (op_conflicts(&candidate, &accepted)) continue;
+        if (op_conflicts(candidate, &accepted)) continue;
 
-        ca_status_t status = append_to_plan(&accepted, &source_view, &candidate);
+        ca_status_t status =
+            append_to_plan(&accepted, *candidate, candidates[i].rank, payload);
         if (status != CA_STATUS_OK) {
             normalized_plan_free(&accepted);
             free(candidates);
@@ -394,12 +614,11 @@ ca_status_t mutation_plan_normalize(const mutation_plan_t *source,
         }
     }
 
-    free(candidates);
-
     size_t output_len = 0;
     if (mutation_plan_measure(&accepted, limits->input_len,
                              &output_len) != CA_STATUS_OK) {
         normalized_plan_free(&accepted);
+        free(candidates);
         return CA_STATUS_INVALID_ARGUMENT;
     }
 
@@ -409,13 +628,13 @@ ca_status_t mutation_plan_normalize(const mutation_plan_t *source,
         uint32_t tie_source = UINT32_MAX;
 
         for (size_t i = 0; i < accepted.op_count; ++i) {
-            if (accepted.ops[i].kind != CA_OP_INSERT_BYTES) continue;
-            if (accepted.ops[i].score < lowest_score ||
-                (accepted.ops[i].score == lowest_score &&
-                 accepted.ops[i].source_index < tie_source)) {
-                lowest_score = accepted.ops[i].score;
+            if (!op_is_insert(&accepted.ops[i])) continue;
+            const mutation_op_rank_t *rank = &accepted.ranks[i];
+            if (rank->score < lowest_score ||
+                (rank->score == lowest_score && rank->source_index < tie_source)) {
+                lowest_score = rank->score;
                 remove_idx = i;
-                tie_source = accepted.ops[i].source_index;
+                tie_source = rank->source_index;
             }
         }
 
@@ -423,25 +642,37 @@ ca_status_t mutation_plan_normalize(const mutation_plan_t *source,
 
         for (size_t i = remove_idx + 1; i < accepted.op_count; ++i) {
             accepted.ops[i - 1] = accepted.ops[i];
+            accepted.ranks[i - 1] = accepted.ranks[i];
         }
         accepted.op_count -= 1;
 
         if (mutation_plan_measure(&accepted, limits->input_len,
                                  &output_len) != CA_STATUS_OK) {
             normalized_plan_free(&accepted);
+            free(candidates);
             return CA_STATUS_INVALID_ARGUMENT;
         }
     }
 
     if (output_len > limits->max_output_len) {
         normalized_plan_free(&accepted);
+        free(candidates);
         return CA_STATUS_OUTPUT_TOO_LARGE;
     }
 
+    // Reuse the candidate buffer to sort ops and ranks together by position.
     if (accepted.op_count > 1) {
-        qsort(accepted.ops, accepted.op_count, sizeof(*accepted.ops),
-              cmp_pos_then_source);
+        for (size_t i = 0; i < accepted.op_count; ++i) {
+            candidates[i].op = accepted.ops[i];
+            candidates[i].rank = accepted.ranks[i];
+        }
+        qsort(candidates, accepted.op_count, sizeof(*candidates), cmp_pos_then_source);
+        for (size_t i = 0; i < accepted.op_count; ++i) {
+            accepted.ops[i] = candidates[i].op;
+            accepted.ranks[i] = candidates[i].rank;
+        }
     }
+    free(candidates);
     *result = accepted;
     return CA_STATUS_OK;
 }
@@ -474,9 +705,9 @@ ca_status_t mutation_plan_measure(const normalized_plan_t *plan, size_t input_le
                 }
                 break;
             case CA_OP_INSERT_BYTES: {
-                if (op->len == 0 || op->arg.insert.data_len == 0 ||
-                    op->arg.insert.data_len != op->len || op->pos > input_len ||
-                    op->arg.insert.data == NULL) {
+                if (op->len == 0 || op->pos > input_len ||
+                    op->data_offset > plan->extra_bytes_len ||
+                    op->len > plan->extra_bytes_len - op->data_offset) {
                     return CA_STATUS_INVALID_ARGUMENT;
                 }
                 if (size_add_overflow(inserted, (size_t)op->len, &inserted)) {
@@ -484,6 +715,51 @@ ca_status_t mutation_plan_measure(const normalized_plan_t *plan, size_t input_le
                 }
                 break;
             }
+            case CA_OP_XOR_RANGE:
+            case CA_OP_FILL_RANGE:
+                if (op->len == 0 || op->pos >= input_len ||
+                    (uint64_t)op->pos + (uint64_t)op->len > input_len) {
+                    return CA_STATUS_INVALID_ARGUMENT;
+                }
+                if (op->kind == CA_OP_XOR_RANGE &&
+                    (op->arg == 0u || op->data_offset > plan->extra_bytes_len ||
+                     op->arg > plan->extra_bytes_len - op->data_offset)) {
+                    return CA_STATUS_INVALID_ARGUMENT;
+                }
+                break;
+            case CA_OP_ADD_INT:
+            case CA_OP_SUB_INT:
+            case CA_OP_SET_INT:
+                if ((op->len != 2u && op->len != 4u && op->len != 8u) ||
+                    (op->arg & ~CA_OP_INT_BIG_ENDIAN) != 0u ||
+                    (uint64_t)op->pos + (uint64_t)op->len > input_len) {
+                    return CA_STATUS_INVALID_ARGUMENT;
+                }
+                break;
+            case CA_OP_COPY_RANGE:
+                if (op->len == 0 || op->pos > input_len ||
+                    (uint64_t)op->data_offset + (uint64_t)op->len > input_len) {
+                    return CA_STATUS_INVALID_ARGUMENT;
+                }
+                if (size_add_overflow(inserted, (size_t)op->len, &inserted)) {
+                    return CA_STATUS_OUT_OF_MEMORY;
+                }
+                break;
+            case CA_OP_INSERT_FROM_ADD:
+                if (op->len == 0 || op->pos > input_len || !plan->add_buf ||
+                    !add_span_valid(op, plan->add_buf_len)) {
+                    return CA_STATUS_INVALID_ARGUMENT;
+                }
+                if (size_add_overflow(inserted, (size_t)op->len, &inserted)) {
+                    return CA_STATUS_OUT_OF_MEMORY;
+                }
+                break;
+            case CA_OP_OVERWRITE_FROM_ADD:
+                if (op->len == 0 || (uint64_t)op->pos + (uint64_t)op->len > input_len ||
+                    !plan->add_buf || !add_span_valid(op, plan->add_buf_len)) {
+                    return CA_STATUS_INVALID_ARGUMENT;
+                }
+                break;
             default:
                 return CA_STATUS_INVALID_ARGUMENT;
         }
@@ -510,16 +786,155 @@ static const mutation_op_t *find_point_at(const normalized_plan_t *plan, uint32_
     return NULL;
 }
 
+static uint8_t apply_point(const mutation_op_t *point, uint8_t byte) {
+    if (point->kind == CA_OP_BIT_FLIP) {
+        return (uint8_t)(byte ^ (1u << (point->arg & 7u)));
+    }
+    if (point->kind == CA_OP_SET_BYTE) return point->arg;
+    if (point->kind == CA_OP_ADD_BYTE) return (uint8_t)(byte + (int8_t)point->arg);
+    if (point->kind == CA_OP_SUB_BYTE) return (uint8_t)(byte - (int8_t)point->arg);
+    return byte;
+}
+
+// Longest key a pattern is unrolled for is 255 bytes: lcm(255, 16).
+#define RANGE_PATTERN_MAX 4080u
+
+// Writes src[0, len) XORed with `key` repeated from its first byte to dst, which may
+// equal src. The key is unrolled to a multiple of 16 bytes so each 16-byte step lines
+// up with the pattern: SSE2 where the target has it, two 64-bit words otherwise.
+static void range_xor(uint8_t *dst, const uint8_t *src, size_t len, const uint8_t *key,
+                      uint32_t key_len) {
+    uint8_t pattern[RANGE_PATTERN_MAX];
+    size_t period = key_len;
+    while (period % 16u != 0) period += key_len;
+    size_t rounded = (len + 15u) & ~(size_t)15u;
+    size_t pattern_len = rounded < period ? rounded : period;
+    for (size_t i = 0, k = 0; i < pattern_len; ++i) {
+        pattern[i] = key[k];
+        if (++k == key_len) k = 0;
+    }
+
+    size_t i = 0;
+    size_t p = 0;
+    for (; i + 16u <= len; i += 16u) {
+#if defined(__SSE2__)
+        __m128i bytes = _mm_loadu_si128((const __m128i *)(const void *)(src + i));
+        __m128i mask = _mm_loadu_si128((const __m128i *)(const void *)(pattern + p));
+        _mm_storeu_si128((__m128i *)(void *)(dst + i), _mm_xor_si128(bytes, mask));
+#else
+        uint64_t bytes[2];
+        uint64_t mask[2];
+        memcpy(bytes, src + i, sizeof(bytes));
+        memcpy(mask, pattern + p, sizeof(mask));
+        bytes[0] ^= mask[0];
+        bytes[1] ^= mask[1];
+        memcpy(dst + i, bytes, sizeof(bytes));
+#endif
+        p += 16u;
+        if (p == pattern_len) p = 0;
+    }
+    for (size_t j = 0; i < len; ++i, ++j) dst[i] = (uint8_t)(src[i] ^ pattern[p + j]);
+}
+
+// Writes the bytes range op `op` makes of src[0, op->len) to dst, which may equal
+// src. FILL_RANGE, SET_INT and OVERWRITE_FROM_ADD do not read src; memset and
+// memmove are already vectorized.
+static void range_write(const normalized_plan_t *plan, const mutation_op_t *op,
+                        const uint8_t *src, uint8_t *dst) {
+    if (op->kind == CA_OP_FILL_RANGE) {
+        memset(dst, op->arg, op->len);
+    } else if (op->kind == CA_OP_OVERWRITE_FROM_ADD) {
+        // The splice partner may alias the data being patched.
+        memmove(dst, plan->add_buf + op->data_offset, op->len);
+    } else if (op_is_int(op)) {
+        int_store(dst, op->len, (op->arg & CA_OP_INT_BIG_ENDIAN) != 0, int_result(op, src));
+    } else {
+        range_xor(dst, src, op->len, plan->extra_bytes + op->data_offset, op->arg);
+    }
+}
+
+// Byte `pos` of range op `op`; `field` is the input at `op->pos`, read only by
+// integer ops, which need the whole field.
+static uint8_t range_byte(const normalized_plan_t *plan, const mutation_op_t *op,
+                          const uint8_t *field, uint32_t pos, uint8_t byte) {
+    if (op->kind == CA_OP_FILL_RANGE) return op->arg;
+    if (op->kind == CA_OP_OVERWRITE_FROM_ADD) {
+        return plan->add_buf[op->data_offset + (pos - op->pos)];
+    }
+    if (op_is_int(op)) {
+        uint8_t bytes[8];
+        range_write(plan, op, field, bytes);
+        return bytes[pos - op->pos];
+    }
+    return (uint8_t)(byte ^ plan->extra_bytes[op->data_offset + (pos - op->pos) % op->arg]);
+}
+
+// Whether range op `op` changes any byte of data[0, op->len).
+static bool range_changes(const normalized_plan_t *plan, const mutation_op_t *op,
+                          const uint8_t *data) {
+    if (op->kind == CA_OP_FILL_RANGE) {
+        for (uint32_t i = 0; i < op->len; ++i) {
+            if (data[i] != op->arg) return true;
+        }
+        return false;
+    }
+    if (op->kind == CA_OP_OVERWRITE_FROM_ADD) {
+        return memcmp(data, plan->add_buf + op->data_offset, op->len) != 0;
+    }
+    if (op_is_int(op)) {
+        return int_result(op, data) !=
+               int_load(data, op->len, (op->arg & CA_OP_INT_BIG_ENDIAN) != 0);
+    }
+    uint32_t used = op->len < op->arg ? op->len : op->arg;
+    for (uint32_t i = 0; i < used; ++i) {
+        if (plan->extra_bytes[op->data_offset + i] != 0u) return true;
+    }
+    return false;
+}
+
+// True when no other op touches the bytes of range op `range` (inserts at its start
+// aside). Normalization guarantees this; apply falls back to byte-wise precedence
+// otherwise, and segments, patch and compose reject such plans.
+static bool range_is_clear(const normalized_plan_t *plan, const mutation_op_t *range) {
+    for (size_t i = 0; i < plan->op_count; ++i) {
+        const mutation_op_t *op = &plan->ops[i];
+        if (op == range) continue;
+        if (op_is_insert(op) ? range_blocks(range, op)
+                             : ranges_overlap(range->pos, range->len, op->pos, op->len)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static const mutation_op_t *find_range_covering(const normalized_plan_t *plan,
+                                                uint32_t pos) {
+    for (size_t i = 0; i < plan->op_count; ++i) {
+        const mutation_op_t *op = &plan->ops[i];
+        if (op_is_range(op) && pos >= op->pos && pos - op->pos < op->len) return op;
+    }
+    return NULL;
+}
+
 static const mutation_op_t *find_insert_at(const normalized_plan_t *plan,
                                           uint32_t pos) {
     for (size_t i = 0; i < plan->op_count; ++i) {
-        if (plan->ops[i].kind == CA_OP_INSERT_BYTES && plan->ops[i].pos == pos) {
+        if (op_is_insert(&plan->ops[i]) && plan->ops[i].pos == pos) {
             return &plan->ops[i];
         }
     }
     return NULL;
 }
 
+// Bytes an insert-kind op adds: its payload, or the input or add_buf bytes a copy
+// or splice refers to.
+static const uint8_t *insert_source(const normalized_plan_t *plan, const uint8_t *input,
+                                    const mutation_op_t *op) {
+    if (op->kind == CA_OP_COPY_RANGE) return input + op->data_offset;
+    if (op->kind == CA_OP_INSERT_FROM_ADD) return plan->add_buf + op->data_offset;
+    return plan->extra_bytes + op->data_offset;
+}
+
 static bool is_deleted_pos(const normalized_plan_t *plan, uint32_t pos) {
     for (size_t i = 0; i < plan->op_count; ++i) {
         if (plan->ops[i].kind == CA_OP_DELETE_RANGE &&
@@ -532,7 +947,8 @@ static bool is_deleted_pos(const normalized_plan_t *plan, uint32_t pos) {
 
 ca_status_t mutation_plan_apply(const normalized_plan_t *plan, const uint8_t *input,
                                size_t input_len, uint8_t *output,
-                               size_t output_capacity, size_t *output_len) {
+                               size_t output_capacity, size_t *output_len,
+                               bool *changed) {
     if (!plan || !output || !output_len) return CA_STATUS_INVALID_ARGUMENT;
     if (input_len != 0 && input == NULL) return CA_STATUS_INVALID_ARGUMENT;
 
@@ -541,17 +957,34 @@ ca_status_t mutation_plan_apply(const normalized_plan_t *plan, const uint8_t *in
     if (st != CA_STATUS_OK) return st;
     if (expected_len > output_capacity) return CA_STATUS_INTERNAL_ERROR;
 
+    // Effective-change tracking: point ops outside the structural span are checked
+    // as they are applied. When deletes and inserts cancel out in length, bytes
+    // outside [span_begin, span_end) stay aligned, so only that span is compared
+    // instead of the whole buffer.
+    bool point_changed = false;
+    bool structural = false;
+    size_t span_begin = SIZE_MAX;
+    size_t span_end = 0;
+    for (size_t i = 0; i < plan->op_count; ++i) {
+        const mutation_op_t *op = &plan->ops[i];
+        if (op_is_point(op)) continue;
+        size_t end = op->kind == CA_OP_DELETE_RANGE || op_is_range(op)
+                         ? (size_t)op->pos + op->len
+                         : op->pos;
+        structural = true;
+        if (op->pos < span_begin) span_begin = op->pos;
+        if (end > span_end) span_end = end;
+    }
+
     size_t out = 0;
     for (uint32_t pos = 0; pos <= input_len; ++pos) {
         const mutation_op_t *insert = find_insert_at(plan, pos);
         if (insert) {
-            if (!insert->arg.insert.data) return CA_STATUS_INVALID_ARGUMENT;
-            if (insert->arg.insert.data_len == 0 ||
-                out + insert->arg.insert.data_len > output_capacity) {
+            if (insert->len == 0 || out + insert->len > output_capacity) {
                 return CA_STATUS_INTERNAL_ERROR;
             }
-            memcpy(output + out, insert->arg.insert.data, insert->arg.insert.data_len);
-            out += insert->arg.insert.data_len;
+            memcpy(output + out, insert_source(plan, input, insert), insert->len);
+            out += insert->len;
         }
 
         if (pos == input_len) break;
@@ -559,20 +992,1383 @@ ca_status_t mutation_plan_apply(const normalized_plan_t *plan, const uint8_t *in
 
         uint8_t byte = input[pos];
         const mutation_op_t *point = find_point_at(plan, pos);
+        // A point op wins over a range covering its byte.
+        const mutation_op_t *range = point ? NULL : find_range_covering(plan, pos);
+        if (range && range->pos == pos && range_is_clear(plan, range)) {
+            if (out + range->len > output_capacity) return CA_STATUS_INTERNAL_ERROR;
+            range_write(plan, range, input + pos, output + out);
+            out += range->len;
+            pos += range->len - 1u;
+            continue;
+        }
         if (point) {
-            if (point->kind == CA_OP_BIT_FLIP) {
-                byte ^= (uint8_t)(1u << (point->arg.bit_flip.bit_index & 7u));
-            } else if (point->kind == CA_OP_SET_BYTE) {
-                byte = point->arg.set_byte.value;
-            } else if (point->kind == CA_OP_ADD_BYTE) {
-                byte = (uint8_t)(byte + (int8_t)point->arg.arithmetic.delta);
-            } else if (point->kind == CA_OP_SUB_BYTE) {
-                byte = (uint8_t)(byte - (int8_t)point->arg.arithmetic.delta);
+            byte = apply_point(point, byte);
+            if (pos < span_begin || pos >= span_end) {
+                point_changed = point_changed || byte != input[pos];
             }
+        } else if (range) {
+            byte = range_byte(plan, range, input + range->pos, pos, byte);
         }
+        if (out == output_capacity) return CA_STATUS_INTERNAL_ERROR;
         output[out++] = byte;
     }
 
     *output_len = out;
+    if (changed) {
+        if (out != input_len || point_changed) {
+            *changed = true;
+        } else {
+            *changed = structural && span_end > span_begin &&
+                       memcmp(output + span_begin, input + span_begin,
+                              span_end - span_begin) != 0;
+        }
+    }
+    return CA_STATUS_OK;
+}
+
+ca_status_t mutation_plan_patch(const normalized_plan_t *plan, uint8_t *data,
+                               size_t len, bool *changed) {
+    if (!plan || !changed) return CA_STATUS_INVALID_ARGUMENT;
+    if (len != 0 && data == NULL) return CA_STATUS_INVALID_ARGUMENT;
+
+    size_t patched_len = 0;
+    ca_status_t st = mutation_plan_measure(plan, len, &patched_len);
+    if (st != CA_STATUS_OK) return st;
+
+    // Normalized ops are sorted by position, so "first point op at a position wins"
+    // (the rule mutation_plan_apply uses) reduces to skipping repeated positions.
+    bool any = false;
+    const mutation_op_t *prev = NULL;
+    for (size_t i = 0; i < plan->op_count; ++i) {
+        const mutation_op_t *op = &plan->ops[i];
+        if (op_is_range(op)) {
+            if (!range_is_clear(plan, op)) return CA_STATUS_INVALID_ARGUMENT;
+            any = any || range_changes(plan, op, data + op->pos);
+            range_write(plan, op, data + op->pos, data + op->pos);
+            continue;
+        }
+        if (!op_is_point(op) || op->len != 1 || op->pos >= len) {
+            return CA_STATUS_INVALID_ARGUMENT;
+        }
+        if (prev && prev->pos == op->pos) continue;
+        prev = op;
+
+        uint8_t byte = apply_point(op, data[op->pos]);
+        if (byte != data[op->pos]) {
+            data[op->pos] = byte;
+            any = true;
+        }
+    }
+
+    *changed = any;
     return CA_STATUS_OK;
 }
+
+// Returns the op that decides the input byte at the shared position of group
+// `ops[begin, end)`: a delete wins over point and range ops, as in
+// mutation_plan_apply, and the first of those wins over later ones. NULL when the
+// group holds only inserts.
+static const mutation_op_t *group_byte_op(const mutation_op_t *ops, size_t begin,
+                                          size_t end) {
+    const mutation_op_t *point = NULL;
+    for (size_t j = begin; j < end; ++j) {
+        if (ops[j].kind == CA_OP_DELETE_RANGE) return &ops[j];
+        if (!point && (op_is_point(&ops[j]) || op_is_range(&ops[j]))) point = &ops[j];
+    }
+    return point;
+}
+
+static ca_status_t segments_push(mutation_segments_t *segments, const uint8_t *data,
+                                 size_t len) {
+    if (len == 0) return CA_STATUS_OK;
+    if (segments->count > 0) {
+        mutation_segment_t *last = &segments->segments[segments->count - 1];
+        if (last->data + last->len == data) {
+            last->len += len;
+            segments->total_len += len;
+            return CA_STATUS_OK;
+        }
+    }
+    if (segments->count == segments->capacity) {
+        size_t capacity = segments->capacity ? segments->capacity * 2u : 16u;
+        mutation_segment_t *next = (mutation_segment_t *)realloc(
+            segments->segments, capacity * sizeof(*segments->segments));
+        if (!next) return CA_STATUS_OUT_OF_MEMORY;
+        segments->segments = next;
+        segments->capacity = capacity;
+    }
+    segments->segments[segments->count++] = (mutation_segment_t){.data = data, .len = len};
+    segments->total_len += len;
+    return CA_STATUS_OK;
+}
+
+// Compares output bytes [begin, end) described by `segments` with the same input
+// range; used only when structural ops cancel out in length.
+static bool segments_differ(const mutation_segments_t *segments, const uint8_t *input,
+                            size_t begin, size_t end) {
+    size_t offset = 0;
+    for (size_t i = 0; i < segments->count && offset < end; ++i) {
+        const mutation_segment_t *seg = &segments->segments[i];
+        size_t seg_end = offset + seg->len;
+        if (seg_end > begin) {
+            size_t lo = offset > begin ? offset : begin;
+            size_t hi = seg_end < end ? seg_end : end;
+            if (memcmp(seg->data + (lo - offset), input + lo, hi - lo) != 0) return true;
+        }
+        offset = seg_end;
+    }
+    return false;
+}
+
+ca_status_t mutation_plan_segments(const normalized_plan_t *plan, const uint8_t *input,
+                                  size_t input_len, mutation_segments_t *segments,
+                                  bool *changed) {
+    if (!plan || !segments) return CA_STATUS_INVALID_ARGUMENT;
+    if (input_len != 0 && input == NULL) return CA_STATUS_INVALID_ARGUMENT;
+
+    size_t output_len = 0;
+    ca_status_t st = mutation_plan_measure(plan, input_len, &output_len);
+    if (st != CA_STATUS_OK) return st;
+
+    segments->count = 0;
+    segments->total_len = 0;
+
+    // Patched bytes are referenced by segments, so the buffer is sized once up front:
+    // one byte per point op plus the rewritten bytes of each range op.
+    size_t patched_need = 0;
+    bool structural = false;
+    size_t span_begin = SIZE_MAX;
+    size_t span_end = 0;
+    for (size_t i = 0; i < plan->op_count; ++i) {
+        const mutation_op_t *op = &plan->ops[i];
+        if (op_is_point(op)) {
+            ++patched_need;
+            continue;
+        }
+        if (op_is_range(op)) {
+            if (!range_is_clear(plan, op)) return CA_STATUS_INVALID_ARGUMENT;
+            // Splice overwrites are referenced in `add_buf` instead.
+            if (!op_reads_add(op)) patched_need += op->len;
+        }
+        size_t end = op->kind == CA_OP_DELETE_RANGE || op_is_range(op)
+                         ? (size_t)op->pos + op->len
+                         : op->pos;
+        structural = true;
+        if (op->pos < span_begin) span_begin = op->pos;
+        if (end > span_end) span_end = end;
+    }
+    if (patched_need > segments->patched_capacity) {
+        uint8_t *next = (uint8_t *)realloc(segments->patched, patched_need);
+        if (!next) return CA_STATUS_OUT_OF_MEMORY;
+        segments->patched = next;
+        segments->patched_capacity = patched_need;
+    }
+
+    // Ops are sorted by position; at one position the insert goes first, then the
+    // delete or point op, matching mutation_plan_apply.
+    bool point_changed = false;
+    size_t patched = 0;
+    size_t cursor = 0;
+    size_t i = 0;
+    while (i < plan->op_count) {
+        uint32_t pos = plan->ops[i].pos;
+        size_t group_end = i;
+        while (group_end < plan->op_count && plan->ops[group_end].pos == pos) ++group_end;
+
+        if (pos > cursor) {
+            st = segments_push(segments, input + cursor, pos - cursor);
+            if (st != CA_STATUS_OK) return st;
+            cursor = pos;
+        }
+        for (size_t j = i; j < group_end; ++j) {
+            const mutation_op_t *op = &plan->ops[j];
+            if (!op_is_insert(op)) continue;
+            st = segments_push(segments, insert_source(plan, input, op), op->len);
+            if (st != CA_STATUS_OK) return st;
+            break;
+        }
+        const mutation_op_t *op = group_byte_op(plan->ops, i, group_end);
+        if (op && op->kind == CA_OP_DELETE_RANGE) {
+            if ((size_t)op->pos + op->len > cursor) cursor = (size_t)op->pos + op->len;
+        } else if (op && op->kind == CA_OP_OVERWRITE_FROM_ADD) {
+            st = segments_push(segments, plan->add_buf + op->data_offset, op->len);
+            if (st != CA_STATUS_OK) return st;
+            cursor = (size_t)pos + op->len;
+        } else if (op && op_is_range(op)) {
+            // Clear ranges never start inside a delete.
+            range_write(plan, op, input + pos, segments->patched + patched);
+            st = segments_push(segments, segments->patched + patched, op->len);
+            if (st != CA_STATUS_OK) return st;
+            patched += op->len;
+            cursor = (size_t)pos + op->len;
+        } else if (op && pos >= cursor) {
+            uint8_t byte = apply_point(op, input[pos]);
+            if (pos < span_begin || pos >= span_end) {
+                point_changed = point_changed || byte != input[pos];
+            }
+            segments->patched[patched] = byte;
+            st = segments_push(segments, &segments->patched[patched], 1);
+            if (st != CA_STATUS_OK) return st;
+            ++patched;
+            cursor = (size_t)pos + 1u;
+        }
+        i = group_end;
+    }
+    if (input_len > cursor) {
+        st = segments_push(segments, input + cursor, input_len - cursor);
+        if (st != CA_STATUS_OK) return st;
+    }
+    if (segments->total_len != output_len) return CA_STATUS_INTERNAL_ERROR;
+
+    if (changed) {
+        if (output_len != input_len || point_changed) {
+            *changed = true;
+        } else {
+            *changed = structural && span_end > span_begin &&
+                       segments_differ(segments, input, span_begin, span_end);
+        }
+    }
+    return CA_STATUS_OK;
+}
+
+void mutation_segments_free(mutation_segments_t *segments) {
+    if (!segments) return;
+    free(segments->segments);
+    free(segments->patched);
+    *segments = (mutation_segments_t){0};
+}
+
+enum {
+    GAP_EDIT_REPLACE = 1,
+    GAP_EDIT_DELETE,
+    GAP_EDIT_INSERT,
+};
+
+// Gap left behind the content when a buffer is loaded or grown.
+#define GAP_MIN_SLACK 256u
+
+static size_t gap_size(const mutation_gap_buffer_t *buffer) {
+    return buffer->gap_end - buffer->gap_start;
+}
+
+// Moves the gap so that it starts at content position `pos`.
+static void gap_move(mutation_gap_buffer_t *buffer, size_t pos) {
+    if (pos < buffer->gap_start) {
+        size_t n = buffer->gap_start - pos;
+        memmove(buffer->data + buffer->gap_end - n, buffer->data + pos, n);
+        buffer->gap_start = pos;
+        buffer->gap_end -= n;
+    } else if (pos > buffer->gap_start) {
+        size_t n = pos - buffer->gap_start;
+        memmove(buffer->data + buffer->gap_start, buffer->data + buffer->gap_end, n);
+        buffer->gap_start += n;
+        buffer->gap_end += n;
+    }
+}
+
+// Content position `pos` as an index into `data`, and how many bytes from there are
+// contiguous.
+static size_t gap_locate(const mutation_gap_buffer_t *buffer, size_t pos, size_t *run) {
+    if (pos < buffer->gap_start) {
+        *run = buffer->gap_start - pos;
+        return pos;
+    }
+    *run = buffer->len - pos;
+    return pos + gap_size(buffer);
+}
+
+static void gap_read(const mutation_gap_buffer_t *buffer, size_t pos, uint8_t *dst,
+                     size_t len) {
+    while (len > 0) {
+        size_t run = 0;
+        size_t at = gap_locate(buffer, pos, &run);
+        if (run > len) run = len;
+        memcpy(dst, buffer->data + at, run);
+        pos += run;
+        dst += run;
+        len -= run;
+    }
+}
+
+static void gap_write(mutation_gap_buffer_t *buffer, size_t pos, const uint8_t *src,
+                      size_t len) {
+    while (len > 0) {
+        size_t run = 0;
+        size_t at = gap_locate(buffer, pos, &run);
+        if (run > len) run = len;
+        memcpy(buffer->data + at, src, run);
+        pos += run;
+        src += run;
+        len -= run;
+    }
+}
+
+// Grows the gap to at least `need` bytes, keeping the content.
+static ca_status_t gap_reserve(mutation_gap_buffer_t *buffer, size_t need) {
+    if (gap_size(buffer) >= need) return CA_STATUS_OK;
+    size_t slack = buffer->len / 8u;
+    if (slack < GAP_MIN_SLACK) slack = GAP_MIN_SLACK;
+    size_t capacity = 0;
+    if (size_add_overflow(buffer->len, need, &capacity) ||
+        size_add_overflow(capacity, slack, &capacity)) {
+        return CA_STATUS_OUT_OF_MEMORY;
+    }
+    uint8_t *next = (uint8_t *)realloc(buffer->data, capacity);
+    if (!next) return CA_STATUS_OUT_OF_MEMORY;
+    size_t tail = buffer->capacity - buffer->gap_end;
+    memmove(next + capacity - tail, next + buffer->gap_end, tail);
+    buffer->data = next;
+    buffer->gap_end = capacity - tail;
+    buffer->capacity = capacity;
+    return CA_STATUS_OK;
+}
+
+static ca_status_t gap_grow(uint8_t **bytes, size_t *capacity, size_t need) {
+    if (need <= *capacity) return CA_STATUS_OK;
+    uint8_t *next = (uint8_t *)realloc(*bytes, need);
+    if (!next) return CA_STATUS_OUT_OF_MEMORY;
+    *bytes = next;
+    *capacity = need;
+    return CA_STATUS_OK;
+}
+
+static ca_status_t gap_push_edit(mutation_gap_buffer_t *buffer, mutation_gap_edit_t edit) {
+    if (buffer->edit_count == buffer->edit_capacity) {
+        size_t capacity = buffer->edit_capacity ? buffer->edit_capacity * 2u : 16u;
+        mutation_gap_edit_t *next = (mutation_gap_edit_t *)realloc(
+            buffer->edits, capacity * sizeof(*buffer->edits));
+        if (!next) return CA_STATUS_OUT_OF_MEMORY;
+        buffer->edits = next;
+        buffer->edit_capacity = capacity;
+    }
+    buffer->edits[buffer->edit_count++] = edit;
+    return CA_STATUS_OK;
+}
+
+ca_status_t mutation_gap_buffer_load(mutation_gap_buffer_t *buffer, const uint8_t *data,
+                                     size_t len) {
+    if (!buffer || (len != 0 && !data)) return CA_STATUS_INVALID_ARGUMENT;
+    buffer->edit_count = 0;
+    buffer->gap_start = 0;
+    buffer->gap_end = buffer->capacity;
+    buffer->len = 0;
+    ca_status_t st = gap_reserve(buffer, len);
+    if (st != CA_STATUS_OK) return st;
+    if (len > 0) memcpy(buffer->data, data, len);
+    buffer->gap_start = len;
+    buffer->len = len;
+    return CA_STATUS_OK;
+}
+
+// Two passes. The first walks the ops in position order, like mutation_plan_segments,
+// and records one edit per insert, delete and byte op, with the new bytes of point,
+// range and copy ops rendered into `scratch` from the still untouched content. The
+// second runs the edits from the last position down, so every edit still sees its
+// positions in input coordinates, saving what it overwrites or removes.
+ca_status_t mutation_plan_apply_gap(const normalized_plan_t *plan,
+                                    mutation_gap_buffer_t *buffer, bool *changed) {
+    if (!plan || !buffer || !changed) return CA_STATUS_INVALID_ARGUMENT;
+    if (buffer->edit_count != 0) return CA_STATUS_INVALID_ARGUMENT;
+
+    const size_t input_len = buffer->len;
+    size_t output_len = 0;
+    ca_status_t st = mutation_plan_measure(plan, input_len, &output_len);
+    if (st != CA_STATUS_OK) return st;
+
+    // Sizes every buffer up front so `src` pointers into `scratch` stay valid. As in
+    // segments, the span covers the non-point ops; when deletes and inserts cancel
+    // out in length it is compared against a copy of its original bytes.
+    size_t scratch_need = 0;
+    size_t saved_need = 0;
+    size_t inserted = 0;
+    bool resizes = false;
+    size_t span_begin = SIZE_MAX;
+    size_t span_end = 0;
+    for (size_t i = 0; i < plan->op_count; ++i) {
+        const mutation_op_t *op = &plan->ops[i];
+        if (op_is_point(op)) {
+            ++scratch_need;
+            ++saved_need;
+            continue;
+        }
+        if (op_is_range(op)) {
+            if (!range_is_clear(plan, op)) return CA_STATUS_INVALID_ARGUMENT;
+            if (!op_reads_add(op)) scratch_need += op->len;
+            saved_need += op->len;
+        } else if (op->kind == CA_OP_DELETE_RANGE) {
+            saved_need += op->len;
+            resizes = true;
+        } else {
+            if (op->kind == CA_OP_COPY_RANGE) scratch_need += op->len;
+            inserted += op->len;
+            resizes = true;
+        }
+        size_t end = op->kind == CA_OP_DELETE_RANGE || op_is_range(op)
+                         ? (size_t)op->pos + op->len
+                         : op->pos;
+        if (op->pos < span_begin) span_begin = op->pos;
+        if (end > span_end) span_end = end;
+    }
+    const bool compare_span = resizes && output_len == input_len && span_end > span_begin;
+    const size_t span_len = compare_span ? span_end - span_begin : 0;
+    st = gap_grow(&buffer->scratch, &buffer->scratch_capacity, scratch_need + span_len);
+    if (st == CA_STATUS_OK) {
+        st = gap_grow(&buffer->saved, &buffer->saved_capacity, saved_need);
+    }
+    if (st == CA_STATUS_OK) st = gap_reserve(buffer, inserted);
+    if (st != CA_STATUS_OK) return st;
+    uint8_t *original = buffer->scratch + scratch_need;
+    if (compare_span) gap_read(buffer, span_begin, original, span_len);
+
+    // Deletes are merged into [delete_from, cursor) and cut at every insert inside
+    // them, so no delete edit ever runs across bytes inserted by a later edit.
+    size_t rendered = 0;
+    size_t saved = 0;
+    size_t cursor = 0;
+    size_t delete_from = 0;
+    size_t i = 0;
+    while (i < plan->op_count && st == CA_STATUS_OK) {
+        const uint32_t pos = plan->ops[i].pos;
+        size_t group_end = i;
+        bool has_insert = false;
+        for (; group_end < plan->op_count && plan->ops[group_end].pos == pos; ++group_end) {
+            has_insert = has_insert || op_is_insert(&plan->ops[group_end]);
+        }
+
+        if (delete_from < cursor && (pos >= cursor || has_insert)) {
+            size_t until = pos < cursor ? pos : cursor;
+            if (until > delete_from) {
+                st = gap_push_edit(buffer, (mutation_gap_edit_t){
+                                               .kind = GAP_EDIT_DELETE,
+                                               .pos = delete_from,
+                                               .len = until - delete_from,
+                                               .saved_offset = saved,
+                                           });
+                saved += until - delete_from;
+            }
+            delete_from = until;
+        }
+
+        mutation_gap_edit_t edit = {.pos = pos};
+        for (size_t j = i; j < group_end && st == CA_STATUS_OK; ++j) {
+            const mutation_op_t *op = &plan->ops[j];
+            if (!op_is_insert(op)) continue;
+            edit.kind = GAP_EDIT_INSERT;
+            edit.len = op->len;
+            if (op->kind == CA_OP_COPY_RANGE) {
+                uint8_t *dst = buffer->scratch + rendered;
+                gap_read(buffer, op->data_offset, dst, op->len);
+                rendered += op->len;
+                edit.src = dst;
+            } else {
+                edit.src = insert_source(plan, NULL, op);
+            }
+            st = gap_push_edit(buffer, edit);
+            break;
+        }
+
+        const mutation_op_t *op = group_byte_op(plan->ops, i, group_end);
+        edit = (mutation_gap_edit_t){.pos = pos, .saved_offset = saved};
+        if (!op || (op_is_point(op) && pos < cursor)) {
+            edit.kind = 0;
+        } else if (op->kind == CA_OP_DELETE_RANGE) {
+            edit.kind = 0;
+            if (pos >= cursor) delete_from = pos;
+            if ((size_t)pos + op->len > cursor) cursor = (size_t)pos + op->len;
+        } else if (op->kind == CA_OP_OVERWRITE_FROM_ADD) {
+            edit.kind = GAP_EDIT_REPLACE;
+            edit.len = op->len;
+            edit.src = plan->add_buf + op->data_offset;
+        } else {
+            edit.kind = GAP_EDIT_REPLACE;
+            edit.len = op_is_range(op) ? op->len : 1u;
+            uint8_t *dst = buffer->scratch + rendered;
+            gap_read(buffer, pos, dst, edit.len);
+            if (op_is_range(op)) {
+                range_write(plan, op, dst, dst);
+            } else {
+                *dst = apply_point(op, *dst);
+            }
+            rendered += edit.len;
+            edit.src = dst;
+        }
+        if (edit.kind != 0 && st == CA_STATUS_OK) {
+            saved += edit.len;
+            st = gap_push_edit(buffer, edit);
+        }
+        i = group_end;
+    }
+    if (st == CA_STATUS_OK && delete_from < cursor) {
+        st = gap_push_edit(buffer, (mutation_gap_edit_t){
+                                       .kind = GAP_EDIT_DELETE,
+                                       .pos = delete_from,
+                                       .len = cursor - delete_from,
+                                       .saved_offset = saved,
+                                   });
+    }
+    if (st != CA_STATUS_OK) {
+        buffer->edit_count = 0;
+        return st;
+    }
+
+    bool any = false;
+    for (size_t e = buffer->edit_count; e-- > 0;) {
+        mutation_gap_edit_t *edit = &buffer->edits[e];
+        uint8_t *old = buffer->saved + edit->saved_offset;
+        if (edit->kind == GAP_EDIT_REPLACE) {
+            gap_read(buffer, edit->pos, old, edit->len);
+            gap_write(buffer, edit->pos, edit->src, edit->len);
+            // Bytes inside the span are judged by the span comparison below.
+            if (!compare_span || edit->pos + edit->len <= span_begin ||
+                edit->pos >= span_end) {
+                any = any || memcmp(old, edit->src, edit->len) != 0;
+            }
+        } else if (edit->kind == GAP_EDIT_DELETE) {
+            gap_move(buffer, edit->pos);
+            memcpy(old, buffer->data + buffer->gap_end, edit->len);
+            buffer->gap_end += edit->len;
+            buffer->len -= edit->len;
+        } else {
+            gap_move(buffer, edit->pos);
+            memcpy(buffer->data + buffer->gap_start, edit->src, edit->len);
+            buffer->gap_start += edit->len;
+            buffer->len += edit->len;
+        }
+    }
+
+    if (buffer->len != input_len) {
+        any = true;
+    } else if (compare_span && !any) {
+        for (size_t pos = span_begin; pos < span_end && !any;) {
+            size_t run = 0;
+            size_t at = gap_locate(buffer, pos, &run);
+            if (run > span_end - pos) run = span_end - pos;
+            any = memcmp(buffer->data + at, original + (pos - span_begin), run) != 0;
+            pos += run;
+        }
+    }
+    *changed = any;
+    return CA_STATUS_OK;
+}
+
+void mutation_gap_buffer_revert(mutation_gap_buffer_t *buffer) {
+    if (!buffer) return;
+    // Edits ran from the last one down, so they are undone from the first one up.
+    for (size_t e = 0; e < buffer->edit_count; ++e) {
+        const mutation_gap_edit_t *edit = &buffer->edits[e];
+        uint8_t *old = buffer->saved + edit->saved_offset;
+        if (edit->kind == GAP_EDIT_REPLACE) {
+            gap_write(buffer, edit->pos, old, edit->len);
+        } else if (edit->kind == GAP_EDIT_DELETE) {
+            gap_move(buffer, edit->pos);
+            memcpy(buffer->data + buffer->gap_start, old, edit->len);
+            buffer->gap_start += edit->len;
+            buffer->len += edit->len;
+        } else {
+            gap_move(buffer, edit->pos);
+            buffer->gap_end += edit->len;
+            buffer->len -= edit->len;
+        }
+    }
+    buffer->edit_count = 0;
+}
+
+size_t mutation_gap_buffer_view(const mutation_gap_buffer_t *buffer,
+                                mutation_segment_t segments[2]) {
+    if (!buffer || !segments) return 0;
+    size_t count = 0;
+    if (buffer->gap_start > 0) {
+        segments[count++] = (mutation_segment_t){.data = buffer->data,
+                                                 .len = buffer->gap_start};
+    }
+    if (buffer->gap_end < buffer->capacity) {
+        segments[count++] = (mutation_segment_t){.data = buffer->data + buffer->gap_end,
+                                                 .len = buffer->capacity - buffer->gap_end};
+    }
+    return count;
+}
+
+const uint8_t *mutation_gap_buffer_flatten(mutation_gap_buffer_t *buffer) {
+    if (!buffer) return NULL;
+    gap_move(buffer, buffer->len);
+    return buffer->data;
+}
+
+void mutation_gap_buffer_free(mutation_gap_buffer_t *buffer) {
+    if (!buffer) return;
+    free(buffer->data);
+    free(buffer->edits);
+    free(buffer->saved);
+    free(buffer->scratch);
+    *buffer = (mutation_gap_buffer_t){0};
+}
+
+// Plan composition works on piece lists describing a plan's output in order: runs
+// of untouched input bytes, single input bytes with a point op, and literal bytes
+// held in a scratch arena.
+typedef enum {
+    PIECE_INPUT = 0,
+    PIECE_POINT = 1,
+    PIECE_LITERAL = 2,
+} plan_piece_kind_t;
+
+typedef struct {
+    // Input position (INPUT, POINT) or arena offset (LITERAL).
+    uint32_t pos;
+    uint32_t len;
+    uint8_t kind;
+    // POINT: the op applied to input[pos].
+    uint8_t op_kind;
+    uint8_t op_arg;
+} plan_piece_t;
+
+typedef struct {
+    plan_piece_t *items;
+    size_t count;
+    size_t capacity;
+} piece_list_t;
+
+typedef struct {
+    const piece_list_t *list;
+    size_t index;
+    uint32_t skip;
+} piece_cursor_t;
+
+static ca_status_t pieces_push(piece_list_t *list, plan_piece_t piece) {
+    if (piece.len == 0) return CA_STATUS_OK;
+    if (list->count > 0 && piece.kind != PIECE_POINT) {
+        plan_piece_t *last = &list->items[list->count - 1];
+        if (last->kind == piece.kind && (uint64_t)last->pos + last->len == piece.pos) {
+            last->len += piece.len;
+            return CA_STATUS_OK;
+        }
+    }
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2u : 16u;
+        plan_piece_t *next =
+            (plan_piece_t *)realloc(list->items, capacity * sizeof(*list->items));
+        if (!next) return CA_STATUS_OUT_OF_MEMORY;
+        list->items = next;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = piece;
+    return CA_STATUS_OK;
+}
+
+// Describes `plan` applied to an input of `input_len` bytes. Literal offsets are the
+// plan's own `extra_bytes` offsets; bytes written by copy and range ops are
+// materialized at `*arena_len` in `arena`, which needs `input` unless they are fills
+// or integer sets.
+static ca_status_t pieces_from_plan(const normalized_plan_t *plan, const uint8_t *input,
+                                    size_t input_len, uint8_t *arena, size_t *arena_len,
+                                    piece_list_t *out) {
+    ca_status_t st = CA_STATUS_OK;
+    size_t cursor = 0;
+    size_t i = 0;
+    while (i < plan->op_count && st == CA_STATUS_OK) {
+        uint32_t pos = plan->ops[i].pos;
+        size_t group_end = i;
+        while (group_end < plan->op_count && plan->ops[group_end].pos == pos) ++group_end;
+
+        if (pos > cursor) {
+            st = pieces_push(out, (plan_piece_t){.pos = (uint32_t)cursor,
+                                                 .len = (uint32_t)(pos - cursor),
+                                                 .kind = PIECE_INPUT});
+            cursor = pos;
+        }
+        for (size_t j = i; j < group_end && st == CA_STATUS_OK; ++j) {
+            const mutation_op_t *op = &plan->ops[j];
+            if (!op_is_insert(op)) continue;
+            uint32_t offset = op->data_offset;
+            if (op->kind != CA_OP_INSERT_BYTES) {
+                if (op->kind == CA_OP_COPY_RANGE && !input) {
+                    return CA_STATUS_INVALID_ARGUMENT;
+                }
+                offset = (uint32_t)*arena_len;
+                memcpy(arena + offset, insert_source(plan, input, op), op->len);
+                *arena_len += op->len;
+            }
+            st = pieces_push(out, (plan_piece_t){.pos = offset, .len = op->len,
+                                                 .kind = PIECE_LITERAL});
+            break;
+        }
+        const mutation_op_t *op = group_byte_op(plan->ops, i, group_end);
+        if (st != CA_STATUS_OK || !op) {
+            // Nothing decides this byte.
+        } else if (op->kind == CA_OP_DELETE_RANGE) {
+            if ((size_t)op->pos + op->len > cursor) cursor = (size_t)op->pos + op->len;
+        } else if (op_is_range(op)) {
+            if (!input && range_reads_input(op)) return CA_STATUS_INVALID_ARGUMENT;
+            range_write(plan, op, input ? input + pos : NULL, arena + *arena_len);
+            st = pieces_push(out, (plan_piece_t){.pos = (uint32_t)*arena_len,
+                                                 .len = op->len, .kind = PIECE_LITERAL});
+            *arena_len += op->len;
+            cursor = (size_t)pos + op->len;
+        } else if (pos >= cursor) {
+            st = pieces_push(out, (plan_piece_t){.pos = pos, .len = 1,
+                                                 .kind = PIECE_POINT,
+                                                 .op_kind = op->kind,
+                                                 .op_arg = op->arg});
+            cursor = (size_t)pos + 1u;
+        }
+        i = group_end;
+    }
+    if (st == CA_STATUS_OK && input_len > cursor) {
+        st = pieces_push(out, (plan_piece_t){.pos = (uint32_t)cursor,
+                                             .len = (uint32_t)(input_len - cursor),
+                                             .kind = PIECE_INPUT});
+    }
+    return st;
+}
+
+// Moves the next `n` output bytes under `cursor` to `out`, or drops them when `out`
+// is NULL.
+static ca_status_t pieces_take(piece_cursor_t *cursor, size_t n, piece_list_t *out) {
+    while (n > 0) {
+        if (cursor->index >= cursor->list->count) return CA_STATUS_INVALID_ARGUMENT;
+        const plan_piece_t *piece = &cursor->list->items[cursor->index];
+        uint32_t avail = piece->len - cursor->skip;
+        uint32_t take = n < avail ? (uint32_t)n : avail;
+        if (out) {
+            plan_piece_t part = *piece;
+            part.pos += cursor->skip;
+            part.len = take;
+            ca_status_t st = pieces_push(out, part);
+            if (st != CA_STATUS_OK) return st;
+        }
+        cursor->skip += take;
+        n -= take;
+        if (cursor->skip == piece->len) {
+            ++cursor->index;
+            cursor->skip = 0;
+        }
+    }
+    return CA_STATUS_OK;
+}
+
+// Folds `second`, applied after `first` to the byte at `pos`, into `*result`; a zero
+// kind means the pair cancels. Pairs without a single-op form become SET_BYTE, which
+// needs `input`.
+static bool fold_points(const mutation_op_t *first, const mutation_op_t *second,
+                        const uint8_t *input, uint32_t pos, mutation_op_t *result) {
+    *result = *second;
+    if (second->kind == CA_OP_SET_BYTE) {
+        // Keeps `second` as is.
+    } else if (first->kind == CA_OP_SET_BYTE) {
+        result->kind = CA_OP_SET_BYTE;
+        result->arg = apply_point(second, first->arg);
+    } else if (first->kind == CA_OP_BIT_FLIP && second->kind == CA_OP_BIT_FLIP &&
+               ((first->arg ^ second->arg) & 7u) == 0) {
+        result->kind = 0;
+    } else if (first->kind != CA_OP_BIT_FLIP && second->kind != CA_OP_BIT_FLIP) {
+        // ADD/SUB pairs: one net delta.
+        uint8_t delta = (uint8_t)(apply_point(second, apply_point(first, 0u)));
+        result->kind = delta == 0u ? 0u : CA_OP_ADD_BYTE;
+        result->arg = delta;
+    } else if (input) {
+        result->kind = CA_OP_SET_BYTE;
+        result->arg = apply_point(second, apply_point(first, input[pos]));
+    } else {
+        return false;
+    }
+    if (result->kind == CA_OP_SET_BYTE && input && input[pos] == result->arg) {
+        result->kind = 0;
+    }
+    return true;
+}
+
+// Applies point op `op` to the next output byte under `cursor` and moves it to `out`.
+// Literal bytes are patched in `arena` directly.
+static ca_status_t pieces_take_point(piece_cursor_t *cursor, const mutation_op_t *op,
+                                     uint8_t *arena, const uint8_t *input,
+                                     piece_list_t *out) {
+    if (cursor->index >= cursor->list->count) return CA_STATUS_INVALID_ARGUMENT;
+    plan_piece_t piece = cursor->list->items[cursor->index];
+    piece.pos += cursor->skip;
+    piece.len = 1;
+
+    if (piece.kind == PIECE_LITERAL) {
+        arena[piece.pos] = apply_point(op, arena[piece.pos]);
+    } else {
+        mutation_op_t folded = *op;
+        if (piece.kind == PIECE_POINT) {
+            mutation_op_t first = {.kind = piece.op_kind, .arg = piece.op_arg};
+            if (!fold_points(&first, op, input, piece.pos, &folded)) {
+                return CA_STATUS_INVALID_ARGUMENT;
+            }
+        } else if (op->kind == CA_OP_SET_BYTE && input && input[piece.pos] == op->arg) {
+            folded.kind = 0;
+        }
+        piece.kind = folded.kind == 0 ? PIECE_INPUT : PIECE_POINT;
+        piece.op_kind = folded.kind;
+        piece.op_arg = folded.arg;
+    }
+    ca_status_t st = pieces_take(cursor, 1, NULL);
+    if (st != CA_STATUS_OK) return st;
+    return pieces_push(out, piece);
+}
+
+// Emits the literal bytes gathered in `pending` as one insert at `pos`.
+static ca_status_t pieces_flush_insert(normalized_plan_t *plan, uint32_t pos,
+                                       const uint8_t *pending, size_t *pending_len) {
+    if (*pending_len == 0) return CA_STATUS_OK;
+    mutation_op_t op = {.pos = pos, .len = (uint32_t)*pending_len,
+                        .kind = CA_OP_INSERT_BYTES};
+    mutation_op_rank_t rank = {.score = 0, .source_index = (uint32_t)plan->op_count + 1u};
+    *pending_len = 0;
+    return append_to_plan(plan, op, rank, pending);
+}
+
+// Turns a piece list over the input into plan ops in position order: gaps between
+// input pieces become deletes, literal runs become one insert at the next input
+// position (the start of the gap, if any), and POINT pieces keep their op.
+static ca_status_t pieces_emit(const piece_list_t *pieces, const uint8_t *arena,
+                               size_t input_len, uint8_t *pending,
+                               normalized_plan_t *plan) {
+    ca_status_t st = CA_STATUS_OK;
+    size_t pending_len = 0;
+    size_t cursor = 0;
+    for (size_t i = 0; i < pieces->count && st == CA_STATUS_OK; ++i) {
+        const plan_piece_t *piece = &pieces->items[i];
+        if (piece->kind == PIECE_LITERAL) {
+            memcpy(pending + pending_len, arena + piece->pos, piece->len);
+            pending_len += piece->len;
+            continue;
+        }
+        st = pieces_flush_insert(plan, (uint32_t)cursor, pending, &pending_len);
+        if (st == CA_STATUS_OK && piece->pos > cursor) {
+            mutation_op_t del = {.pos = (uint32_t)cursor,
+                                 .len = (uint32_t)(piece->pos - cursor),
+                                 .kind = CA_OP_DELETE_RANGE};
+            st = append_to_plan(plan, del,
+                                (mutation_op_rank_t){0, (uint32_t)plan->op_count + 1u},
+                                NULL);
+        }
+        if (st == CA_STATUS_OK && piece->kind == PIECE_POINT) {
+            mutation_op_t point = {.pos = piece->pos, .len = 1, .kind = piece->op_kind,
+                                   .arg = piece->op_arg};
+            st = append_to_plan(plan, point,
+                                (mutation_op_rank_t){0, (uint32_t)plan->op_count + 1u},
+                                NULL);
+        }
+        cursor = (size_t)piece->pos + piece->len;
+    }
+    if (st == CA_STATUS_OK) {
+        st = pieces_flush_insert(plan, (uint32_t)cursor, pending, &pending_len);
+    }
+    if (st == CA_STATUS_OK && input_len > cursor) {
+        mutation_op_t del = {.pos = (uint32_t)cursor, .len = (uint32_t)(input_len - cursor),
+                             .kind = CA_OP_DELETE_RANGE};
+        st = append_to_plan(plan, del,
+                            (mutation_op_rank_t){0, (uint32_t)plan->op_count + 1u}, NULL);
+    }
+    return st;
+}
+
+// Sums the bytes compose materializes for `plan`'s copy, splice and range ops, and
+// reports whether any of them reads the bytes the plan applies to (copies, XOR
+// ranges and integer adds and subs).
+static ca_status_t compose_scan_ranges(const normalized_plan_t *plan, size_t *bytes,
+                                       bool *reads) {
+    *bytes = 0;
+    *reads = false;
+    for (size_t i = 0; i < plan->op_count; ++i) {
+        const mutation_op_t *op = &plan->ops[i];
+        if (!op_is_range(op) && op->kind != CA_OP_COPY_RANGE &&
+            op->kind != CA_OP_INSERT_FROM_ADD) {
+            continue;
+        }
+        if (op_is_range(op) && !range_is_clear(plan, op)) return CA_STATUS_INVALID_ARGUMENT;
+        if (size_add_overflow(*bytes, op->len, bytes)) return CA_STATUS_OUTPUT_TOO_LARGE;
+        *reads = *reads || op->kind == CA_OP_COPY_RANGE || range_reads_input(op);
+    }
+    return CA_STATUS_OK;
+}
+
+ca_status_t mutation_plan_compose(const normalized_plan_t *a, const normalized_plan_t *b,
+                                 const uint8_t *input, size_t input_len,
+                                 normalized_plan_t *result) {
+    if (!a || !b || !result) return CA_STATUS_INVALID_ARGUMENT;
+    if (result->ops || result->ranks || result->extra_bytes) {
+        normalized_plan_free(result);
+    }
+    *result = (normalized_plan_t){0};
+
+    size_t a_len = 0;
+    size_t c_len = 0;
+    ca_status_t st = mutation_plan_measure(a, input_len, &a_len);
+    if (st != CA_STATUS_OK) return st;
+    st = mutation_plan_measure(b, a_len, &c_len);
+    if (st != CA_STATUS_OK) return st;
+    size_t a_range = 0;
+    size_t b_range = 0;
+    bool a_reads = false;
+    bool b_reads = false;
+    st = compose_scan_ranges(a, &a_range, &a_reads);
+    if (st == CA_STATUS_OK) st = compose_scan_ranges(b, &b_range, &b_reads);
+    if (st != CA_STATUS_OK) return st;
+    // Copy and range ops come out as literal bytes, which need the input unless they
+    // are fills or integer sets; `b`'s read `a`'s output, applied once up front.
+    if ((a_reads || b_reads) && !input) return CA_STATUS_INVALID_ARGUMENT;
+    if (input_len > UINT32_MAX || a_len > UINT32_MAX ||
+        a->extra_bytes_len > UINT32_MAX - b->extra_bytes_len ||
+        a_range > UINT32_MAX - a->extra_bytes_len - b->extra_bytes_len ||
+        b_range > UINT32_MAX - a->extra_bytes_len - b->extra_bytes_len - a_range) {
+        return CA_STATUS_OUTPUT_TOO_LARGE;
+    }
+
+    // The arena starts as a copy of `a`'s payload, so its literal offsets carry over;
+    // `b`'s payload and materialized bytes are appended as they are reached.
+    const size_t arena_cap = a->extra_bytes_len + b->extra_bytes_len + a_range + b_range;
+    size_t arena_len = a->extra_bytes_len;
+    uint8_t *arena = (uint8_t *)malloc(arena_cap + 1u);
+    uint8_t *pending = (uint8_t *)malloc(arena_cap + 1u);
+    uint8_t *a_out = b_reads ? (uint8_t *)malloc(a_len + 1u) : NULL;
+    piece_list_t first = {0};
+    piece_list_t composed = {0};
+    if (!arena || !pending || (b_reads && !a_out)) st = CA_STATUS_OUT_OF_MEMORY;
+    if (st == CA_STATUS_OK && b_reads) {
+        size_t written = 0;
+        st = mutation_plan_apply(a, input, input_len, a_out, a_len, &written, NULL);
+    }
+    if (st == CA_STATUS_OK) {
+        if (a->extra_bytes_len > 0) memcpy(arena, a->extra_bytes, a->extra_bytes_len);
+        st = pieces_from_plan(a, input, input_len, arena, &arena_len, &first);
+    }
+
+    // Walks `b` over `a`'s output, mirroring mutation_plan_segments.
+    piece_cursor_t cursor = {.list = &first};
+    size_t q = 0;
+    size_t i = 0;
+    while (st == CA_STATUS_OK && i < b->op_count) {
+        uint32_t pos = b->ops[i].pos;
+        size_t group_end = i;
+        while (group_end < b->op_count && b->ops[group_end].pos == pos) ++group_end;
+
+        if (pos > q) {
+            st = pieces_take(&cursor, pos - q, &composed);
+            q = pos;
+        }
+        for (size_t j = i; j < group_end && st == CA_STATUS_OK; ++j) {
+            const mutation_op_t *op = &b->ops[j];
+            if (!op_is_insert(op)) continue;
+            memcpy(arena + arena_len, insert_source(b, a_out, op), op->len);
+            st = pieces_push(&composed, (plan_piece_t){.pos = (uint32_t)arena_len,
+                                                       .len = op->len,
+                                                       .kind = PIECE_LITERAL});
+            arena_len += op->len;
+            break;
+        }
+        const mutation_op_t *op = group_byte_op(b->ops, i, group_end);
+        if (st != CA_STATUS_OK || !op) {
+            // Nothing decides this byte.
+        } else if (op->kind == CA_OP_DELETE_RANGE) {
+            size_t end = (size_t)op->pos + op->len;
+            if (end > q) {
+                st = pieces_take(&cursor, end - q, NULL);
+                q = end;
+            }
+        } else if (op_is_range(op)) {
+            // Clear ranges never start inside a delete, so `pos == q` here.
+            range_write(b, op, a_out ? a_out + pos : NULL, arena + arena_len);
+            st = pieces_push(&composed, (plan_piece_t){.pos = (uint32_t)arena_len,
+                                                       .len = op->len,
+                                                       .kind = PIECE_LITERAL});
+            arena_len += op->len;
+            if (st == CA_STATUS_OK) st = pieces_take(&cursor, op->len, NULL);
+            q = (size_t)pos + op->len;
+        } else if (pos >= q) {
+            st = pieces_take_point(&cursor, op, arena, input, &composed);
+            q = (size_t)pos + 1u;
+        }
+        i = group_end;
+    }
+    if (st == CA_STATUS_OK && a_len > q) st = pieces_take(&cursor, a_len - q, &composed);
+
+    if (st == CA_STATUS_OK) st = pieces_emit(&composed, arena, input_len, pending, result);
+    if (st == CA_STATUS_OK) {
+        size_t check_len = 0;
+        st = mutation_plan_measure(result, input_len, &check_len);
+        if (st == CA_STATUS_OK && check_len != c_len) st = CA_STATUS_INTERNAL_ERROR;
+    }
+
+    free(first.items);
+    free(composed.items);
+    free(arena);
+    free(pending);
+    free(a_out);
+    if (st != CA_STATUS_OK) normalized_plan_free(result);
+    return st;
+}
+
+// Plan-from-diff tuning. Regions up to DIFF_DP_SPAN bytes (old plus new) get an
+// exact Myers pass with at most DIFF_MAX_EDITS inserted or deleted bytes; larger
+// ones, and ones past that budget, are split at DIFF_BLOCK_SIZE-byte blocks found
+// in both buffers and the gaps diffed again.
+#define DIFF_BLOCK_SIZE 32u
+#define DIFF_DP_SPAN (64u * 1024u)
+#define DIFF_MAX_EDITS 256u
+// Equal-length replacements up to this many bytes become SET_BYTE ops; longer ones
+// a delete plus an insert, which is two ops at any length.
+#define DIFF_MAX_SET_RUN 2u
+
+typedef struct {
+    const uint8_t *old;
+    const uint8_t *new_buf;
+    piece_list_t pieces;
+    // Myers state: V per edit count, stored back to back ((max_d + 1)^2 entries).
+    int32_t *trace;
+    // Edit runs of one Myers pass, collected back to front.
+    struct {
+        uint8_t kind;
+        uint32_t len;
+    } *runs;
+    size_t run_count;
+    size_t run_capacity;
+} diff_ctx_t;
+
+enum { DIFF_RUN_EQUAL = 0, DIFF_RUN_DELETE = 1, DIFF_RUN_INSERT = 2 };
+
+// Replaces old[o, o + on) with new[n, n + nm).
+static ca_status_t diff_push_replace(diff_ctx_t *ctx, size_t o, size_t on, size_t n,
+                                     size_t nm) {
+    ca_status_t st = CA_STATUS_OK;
+    if (on == nm && on <= DIFF_MAX_SET_RUN) {
+        for (size_t k = 0; k < on && st == CA_STATUS_OK; ++k) {
+            uint8_t value = ctx->new_buf[n + k];
+            plan_piece_t piece = {.pos = (uint32_t)(o + k), .len = 1, .kind = PIECE_INPUT};
+            if (ctx->old[o + k] != value) {
+                piece.kind = PIECE_POINT;
+                piece.op_kind = CA_OP_SET_BYTE;
+                piece.op_arg = value;
+            }
+            st = pieces_push(&ctx->pieces, piece);
+        }
+        return st;
+    }
+    // The skipped old bytes become a delete when the pieces are emitted.
+    return pieces_push(&ctx->pieces, (plan_piece_t){.pos = (uint32_t)n, .len = (uint32_t)nm,
+                                                    .kind = PIECE_LITERAL});
+}
+
+static ca_status_t diff_push_run(diff_ctx_t *ctx, uint8_t kind, size_t len) {
+    if (len == 0) return CA_STATUS_OK;
+    if (ctx->run_count > 0 && ctx->runs[ctx->run_count - 1].kind == kind) {
+        ctx->runs[ctx->run_count - 1].len += (uint32_t)len;
+        return CA_STATUS_OK;
+    }
+    if (ctx->run_count == ctx->run_capacity) {
+        size_t capacity = ctx->run_capacity ? ctx->run_capacity * 2u : 64u;
+        void *next = realloc(ctx->runs, capacity * sizeof(*ctx->runs));
+        if (!next) return CA_STATUS_OUT_OF_MEMORY;
+        ctx->runs = next;
+        ctx->run_capacity = capacity;
+    }
+    ctx->runs[ctx->run_count].kind = kind;
+    ctx->runs[ctx->run_count].len = (uint32_t)len;
+    ++ctx->run_count;
+    return CA_STATUS_OK;
+}
+
+// Myers' O(ND) diff of old[o, o + n) against new[b, b + m), appended to the pieces.
+// Returns CA_STATUS_SKIP, with nothing appended, when it needs more than
+// DIFF_MAX_EDITS edits.
+static ca_status_t diff_myers(diff_ctx_t *ctx, size_t o, size_t n, size_t b, size_t m) {
+    const uint8_t *x_buf = ctx->old + o;
+    const uint8_t *y_buf = ctx->new_buf + b;
+    const int32_t max_d = (int32_t)DIFF_MAX_EDITS;
+    int32_t *v = ctx->trace;
+    int32_t found = -1;
+
+    // Row d holds V[k] for k in [-d, d] from offset d * d; `row` and `prev` point at
+    // the k = 0 entries of rows d and d - 1.
+    for (int32_t d = 0; d <= max_d && found < 0; ++d) {
+        int32_t *row = v + (size_t)d * (size_t)d + d;
+        const int32_t *prev = d > 0 ? v + (size_t)(d - 1) * (size_t)(d - 1) + (d - 1) : NULL;
+        for (int32_t k = -d; k <= d; k += 2) {
+            int32_t x;
+            if (d == 0) {
+                x = 0;
+            } else if (k == -d || (k != d && prev[k - 1] < prev[k + 1])) {
+                x = prev[k + 1];
+            } else {
+                x = prev[k - 1] + 1;
+            }
+            int32_t y = x - k;
+            while ((size_t)x < n && y >= 0 && (size_t)y < m && x_buf[x] == y_buf[y]) {
+                ++x;
+                ++y;
+            }
+            row[k] = x;
+            if ((size_t)x >= n && y >= 0 && (size_t)y >= m) {
+                found = d;
+                break;
+            }
+        }
+    }
+    if (found < 0) return CA_STATUS_SKIP;
+
+    // Walk back from (n, m), collecting runs back to front.
+    ca_status_t st = CA_STATUS_OK;
+    ctx->run_count = 0;
+    int32_t x = (int32_t)n;
+    int32_t y = (int32_t)m;
+    for (int32_t d = found; d > 0 && st == CA_STATUS_OK; --d) {
+        const int32_t *prev = v + (size_t)(d - 1) * (size_t)(d - 1) + (d - 1);
+        int32_t k = x - y;
+        bool down = k == -d || (k != d && prev[k - 1] < prev[k + 1]);
+        int32_t prev_k = down ? k + 1 : k - 1;
+        int32_t prev_x = prev[prev_k];
+        int32_t prev_y = prev_x - prev_k;
+        int32_t mid_x = down ? prev_x : prev_x + 1;
+        st = diff_push_run(ctx, DIFF_RUN_EQUAL, (size_t)(x - mid_x));
+        if (st == CA_STATUS_OK) {
+            st = diff_push_run(ctx, down ? DIFF_RUN_INSERT : DIFF_RUN_DELETE, 1);
+        }
+        x = prev_x;
+        y = prev_y;
+    }
+    if (st == CA_STATUS_OK) st = diff_push_run(ctx, DIFF_RUN_EQUAL, (size_t)x);
+
+    // Replay front to back; deletes and inserts between two equal runs form one
+    // replacement.
+    size_t oi = o;
+    size_t bi = b;
+    size_t del = 0;
+    size_t ins = 0;
+    for (size_t r = ctx->run_count; r > 0 && st == CA_STATUS_OK; --r) {
+        size_t len = ctx->runs[r - 1].len;
+        if (ctx->runs[r - 1].kind == DIFF_RUN_DELETE) {
+            del += len;
+            continue;
+        }
+        if (ctx->runs[r - 1].kind == DIFF_RUN_INSERT) {
+            ins += len;
+            continue;
+        }
+        st = diff_push_replace(ctx, oi, del, bi, ins);
+        oi += del;
+        bi += ins;
+        del = ins = 0;
+        if (st == CA_STATUS_OK) {
+            st = pieces_push(&ctx->pieces, (plan_piece_t){.pos = (uint32_t)oi,
+                                                          .len = (uint32_t)len,
+                                                          .kind = PIECE_INPUT});
+        }
+        oi += len;
+        bi += len;
+    }
+    if (st == CA_STATUS_OK) st = diff_push_replace(ctx, oi, del, bi, ins);
+    return st;
+}
+
+static ca_status_t diff_anchored(diff_ctx_t *ctx, size_t o, size_t n, size_t b, size_t m);
+
+// Diffs old[o, o + n) against new[b, b + m): shared prefix and suffix are kept,
+// and the rest goes through Myers. Past its budget the middle is split at shared
+// blocks by diff_anchored, and only a middle without any becomes one replacement.
+static ca_status_t diff_region(diff_ctx_t *ctx, size_t o, size_t n, size_t b, size_t m) {
+    size_t prefix = 0;
+    while (prefix < n && prefix < m && ctx->old[o + prefix] == ctx->new_buf[b + prefix]) {
+        ++prefix;
+    }
+    size_t suffix = 0;
+    while (suffix < n - prefix && suffix < m - prefix &&
+           ctx->old[o + n - 1 - suffix] == ctx->new_buf[b + m - 1 - suffix]) {
+        ++suffix;
+    }
+
+    ca_status_t st = pieces_push(&ctx->pieces, (plan_piece_t){.pos = (uint32_t)o,
+                                                              .len = (uint32_t)prefix,
+                                                              .kind = PIECE_INPUT});
+    size_t mid_o = o + prefix;
+    size_t mid_n = n - prefix - suffix;
+    size_t mid_b = b + prefix;
+    size_t mid_m = m - prefix - suffix;
+    if (st == CA_STATUS_OK && mid_n > 0 && mid_m > 0) {
+        st = mid_n + mid_m <= DIFF_DP_SPAN ? diff_myers(ctx, mid_o, mid_n, mid_b, mid_m)
+                                           : CA_STATUS_SKIP;
+        if (st == CA_STATUS_SKIP) st = diff_anchored(ctx, mid_o, mid_n, mid_b, mid_m);
+        if (st == CA_STATUS_SKIP) st = diff_push_replace(ctx, mid_o, mid_n, mid_b, mid_m);
+    } else if (st == CA_STATUS_OK) {
+        st = diff_push_replace(ctx, mid_o, mid_n, mid_b, mid_m);
+    }
+    if (st == CA_STATUS_OK) {
+        st = pieces_push(&ctx->pieces, (plan_piece_t){.pos = (uint32_t)(o + n - suffix),
+                                                      .len = (uint32_t)suffix,
+                                                      .kind = PIECE_INPUT});
+    }
+    return st;
+}
+
+static uint64_t diff_block_hash(const uint8_t *data) {
+    uint64_t hash = 0;
+    for (size_t i = 0; i < DIFF_BLOCK_SIZE; ++i) hash = hash * 1099511628211ULL + data[i];
+    return hash;
+}
+
+// Diffs old[o, o + n) against new[b, b + m) by anchoring on DIFF_BLOCK_SIZE-byte
+// blocks of `old` found in `new` with a rolling hash. Anchors only move forward in
+// both buffers, so each gap between them is diffed on its own with diff_region; the
+// gaps are smaller than the region and may be anchored again. Returns
+// CA_STATUS_SKIP, with nothing appended, when no block is shared.
+static ca_status_t diff_anchored(diff_ctx_t *ctx, size_t o, size_t n, size_t b, size_t m) {
+    size_t blocks = n / DIFF_BLOCK_SIZE;
+    if (blocks == 0 || m < DIFF_BLOCK_SIZE) return CA_STATUS_SKIP;
+
+    size_t capacity = 64u;
+    while (capacity < blocks * 2u) capacity *= 2u;
+    uint64_t *hashes = (uint64_t *)malloc(capacity * sizeof(*hashes));
+    // Block start + 1; 0 marks an empty slot.
+    uint32_t *starts = (uint32_t *)calloc(capacity, sizeof(*starts));
+    if (!hashes || !starts) {
+        free(hashes);
+        free(starts);
+        return CA_STATUS_OUT_OF_MEMORY;
+    }
+    for (size_t i = 0; i < blocks; ++i) {
+        uint64_t hash = diff_block_hash(ctx->old + o + i * DIFF_BLOCK_SIZE);
+        size_t slot = (size_t)(hash ^ (hash >> 29)) & (capacity - 1u);
+        while (starts[slot] != 0) slot = (slot + 1u) & (capacity - 1u);
+        hashes[slot] = hash;
+        starts[slot] = (uint32_t)(o + i * DIFF_BLOCK_SIZE + 1u);
+    }
+
+    uint64_t top = 1;
+    for (size_t i = 1; i < DIFF_BLOCK_SIZE; ++i) top *= 1099511628211ULL;
+
+    const size_t old_end = o + n;
+    const size_t new_end = b + m;
+    ca_status_t st = CA_STATUS_OK;
+    bool anchored = false;
+    size_t old_cursor = o;
+    size_t new_cursor = b;
+    size_t j = b;
+    uint64_t hash = diff_block_hash(ctx->new_buf + b);
+    while (st == CA_STATUS_OK && j + DIFF_BLOCK_SIZE <= new_end) {
+        // Earliest verified block at or after the old cursor.
+        size_t match = SIZE_MAX;
+        size_t slot = (size_t)(hash ^ (hash >> 29)) & (capacity - 1u);
+        for (; starts[slot] != 0; slot = (slot + 1u) & (capacity - 1u)) {
+            size_t start = (size_t)starts[slot] - 1u;
+            if (hashes[slot] != hash || start < old_cursor || start >= match) continue;
+            if (memcmp(ctx->old + start, ctx->new_buf + j, DIFF_BLOCK_SIZE) == 0) {
+                match = start;
+            }
+        }
+        if (match == SIZE_MAX) {
+            if (j + DIFF_BLOCK_SIZE < new_end) {
+                hash = (hash - top * ctx->new_buf[j]) * 1099511628211ULL +
+                       ctx->new_buf[j + DIFF_BLOCK_SIZE];
+            }
+            ++j;
+            continue;
+        }
+
+        size_t begin_old = match;
+        size_t begin_new = j;
+        while (begin_old > old_cursor && begin_new > new_cursor &&
+               ctx->old[begin_old - 1] == ctx->new_buf[begin_new - 1]) {
+            --begin_old;
+            --begin_new;
+        }
+        size_t end_old = match + DIFF_BLOCK_SIZE;
+        size_t end_new = j + DIFF_BLOCK_SIZE;
+        while (end_old < old_end && end_new < new_end &&
+               ctx->old[end_old] == ctx->new_buf[end_new]) {
+            ++end_old;
+            ++end_new;
+        }
+
+        anchored = true;
+        st = diff_region(ctx, old_cursor, begin_old - old_cursor, new_cursor,
+                         begin_new - new_cursor);
+        if (st == CA_STATUS_OK) {
+            plan_piece_t piece = {.pos = (uint32_t)begin_old,
+                                  .len = (uint32_t)(end_old - begin_old),
+                                  .kind = PIECE_INPUT};
+            st = pieces_push(&ctx->pieces, piece);
+        }
+        old_cursor = end_old;
+        new_cursor = end_new;
+        j = end_new;
+        if (j + DIFF_BLOCK_SIZE <= new_end) hash = diff_block_hash(ctx->new_buf + j);
+    }
+    if (st == CA_STATUS_OK && !anchored) st = CA_STATUS_SKIP;
+    if (st == CA_STATUS_OK) {
+        st = diff_region(ctx, old_cursor, old_end - old_cursor, new_cursor,
+                         new_end - new_cursor);
+    }
+    free(hashes);
+    free(starts);
+    return st;
+}
+
+ca_status_t mutation_plan_diff(const uint8_t *old, size_t old_len, const uint8_t *new_buf,
+                              size_t new_len, const ca_plan_limits_t *limits,
+                              normalized_plan_t *result) {
+    if (!result || (old_len != 0 && !old) || (new_len != 0 && !new_buf)) {
+        return CA_STATUS_INVALID_ARGUMENT;
+    }
+    if (result->ops || result->ranks || result->extra_bytes) {
+        normalized_plan_free(result);
+    }
+    *result = (normalized_plan_t){0};
+    if (old_len > UINT32_MAX || new_len > UINT32_MAX) return CA_STATUS_OUTPUT_TOO_LARGE;
+    if (limits && new_len > limits->max_output_len) return CA_STATUS_OUTPUT_TOO_LARGE;
+
+    diff_ctx_t ctx = {.old = old, .new_buf = new_buf};
+    uint8_t *pending = (uint8_t *)malloc(new_len + 1u);
+    ctx.trace = (int32_t *)malloc((size_t)(DIFF_MAX_EDITS + 1u) * (DIFF_MAX_EDITS + 1u) *
+                                  sizeof(*ctx.trace));
+    ca_status_t st = pending && ctx.trace ? CA_STATUS_OK : CA_STATUS_OUT_OF_MEMORY;
+    if (st == CA_STATUS_OK) {
+        st = diff_region(&ctx, 0, old_len, 0, new_len);
+    }
+    if (st == CA_STATUS_OK) {
+        st = pieces_emit(&ctx.pieces, new_buf, old_len, pending, result);
+    }
+
+    // Over the op budget: fall back to one replacement of everything between the
+    // shared prefix and suffix.
+    if (st == CA_STATUS_OK && limits && limits->max_ops != 0 &&
+        result->op_count > limits->max_ops) {
+        normalized_plan_free(result);
+        ctx.pieces.count = 0;
+        size_t prefix = 0;
+        while (prefix < old_len && prefix < new_len && old[prefix] == new_buf[prefix]) {
+            ++prefix;
+        }
+        size_t suffix = 0;
+        while (suffix < old_len - prefix && suffix < new_len - prefix &&
+               old[old_len - 1 - suffix] == new_buf[new_len - 1 - suffix]) {
+            ++suffix;
+        }
+        st = pieces_push(&ctx.pieces, (plan_piece_t){.pos = 0, .len = (uint32_t)prefix,
+                                                     .kind = PIECE_INPUT});
+        if (st == CA_STATUS_OK) {
+            st = pieces_push(&ctx.pieces,
+                             (plan_piece_t){.pos = (uint32_t)prefix,
+                                            .len = (uint32_t)(new_len - prefix - suffix),
+                                            .kind = PIECE_LITERAL});
+        }
+        if (st == CA_STATUS_OK) {
+            st = pieces_push(&ctx.pieces, (plan_piece_t){.pos = (uint32_t)(old_len - suffix),
+                                                         .len = (uint32_t)suffix,
+                                                         .kind = PIECE_INPUT});
+        }
+        if (st == CA_STATUS_OK) {
+            st = pieces_emit(&ctx.pieces, new_buf, old_len, pending, result);
+        }
+        if (st == CA_STATUS_OK && result->op_count > limits->max_ops) {
+            st = CA_STATUS_OUTPUT_TOO_LARGE;
+        }
+    }
+
+    free(ctx.pieces.items);
+    free(ctx.runs);
+    free(ctx.trace);
+    free(pending);
+    if (st != CA_STATUS_OK) normalized_plan_free(result);
+    return st;
+}
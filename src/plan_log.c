@@ -0,0 +1,256 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "plan_log.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define PLAN_LOG_BUFFER_SIZE (64u * 1024u)
+
+static const char kPlanLogMagic[8] = {'C', 'A', 'P', 'L', 'O', 'G', '\0', '\0'};
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t op_size;
+} plan_log_file_header_t;
+
+typedef struct {
+    uint32_t record_len;
+    uint32_t op_count;
+    uint32_t payload_len;
+    uint32_t reserved;
+    uint64_t mutation_id;
+    uint64_t input_hash;
+    uint64_t input_len;
+} plan_log_record_header_t;
+
+_Static_assert(sizeof(plan_log_file_header_t) == 16, "plan log file header is 16 bytes");
+_Static_assert(sizeof(plan_log_record_header_t) == 40,
+               "plan log record header is 40 bytes");
+
+struct plan_log_writer {
+    int fd;
+    uint8_t *buf;
+    size_t len;
+    size_t capacity;
+};
+
+static bool plan_log_header_valid(const plan_log_file_header_t *header) {
+    return memcmp(header->magic, kPlanLogMagic, sizeof(kPlanLogMagic)) == 0 &&
+           header->version == CA_PLAN_LOG_VERSION &&
+           header->op_size == (uint32_t)sizeof(mutation_op_t);
+}
+
+static ca_status_t plan_log_write_all(int fd, const uint8_t *data, size_t len) {
+    while (len > 0) {
+        ssize_t written = write(fd, data, len);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return CA_STATUS_INTERNAL_ERROR;
+        }
+        data += written;
+        len -= (size_t)written;
+    }
+    return CA_STATUS_OK;
+}
+
+uint64_t plan_log_hash(const uint8_t *data, size_t len) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= (uint64_t)data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+ca_status_t plan_log_writer_open(const char *path, plan_log_writer_t **writer) {
+    if (!path || !writer) return CA_STATUS_INVALID_ARGUMENT;
+    *writer = NULL;
+
+    int fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) return CA_STATUS_INVALID_ARGUMENT;
+
+    struct stat st;
+    ca_status_t status = fstat(fd, &st) == 0 ? CA_STATUS_OK : CA_STATUS_INTERNAL_ERROR;
+    if (status == CA_STATUS_OK && st.st_size == 0) {
+        plan_log_file_header_t header = {
+            .version = CA_PLAN_LOG_VERSION,
+            .op_size = (uint32_t)sizeof(mutation_op_t),
+        };
+        memcpy(header.magic, kPlanLogMagic, sizeof(kPlanLogMagic));
+        status = plan_log_write_all(fd, (const uint8_t *)&header, sizeof(header));
+    } else if (status == CA_STATUS_OK) {
+        // Appending to a log from another build would mix record layouts.
+        plan_log_file_header_t header;
+        if (pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+            !plan_log_header_valid(&header)) {
+            status = CA_STATUS_INVALID_ARGUMENT;
+        }
+    }
+
+    plan_log_writer_t *result = NULL;
+    if (status == CA_STATUS_OK) {
+        result = (plan_log_writer_t *)calloc(1, sizeof(*result));
+        uint8_t *buf = (uint8_t *)malloc(PLAN_LOG_BUFFER_SIZE);
+        if (!result || !buf) {
+            free(result);
+            free(buf);
+            result = NULL;
+            status = CA_STATUS_OUT_OF_MEMORY;
+        } else {
+            result->fd = fd;
+            result->buf = buf;
+            result->capacity = PLAN_LOG_BUFFER_SIZE;
+        }
+    }
+    if (status != CA_STATUS_OK) {
+        close(fd);
+        return status;
+    }
+    *writer = result;
+    return CA_STATUS_OK;
+}
+
+ca_status_t plan_log_flush(plan_log_writer_t *writer) {
+    if (!writer) return CA_STATUS_INVALID_ARGUMENT;
+    ca_status_t status = plan_log_write_all(writer->fd, writer->buf, writer->len);
+    writer->len = 0;
+    return status;
+}
+
+ca_status_t plan_log_append(plan_log_writer_t *writer, uint64_t mutation_id,
+                           uint64_t input_hash, size_t input_len,
+                           const normalized_plan_t *plan) {
+    if (!writer || !plan || (plan->op_count > 0 && !plan->ops) ||
+        (plan->extra_bytes_len > 0 && !plan->extra_bytes)) {
+        return CA_STATUS_INVALID_ARGUMENT;
+    }
+
+    const size_t header_len = sizeof(plan_log_record_header_t);
+    if (plan->op_count > (UINT32_MAX - header_len) / sizeof(mutation_op_t)) {
+        return CA_STATUS_OUTPUT_TOO_LARGE;
+    }
+    const size_t ops_len = plan->op_count * sizeof(mutation_op_t);
+    if (plan->extra_bytes_len > UINT32_MAX - 7u - header_len - ops_len) {
+        return CA_STATUS_OUTPUT_TOO_LARGE;
+    }
+    const size_t body_len = header_len + ops_len + plan->extra_bytes_len;
+    const size_t record_len = (body_len + 7u) & ~(size_t)7u;
+
+    if (writer->len + record_len > writer->capacity) {
+        ca_status_t status = plan_log_flush(writer);
+        if (status != CA_STATUS_OK) return status;
+        if (record_len > writer->capacity) {
+            uint8_t *grown = (uint8_t *)realloc(writer->buf, record_len);
+            if (!grown) return CA_STATUS_OUT_OF_MEMORY;
+            writer->buf = grown;
+            writer->capacity = record_len;
+        }
+    }
+
+    plan_log_record_header_t header = {
+        .record_len = (uint32_t)record_len,
+        .op_count = (uint32_t)plan->op_count,
+        .payload_len = (uint32_t)plan->extra_bytes_len,
+        .reserved = 0u,
+        .mutation_id = mutation_id,
+        .input_hash = input_hash,
+        .input_len = (uint64_t)input_len,
+    };
+    uint8_t *out = writer->buf + writer->len;
+    memcpy(out, &header, header_len);
+    if (ops_len > 0) memcpy(out + header_len, plan->ops, ops_len);
+    if (plan->extra_bytes_len > 0) {
+        memcpy(out + header_len + ops_len, plan->extra_bytes, plan->extra_bytes_len);
+    }
+    memset(out + body_len, 0, record_len - body_len);
+    writer->len += record_len;
+    return CA_STATUS_OK;
+}
+
+void plan_log_writer_close(plan_log_writer_t *writer) {
+    if (!writer) return;
+    (void)plan_log_flush(writer);
+    close(writer->fd);
+    free(writer->buf);
+    free(writer);
+}
+
+ca_status_t plan_log_reader_open(const char *path, plan_log_reader_t *reader) {
+    if (!path || !reader) return CA_STATUS_INVALID_ARGUMENT;
+    *reader = (plan_log_reader_t){0};
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return CA_STATUS_INVALID_ARGUMENT;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(plan_log_file_header_t)) {
+        close(fd);
+        return CA_STATUS_INVALID_ARGUMENT;
+    }
+
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return CA_STATUS_INTERNAL_ERROR;
+    // Records are read once, front to back.
+    (void)madvise(base, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    if (!plan_log_header_valid((const plan_log_file_header_t *)base)) {
+        munmap(base, (size_t)st.st_size);
+        return CA_STATUS_INVALID_ARGUMENT;
+    }
+    reader->base = (const uint8_t *)base;
+    reader->size = (size_t)st.st_size;
+    reader->offset = sizeof(plan_log_file_header_t);
+    return CA_STATUS_OK;
+}
+
+ca_status_t plan_log_next(plan_log_reader_t *reader, plan_log_record_t *record) {
+    if (!reader || !record || !reader->base) return CA_STATUS_INVALID_ARGUMENT;
+    if (reader->offset == reader->size) return CA_STATUS_SKIP;
+
+    const size_t remaining = reader->size - reader->offset;
+    const size_t header_len = sizeof(plan_log_record_header_t);
+    if (remaining < header_len) return CA_STATUS_INVALID_ARGUMENT;
+
+    const uint8_t *at = reader->base + reader->offset;
+    const plan_log_record_header_t *header = (const plan_log_record_header_t *)at;
+    const uint64_t body_len = (uint64_t)header_len +
+                              (uint64_t)header->op_count * sizeof(mutation_op_t) +
+                              (uint64_t)header->payload_len;
+    if (header->record_len % 8u != 0 || header->record_len > remaining ||
+        body_len > header->record_len) {
+        return CA_STATUS_INVALID_ARGUMENT;
+    }
+
+    const uint8_t *ops = at + header_len;
+    const size_t ops_len = (size_t)header->op_count * sizeof(mutation_op_t);
+    *record = (plan_log_record_t){
+        .mutation_id = header->mutation_id,
+        .input_hash = header->input_hash,
+        .input_len = header->input_len,
+        .plan = {
+            .ops = header->op_count ? (mutation_op_t *)(uintptr_t)ops : NULL,
+            .ranks = NULL,
+            .op_count = header->op_count,
+            .extra_bytes = header->payload_len ? (uint8_t *)(uintptr_t)(ops + ops_len)
+                                               : NULL,
+            .extra_bytes_len = header->payload_len,
+        },
+    };
+    reader->offset += header->record_len;
+    return CA_STATUS_OK;
+}
+
+void plan_log_reader_close(plan_log_reader_t *reader) {
+    if (!reader) return;
+    if (reader->base) munmap((void *)(uintptr_t)reader->base, reader->size);
+    *reader = (plan_log_reader_t){0};
+}
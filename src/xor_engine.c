@@ -51,11 +51,53 @@ static ca_status_t ca_xor_ensure_capacity(ca_xor_engine_t *engine, size_t need)
     return CA_STATUS_OK;
 }
 
-static ca_status_t ca_xor_mutate(void *impl,
-                                const ca_mutate_request_t *request,
-                                ca_output_t *output) {
-    ca_xor_engine_t *engine = (ca_xor_engine_t *)impl;
-    if (!engine || !request || !output) return CA_STATUS_INVALID_ARGUMENT;
+// One XOR generation from `engine->cur`. Cells below `dst_len` are written to `dst`,
+// the rest to `engine->next`, so the last generation can land directly in a caller
+// buffer; RNG draws are the same either way.
+static void ca_xor_step(ca_xor_engine_t *engine, size_t width, size_t height,
+                        uint8_t *dst, size_t dst_len) {
+    for (size_t row = 0; row < height; ++row) {
+        for (size_t col = 0; col < width; ++col) {
+            size_t idx = row * width + col;
+            uint8_t *cell = idx < dst_len ? &dst[idx] : &engine->next[idx];
+
+            if (ca_xor_rand_below(engine, 4) == 0) {
+                uint8_t bit = (uint8_t)(1u << ca_xor_rand_below(engine, 8));
+                *cell = (uint8_t)(engine->cur[idx] ^ bit);
+                continue;
+            }
+
+            uint8_t xor_sum = 0;
+            for (int dr = -1; dr <= 1; ++dr) {
+                for (int dc = -1; dc <= 1; ++dc) {
+                    if (dr == 0 && dc == 0) continue;
+                    int r = (int)row + dr;
+                    if (r < 0) {
+                        r += (int)height;
+                    } else if ((size_t)r >= height) {
+                        r -= (int)height;
+                    }
+                    int c = (int)col + dc;
+                    if (c < 0) {
+                        c += (int)width;
+                    } else if ((size_t)c >= width) {
+                        c -= (int)width;
+                    }
+                    xor_sum ^= engine->cur[(size_t)r * width + (size_t)c];
+                }
+            }
+            *cell = xor_sum;
+        }
+    }
+}
+
+// Runs the XOR automaton over `request`. With `dst == NULL` the result stays in
+// `engine->cur` and is exposed through `output`; otherwise the last generation is
+// written straight into `dst` (at most `dst_cap` bytes).
+static ca_status_t ca_xor_run(ca_xor_engine_t *engine, const ca_mutate_request_t *request,
+                              uint8_t *dst, size_t dst_cap, ca_output_t *output,
+                              size_t *out_len_out) {
+    if (!engine || !request) return CA_STATUS_INVALID_ARGUMENT;
     if (!request->input && request->input_len != 0) return CA_STATUS_INVALID_ARGUMENT;
     if (!engine->rng.below) return CA_STATUS_INVALID_ARGUMENT;
 
@@ -67,7 +109,13 @@ static ca_status_t ca_xor_mutate(void *impl,
         if (ca_xor_ensure_capacity(engine, 1) != CA_STATUS_OK) {
             return CA_STATUS_OUT_OF_MEMORY;
         }
-        engine->cur[0] = (uint8_t)ca_xor_rand_below(engine, 256u);
+        uint8_t value = (uint8_t)ca_xor_rand_below(engine, 256u);
+        if (dst) {
+            dst[0] = value;
+            *out_len_out = 1;
+            return CA_STATUS_OK;
+        }
+        engine->cur[0] = value;
         engine->last_output.data = engine->cur;
         engine->last_output.len = 1;
         output->kind = CA_OUTPUT_BUFFER;
@@ -103,52 +151,29 @@ static ca_status_t ca_xor_mutate(void *impl,
         memset(engine->cur, 0, total_cells);
     }
 
+    size_t out_len = total_cells;
+    if (max_output_len != 0 && out_len > max_output_len) {
+        out_len = max_output_len;
+    }
+    if (dst && out_len > dst_cap) {
+        out_len = dst_cap;
+    }
+
     uint32_t iterations = 1u + ca_xor_rand_below(engine, 8);
 
     for (uint32_t iter = 0; iter < iterations; ++iter) {
-        for (size_t row = 0; row < height; ++row) {
-            for (size_t col = 0; col < width; ++col) {
-                size_t idx = row * width + col;
-
-                if (ca_xor_rand_below(engine, 4) == 0) {
-                    uint8_t bit = (uint8_t)(1u << ca_xor_rand_below(engine, 8));
-                    engine->next[idx] = (uint8_t)(engine->cur[idx] ^ bit);
-                    continue;
-                }
-
-                uint8_t xor_sum = 0;
-                for (int dr = -1; dr <= 1; ++dr) {
-                    for (int dc = -1; dc <= 1; ++dc) {
-                        if (dr == 0 && dc == 0) continue;
-                        int r = (int)row + dr;
-                        if (r < 0) {
-                            r += (int)height;
-                        } else if ((size_t)r >= height) {
-                            r -= (int)height;
-                        }
-                        int c = (int)col + dc;
-                        if (c < 0) {
-                            c += (int)width;
-                        } else if ((size_t)c >= width) {
-                            c -= (int)width;
-                        }
-                        xor_sum ^= engine->cur[(size_t)r * width + (size_t)c];
-                    }
-                }
-                engine->next[idx] = xor_sum;
-            }
+        if (dst && iter + 1u == iterations) {
+            ca_xor_step(engine, width, height, dst, out_len);
+            *out_len_out = out_len;
+            return CA_STATUS_OK;
         }
+        ca_xor_step(engine, width, height, engine->next, total_cells);
 
         uint8_t *tmp = engine->cur;
         engine->cur = engine->next;
         engine->next = tmp;
     }
 
-    size_t out_len = total_cells;
-    if (max_output_len != 0 && out_len > max_output_len) {
-        out_len = max_output_len;
-    }
-
     engine->last_output.data = engine->cur;
     engine->last_output.len = out_len;
 
@@ -157,6 +182,18 @@ static ca_status_t ca_xor_mutate(void *impl,
     return CA_STATUS_OK;
 }
 
+static ca_status_t ca_xor_mutate(void *impl,
+                                const ca_mutate_request_t *request,
+                                ca_output_t *output) {
+    if (!output) return CA_STATUS_INVALID_ARGUMENT;
+    return ca_xor_run((ca_xor_engine_t *)impl, request, NULL, 0, output, NULL);
+}
+
+static ca_status_t ca_xor_mutate_into(void *impl, const ca_mutate_request_t *request,
+                                     uint8_t *dst, size_t dst_cap, size_t *out_len) {
+    return ca_xor_run((ca_xor_engine_t *)impl, request, dst, dst_cap, NULL, out_len);
+}
+
 ca_status_t ca_engine_create_xor_impl(const ca_engine_config_t *config, ca_rng_t rng,
                                       ca_engine_t **engine) {
     if (!engine) return CA_STATUS_INVALID_ARGUMENT;
@@ -168,7 +205,7 @@ ca_status_t ca_engine_create_xor_impl(const ca_engine_config_t *config, ca_rng_t
     impl->rng = rng;
     impl->capacity = 0;
 
-    ca_engine_t *base = (ca_engine_t *)malloc(sizeof(*base));
+    ca_engine_t *base = (ca_engine_t *)calloc(1, sizeof(*base));
     if (!base) {
         free(impl);
         return CA_STATUS_OUT_OF_MEMORY;
@@ -179,6 +216,7 @@ ca_status_t ca_engine_create_xor_impl(const ca_engine_config_t *config, ca_rng_t
     base->output_kind = CA_OUTPUT_BUFFER;
     base->destroy = ca_xor_destroy;
     base->mutate = ca_xor_mutate;
+    base->mutate_into = ca_xor_mutate_into;
 
     *engine = base;
     return CA_STATUS_OK;
@@ -14,11 +14,17 @@
 
 #include <afl-fuzz.h>
 
+#include "mutation_plan.h"
+
 typedef void *(*afl_custom_init_t)(afl_state_t *afl, unsigned int seed);
 typedef size_t (*afl_custom_fuzz_t)(void *, uint8_t *, size_t, uint8_t **,
                                     uint8_t *, size_t, size_t);
 typedef const char *(*afl_custom_describe_t)(void *, size_t);
 typedef void (*afl_custom_deinit_t)(void *data);
+typedef int (*ca_mutator_last_changed_t)(void *data);
+typedef size_t (*ca_mutator_fuzz_segments_t)(void *, uint8_t *, size_t,
+                                             const mutation_segment_t **, size_t *,
+                                             size_t);
 
 static void init_dummy_afl_rng(afl_state_t *afl, u64 seed) {
     if (!afl) return;
@@ -33,8 +39,7 @@ static void init_dummy_afl_rng(afl_state_t *afl, u64 seed) {
     afl->fixed_seed = 1;
 }
 
-static uint64_t mut_hash64(const uint8_t *data, size_t len) {
-    uint64_t h = 1469598103934665603ULL;
+static uint64_t mut_hash64_update(uint64_t h, const uint8_t *data, size_t len) {
     const uint64_t p = 1099511628211ULL;
     for (size_t i = 0; i < len; ++i) {
         h ^= (uint64_t)data[i];
@@ -43,6 +48,36 @@ static uint64_t mut_hash64(const uint8_t *data, size_t len) {
     return h;
 }
 
+static uint64_t mut_hash64(const uint8_t *data, size_t len) {
+    return mut_hash64_update(1469598103934665603ULL, data, len);
+}
+
+// Same hash as mut_hash64 over the concatenation of `segments`.
+static uint64_t mut_hash64_segments(const mutation_segment_t *segments, size_t count) {
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < count; ++i) {
+        h = mut_hash64_update(h, segments[i].data, segments[i].len);
+    }
+    return h;
+}
+
+static bool write_output(const char *dir, size_t index, const uint8_t *data, size_t len,
+                         const mutation_segment_t *segments, size_t segment_count) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/id:%06zu", dir, index);
+    FILE *out = fopen(path, "wb");
+    if (!out) return false;
+    bool ok = true;
+    if (segments) {
+        for (size_t i = 0; i < segment_count && ok; ++i) {
+            ok = fwrite(segments[i].data, 1, segments[i].len, out) == segments[i].len;
+        }
+    } else {
+        ok = fwrite(data, 1, len, out) == len;
+    }
+    return fclose(out) == 0 && ok;
+}
+
 static void print_prefix_bytes(const uint8_t *data, size_t len) {
     size_t show = len < 32 ? len : 32;
     for (size_t i = 0; i < show; ++i) {
@@ -65,6 +100,7 @@ int main(int argc, char **argv) {
     u64 rng_seed = 0x123456789abcdef0ull;
     const char *mutator_path = NULL;
     const char *input_path = NULL;
+    const char *out_dir = NULL;
 
     for (int i = 1; i < argc; ++i) {
         if (strcmp(argv[i], "--iterations") == 0) {
@@ -91,6 +127,19 @@ int main(int argc, char **argv) {
             continue;
         }
 
+        if (strcmp(argv[i], "--out-dir") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr,
+                        "Usage: %s [--iterations N] [--seed S] [--out-dir D] <mutator.so> "
+                        "<input_file>\n",
+                        argv[0]);
+                return 1;
+            }
+            out_dir = argv[i + 1];
+            ++i;
+            continue;
+        }
+
         if (!mutator_path) {
             mutator_path = argv[i];
             continue;
@@ -134,6 +183,12 @@ int main(int argc, char **argv) {
         (afl_custom_describe_t)dlsym(handle, "afl_custom_describe");
     afl_custom_deinit_t deinit_fn =
         (afl_custom_deinit_t)dlsym(handle, "afl_custom_deinit");
+    // Optional: mutators that track effective changes report them directly.
+    ca_mutator_last_changed_t last_changed_fn =
+        (ca_mutator_last_changed_t)dlsym(handle, "ca_mutator_last_changed");
+    // Optional: segment output lets hashing and writing read input spans in place.
+    ca_mutator_fuzz_segments_t segments_fn =
+        (ca_mutator_fuzz_segments_t)dlsym(handle, "ca_mutator_fuzz_segments");
 
     if (!init_fn || !fuzz_fn || !deinit_fn) {
         fprintf(stderr, "Missing required callbacks\n");
@@ -207,9 +262,16 @@ int main(int argc, char **argv) {
             max_size = SIZE_MAX;
         }
 
-        size_t mutated_size =
-            fuzz_fn(mutator_state, current_buf, current_size, &mutated, NULL, 0,
-                    max_size);
+        const mutation_segment_t *segments = NULL;
+        size_t segment_count = 0;
+        size_t mutated_size = 0;
+        if (segments_fn) {
+            mutated_size = segments_fn(mutator_state, current_buf, current_size, &segments,
+                                       &segment_count, max_size);
+        } else {
+            mutated_size = fuzz_fn(mutator_state, current_buf, current_size, &mutated, NULL,
+                                   0, max_size);
+        }
 
         if (mutated != NULL && mutated == current_buf) {
             fprintf(stderr,
@@ -235,7 +297,7 @@ int main(int argc, char **argv) {
             continue;
         }
 
-        if (mutated == NULL) {
+        if (mutated == NULL && segments == NULL) {
             fprintf(stderr, "ERROR: mutation %zu returned NULL with non-zero len\n",
                     i + 1);
             error = true;
@@ -250,9 +312,30 @@ int main(int argc, char **argv) {
             break;
         }
 
-        uint64_t hash = mut_hash64(mutated, mutated_size);
+        uint64_t hash = segments ? mut_hash64_segments(segments, segment_count)
+                                 : mut_hash64(mutated, mutated_size);
+        // The next input needs a flat copy anyway, so segments are gathered once
+        // straight into it.
+        uint8_t *gathered = NULL;
+        if (segments) {
+            gathered = (uint8_t *)malloc(mutated_size);
+            if (!gathered) {
+                fprintf(stderr, "failed to allocate mutated copy\n");
+                error = true;
+                break;
+            }
+            size_t offset = 0;
+            for (size_t s = 0; s < segment_count; ++s) {
+                memcpy(gathered + offset, segments[s].data, segments[s].len);
+                offset += segments[s].len;
+            }
+            mutated = gathered;
+        }
         int is_noop = 0;
-        if (is_growing && current_size != 0 && mutated_size == current_size &&
+        bool known_changed =
+            last_changed_fn != NULL && last_changed_fn(mutator_state) != 0;
+        if (is_growing && !known_changed && current_size != 0 &&
+            mutated_size == current_size &&
             memcmp(mutated, current_buf, current_size) == 0) {
             is_noop = 1;
             ++noops;
@@ -289,16 +372,26 @@ int main(int argc, char **argv) {
             if (mutated_size > 0) {
                 printf("ERROR: no-op output should not be treated as successful mutation\n");
             }
+            free(gathered);
             continue;
         }
 
-        current_copy = (uint8_t *)malloc(mutated_size);
-        if (!current_copy) {
-            fprintf(stderr, "failed to allocate mutated copy\n");
+        if (out_dir && !write_output(out_dir, i + 1, mutated, mutated_size, segments,
+                                     segment_count)) {
+            fprintf(stderr, "failed to write mutation %zu to %s\n", i + 1, out_dir);
             error = true;
-            break;
         }
-        memcpy(current_copy, mutated, mutated_size);
+
+        current_copy = gathered;
+        if (!current_copy) {
+            current_copy = (uint8_t *)malloc(mutated_size);
+            if (!current_copy) {
+                fprintf(stderr, "failed to allocate mutated copy\n");
+                error = true;
+                break;
+            }
+            memcpy(current_copy, mutated, mutated_size);
+        }
 
         if (current_buf != orig_input) {
             free(current_buf);
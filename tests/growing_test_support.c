@@ -24,32 +24,36 @@ void grow_result_free(grow_result_t *result) {
     result->is_skip = 1;
 }
 
-int grow_mutate_to_owned_buffer(ca_engine_t *engine, const uint8_t *input,
-                               size_t input_len, size_t max_output_len,
-                               uint64_t mutation_id, grow_result_t *result) {
-    if (!engine || !result) return 0;
-
-    result->is_skip = 1;
-    result->status = CA_STATUS_OK;
-    result->len = 0;
-    result->data = NULL;
-
-    if (!input && input_len != 0) {
-        result->status = CA_STATUS_INVALID_ARGUMENT;
-        return 0;
+bool grow_result_equal(const grow_result_t *a, const grow_result_t *b) {
+    if (a->status != b->status || a->is_skip != b->is_skip || a->len != b->len) {
+        return false;
     }
+    return a->is_skip || memcmp(a->data, b->data, a->len) == 0;
+}
 
-    ca_mutate_request_t request = {
-        .input = input,
-        .input_len = input_len,
-        .add_buf = NULL,
-        .add_buf_len = 0,
-        .max_output_len = max_output_len,
-        .mutation_id = mutation_id,
-    };
+// Cross-checks the scatter-gather view of `plan` against the applied output.
+static bool grow_segments_match(const normalized_plan_t *plan, const uint8_t *input,
+                                size_t input_len, const uint8_t *output,
+                                size_t output_len, bool changed) {
+    mutation_segments_t segments = {0};
+    bool segments_changed = false;
+    bool ok = mutation_plan_segments(plan, input, input_len, &segments,
+                                     &segments_changed) == CA_STATUS_OK &&
+              segments.total_len == output_len && segments_changed == changed;
+    size_t offset = 0;
+    for (size_t i = 0; ok && i < segments.count; ++i) {
+        ok = memcmp(output + offset, segments.segments[i].data,
+                    segments.segments[i].len) == 0;
+        offset += segments.segments[i].len;
+    }
+    mutation_segments_free(&segments);
+    return ok;
+}
 
-    ca_output_t output = {0};
-    ca_status_t status = ca_engine_mutate(engine, &request, &output);
+// Normalizes and applies a plan output of `status` into an owned buffer.
+static int grow_output_to_owned_buffer(ca_status_t status, const ca_output_t *output,
+                                       const uint8_t *input, size_t input_len,
+                                       size_t max_output_len, grow_result_t *result) {
     result->status = status;
     if (status == CA_STATUS_SKIP || status == CA_STATUS_OUTPUT_TOO_LARGE) {
         return 1;
@@ -58,7 +62,7 @@ int grow_mutate_to_owned_buffer(ca_engine_t *engine, const uint8_t *input,
         return 0;
     }
 
-    if (output.kind != CA_OUTPUT_PLAN || !output.value.plan) {
+    if (output->kind != CA_OUTPUT_PLAN || !output->value.plan) {
         result->status = CA_STATUS_INVALID_ARGUMENT;
         return 0;
     }
@@ -71,7 +75,7 @@ int grow_mutate_to_owned_buffer(ca_engine_t *engine, const uint8_t *input,
     };
 
     normalized_plan_t normalized = {0};
-    status = mutation_plan_normalize(output.value.plan, &limits, &normalized);
+    status = mutation_plan_normalize(output->value.plan, &limits, &normalized);
     if (status == CA_STATUS_SKIP || status == CA_STATUS_OUTPUT_TOO_LARGE) {
         normalized_plan_free(&normalized);
         return 1;
@@ -108,8 +112,13 @@ int grow_mutate_to_owned_buffer(ca_engine_t *engine, const uint8_t *input,
     }
 
     size_t written = 0;
+    bool changed = false;
     status = mutation_plan_apply(&normalized, input, input_len, buffer, output_len,
-                                &written);
+                                &written, &changed);
+    if (status == CA_STATUS_OK && written == output_len &&
+        !grow_segments_match(&normalized, input, input_len, buffer, written, changed)) {
+        status = CA_STATUS_INTERNAL_ERROR;
+    }
     normalized_plan_free(&normalized);
     if (status != CA_STATUS_OK || written != output_len) {
         free(buffer);
@@ -117,8 +126,15 @@ int grow_mutate_to_owned_buffer(ca_engine_t *engine, const uint8_t *input,
         return 0;
     }
 
-    if (written == input_len && input_len > 0 &&
-        memcmp(buffer, input, input_len) == 0) {
+    // Cross-check the tracked change flag against a full comparison.
+    bool differs = written != input_len ||
+                   (input_len > 0 && memcmp(buffer, input, input_len) != 0);
+    if (changed != differs) {
+        free(buffer);
+        result->status = CA_STATUS_INTERNAL_ERROR;
+        return 0;
+    }
+    if (!changed) {
         free(buffer);
         return 1;
     }
@@ -128,3 +144,65 @@ int grow_mutate_to_owned_buffer(ca_engine_t *engine, const uint8_t *input,
     result->data = buffer;
     return 1;
 }
+
+static int grow_result_begin(const uint8_t *input, size_t input_len,
+                             grow_result_t *result) {
+    result->is_skip = 1;
+    result->status = CA_STATUS_OK;
+    result->len = 0;
+    result->data = NULL;
+
+    if (!input && input_len != 0) {
+        result->status = CA_STATUS_INVALID_ARGUMENT;
+        return 0;
+    }
+    return 1;
+}
+
+int grow_mutate_to_owned_buffer(ca_engine_t *engine, const uint8_t *input,
+                               size_t input_len, size_t max_output_len,
+                               uint64_t mutation_id, grow_result_t *result) {
+    if (!engine || !result) return 0;
+    if (!grow_result_begin(input, input_len, result)) return 0;
+
+    ca_mutate_request_t request = {
+        .input = input,
+        .input_len = input_len,
+        .add_buf = NULL,
+        .add_buf_len = 0,
+        .max_output_len = max_output_len,
+        .mutation_id = mutation_id,
+    };
+
+    ca_output_t output = {0};
+    ca_status_t status = ca_engine_mutate(engine, &request, &output);
+    return grow_output_to_owned_buffer(status, &output, input, input_len,
+                                       max_output_len, result);
+}
+
+int grow_next_to_owned_buffer(ca_engine_t *engine, const uint8_t *input,
+                             size_t input_len, size_t max_output_len,
+                             grow_result_t *result) {
+    if (!engine || !result) return 0;
+    if (!grow_result_begin(input, input_len, result)) return 0;
+
+    ca_output_t output = {0};
+    ca_status_t status = ca_engine_next(engine, &output);
+    return grow_output_to_owned_buffer(status, &output, input, input_len,
+                                       max_output_len, result);
+}
+
+uint8_t *grow_apply_owned(const normalized_plan_t *plan, const uint8_t *input,
+                          size_t input_len, size_t *out_len) {
+    size_t len = 0;
+    if (mutation_plan_measure(plan, input_len, &len) != CA_STATUS_OK) return NULL;
+    uint8_t *out = (uint8_t *)malloc(len + 1u);
+    size_t written = 0;
+    if (!out || mutation_plan_apply(plan, input, input_len, out, len, &written, NULL) !=
+                    CA_STATUS_OK) {
+        free(out);
+        return NULL;
+    }
+    *out_len = written;
+    return out;
+}
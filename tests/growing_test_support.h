@@ -1,10 +1,12 @@
 #ifndef CA_MUTATOR_GROWING_TEST_SUPPORT_H_
 #define CA_MUTATOR_GROWING_TEST_SUPPORT_H_
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
 #include "ca_engine.h"
+#include "mutation_plan.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,8 +25,22 @@ int grow_mutate_to_owned_buffer(ca_engine_t *engine, const uint8_t *input,
                                size_t input_len, size_t max_output_len,
                                uint64_t mutation_id, grow_result_t *result);
 
+// Like grow_mutate_to_owned_buffer, but takes the next plan of the session opened by
+// ca_engine_begin on `input`.
+int grow_next_to_owned_buffer(ca_engine_t *engine, const uint8_t *input,
+                             size_t input_len, size_t max_output_len,
+                             grow_result_t *result);
+
 void grow_result_free(grow_result_t *result);
 
+// Same status, skip flag and, for non-skips, the same bytes.
+bool grow_result_equal(const grow_result_t *a, const grow_result_t *b);
+
+// Applies normalized `plan` to `input` into a malloc'd buffer of its measured
+// length; returns NULL when measure or apply fails.
+uint8_t *grow_apply_owned(const normalized_plan_t *plan, const uint8_t *input,
+                          size_t input_len, size_t *out_len);
+
 #ifdef __cplusplus
 }
 #endif
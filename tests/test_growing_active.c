@@ -0,0 +1,135 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ca_engine.h"
+#include "table_rng.h"
+#include "growing_test_support.h"
+
+#define INPUT_LEN 2048u
+#define CELLS (INPUT_LEN / 16u)
+#define STEPS 4u
+
+// One repeated value: every draw answers the same for a given bound, so the decode
+// after evolution sees the same values however many update draws came first.
+// `updates` counts the update-mask draws, the only ones bounded by 100.
+typedef struct {
+    table_rng_state_t table;
+    size_t calls;
+    size_t updates;
+} counting_rng_t;
+
+static uint32_t counting_below(void *context, uint32_t upper_bound) {
+    counting_rng_t *rng = (counting_rng_t *)context;
+    ++rng->calls;
+    rng->updates += upper_bound == 100u;
+    return table_rng_below(&rng->table, upper_bound);
+}
+
+// Runs one mutation and reports the output and how many draws, and update draws
+// among them, it took.
+static bool run_once(const ca_growing_params_t *params, uint32_t flags,
+                     const uint32_t *value, const uint8_t *input, grow_result_t *result,
+                     size_t *calls, size_t *updates) {
+    counting_rng_t rng = {0};
+    table_rng_init(&rng.table, value, 1u);
+    ca_rng_t rnd = {.below = counting_below, .context = &rng};
+    const ca_engine_config_t config = {
+        .user_context = NULL,
+        .flags = flags,
+        .growing_params = params,
+    };
+    ca_engine_t *engine = NULL;
+    if (ca_engine_create_growing(&config, rnd, &engine) != CA_STATUS_OK) return false;
+    bool ok = grow_mutate_to_owned_buffer(engine, input, INPUT_LEN, INPUT_LEN * 2u, 0,
+                                          result) != 0;
+    *calls = rng.calls;
+    if (updates) *updates = rng.updates;
+    ca_engine_destroy(engine);
+    return ok;
+}
+
+// Compares the active-set engine with full stepping on the same draws. The update
+// draws of full stepping are STEPS * CELLS, so `saved` is how many frontier slots
+// the active set skipped over the run.
+static bool check_mode(const ca_growing_params_t *params, uint32_t value,
+                       const uint8_t *input, size_t saved, const char *label) {
+    grow_result_t full = {0};
+    grow_result_t active = {0};
+    size_t full_calls = 0;
+    size_t active_calls = 0;
+    bool ok = run_once(params, 0u, &value, input, &full, &full_calls, NULL) &&
+              run_once(params, CA_ENGINE_FLAG_ACTIVE_SET, &value, input, &active,
+                       &active_calls, NULL) &&
+              full.is_skip == active.is_skip && full.len == active.len &&
+              (full.len == 0 || memcmp(full.data, active.data, full.len) == 0) &&
+              full_calls == active_calls + saved;
+    if (!ok) {
+        fprintf(stderr, "%s: %zu draws with the active set, %zu with full stepping\n",
+                label, active_calls, full_calls);
+    }
+    grow_result_free(&full);
+    grow_result_free(&active);
+    return ok;
+}
+
+// Mostly zero padding with a few filled blocks, under the default weights and every
+// update drawn: activity saturates after a step or two, so over twice the usual
+// steps the frontier must shrink to well under half of what full stepping visits.
+static bool check_padding(const ca_growing_params_t *defaults) {
+    ca_growing_params_t params = *defaults;
+    params.min_steps = 2u * STEPS;
+    params.max_steps = 2u * STEPS;
+    uint8_t *padded = (uint8_t *)calloc(INPUT_LEN, 1u);
+    if (!padded) return false;
+    for (size_t i = 0; i < INPUT_LEN; i += 512u) memcpy(padded + i, "IHDR\r\n\x1a\n", 8u);
+
+    const uint32_t value = 7u;
+    grow_result_t full = {0};
+    grow_result_t active = {0};
+    size_t calls = 0;
+    size_t full_updates = 0;
+    size_t active_updates = 0;
+    bool ok = run_once(&params, 0u, &value, padded, &full, &calls, &full_updates) &&
+              run_once(&params, CA_ENGINE_FLAG_ACTIVE_SET, &value, padded, &active, &calls,
+                       &active_updates) &&
+              full_updates == 2u * STEPS * CELLS && active_updates * 2u < full_updates;
+    if (!ok) {
+        fprintf(stderr, "padding: %zu update draws with the active set, %zu with full "
+                "stepping\n", active_updates, full_updates);
+    }
+    grow_result_free(&full);
+    grow_result_free(&active);
+    free(padded);
+    return ok;
+}
+
+int main(void) {
+    uint8_t *input = (uint8_t *)malloc(INPUT_LEN);
+    if (!input) return 1;
+    for (size_t i = 0; i < INPUT_LEN; ++i) input[i] = (uint8_t)((i * 131u) ^ (i >> 3));
+
+    ca_growing_params_t params;
+    ca_growing_params_init(&params);
+    params.min_steps = STEPS;
+    params.max_steps = STEPS;
+
+    // Zero weights leave every cell as encoded: after the first step updates them
+    // all, none changed and the frontier is empty.
+    ca_growing_params_t settled = params;
+    settled.update_percent = 100u;
+    memset(settled.weights, 0, sizeof(settled.weights));
+    bool ok = check_mode(&settled, 7u, input, (STEPS - 1u) * CELLS, "settled");
+
+    // A draw of 75 never passes update_percent 60: no cell is updated, so none may
+    // leave the frontier and every step draws for all of them.
+    ok = check_mode(&params, 75u, input, 0u, "no updates") && ok;
+    ok = check_padding(&params) && ok;
+
+    free(input);
+    if (!ok) return 1;
+
+    printf("growing active-set test: PASS\n");
+    return 0;
+}
@@ -0,0 +1,228 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ca_engine.h"
+#include "mutation_plan.h"
+#include "table_rng.h"
+#include "growing_test_support.h"
+
+static const uint32_t kComposeSeq[] = {
+    11, 27, 4, 19, 30, 8, 15, 1, 23, 6, 29, 13, 2, 21, 17, 25,
+    9, 0, 31, 14, 5, 26, 18, 3, 22, 10, 28, 7, 16, 24, 12, 20,
+};
+
+#define INPUT_LEN 700u
+#define DEPTH 4u
+
+static bool same_bytes(const uint8_t *a, size_t a_len, const uint8_t *b, size_t b_len) {
+    return a && b && a_len == b_len && memcmp(a, b, a_len) == 0;
+}
+
+// Stacks DEPTH growing-engine plans, each drawn against the previous output, and
+// checks that the composed plan applied to the seed gives the final output.
+static bool check_stacked(ca_engine_t *engine, const uint8_t *seed, size_t round,
+                          size_t *composed_count) {
+    normalized_plan_t composed = {0};
+    uint8_t *current = (uint8_t *)malloc(INPUT_LEN);
+    size_t current_len = INPUT_LEN;
+    bool ok = current != NULL;
+    if (ok) memcpy(current, seed, INPUT_LEN);
+
+    for (size_t depth = 0; depth < DEPTH && ok; ++depth) {
+        ca_mutate_request_t request = {
+            .input = current,
+            .input_len = current_len,
+            .max_output_len = current_len * 2u,
+            .mutation_id = (uint64_t)(round * DEPTH + depth),
+        };
+        ca_output_t output = {0};
+        if (ca_engine_mutate(engine, &request, &output) != CA_STATUS_OK) continue;
+        ca_plan_limits_t limits = {
+            .max_output_len = current_len * 2u,
+            .input_len = current_len,
+            .input = current,
+        };
+        normalized_plan_t step = {0};
+        normalized_plan_t next = {0};
+        size_t next_len = 0;
+        uint8_t *next_buf = NULL;
+        ok = mutation_plan_normalize(output.value.plan, &limits, &step) == CA_STATUS_OK &&
+             mutation_plan_compose(&composed, &step, seed, INPUT_LEN, &next) ==
+                 CA_STATUS_OK &&
+             (next_buf = grow_apply_owned(&step, current, current_len, &next_len)) != NULL;
+        if (!ok) fprintf(stderr, "stack step failed at round=%zu depth=%zu\n", round, depth);
+        normalized_plan_free(&step);
+        normalized_plan_free(&composed);
+        composed = next;
+        free(current);
+        current = next_buf;
+        current_len = next_len;
+        ++*composed_count;
+    }
+
+    if (ok) {
+        size_t fused_len = 0;
+        uint8_t *fused = grow_apply_owned(&composed, seed, INPUT_LEN, &fused_len);
+        if (!same_bytes(fused, fused_len, current, current_len)) {
+            fprintf(stderr, "composed plan diverged at round=%zu\n", round);
+            ok = false;
+        }
+        free(fused);
+    }
+    free(current);
+    normalized_plan_free(&composed);
+    return ok;
+}
+
+// Hand-built pair covering inserts edited by `b`, deletes spanning inserted and input
+// bytes, and point ops that fold, cancel or need the input.
+static bool check_folding(const uint8_t *seed) {
+    ca_plan_limits_t limits = {.max_output_len = INPUT_LEN * 2u, .input_len = INPUT_LEN,
+                               .input = seed};
+    static const uint8_t insert_a[] = "abc";
+    static const uint8_t insert_b[] = "tail";
+    mutation_plan_t plan_a;
+    mutation_plan_t plan_b;
+    normalized_plan_t a = {0};
+    normalized_plan_t b = {0};
+    normalized_plan_t fused = {0};
+    bool ok = mutation_plan_init(&plan_a) == CA_STATUS_OK &&
+              mutation_plan_init(&plan_b) == CA_STATUS_OK;
+
+    // a: flip bits at 5 and 7, insert "abc" at 10, delete [20, 25).
+    ok = ok && mutation_plan_add_bit_flip(&plan_a, 5, 1u, 4, 0) == CA_STATUS_OK &&
+         mutation_plan_add_bit_flip(&plan_a, 7, 2u, 4, 0) == CA_STATUS_OK &&
+         mutation_plan_add_insert_bytes(&plan_a, 10, insert_a, 3, 3, 0) == CA_STATUS_OK &&
+         mutation_plan_add_delete_range(&plan_a, 20, 5, 2, 0) == CA_STATUS_OK &&
+         mutation_plan_normalize(&plan_a, &limits, &a) == CA_STATUS_OK;
+    size_t a_len = 0;
+    uint8_t *a_out = ok ? grow_apply_owned(&a, seed, INPUT_LEN, &a_len) : NULL;
+    ok = ok && a_out && a.op_count == 4;
+
+    // b over a's output: add at 5 (after a flip), flip the same bit at 7 (cancels),
+    // set the inserted 'b', delete from the inserted 'c' into the input bytes after
+    // it, and append at the end.
+    ca_plan_limits_t b_limits = {.max_output_len = INPUT_LEN * 2u, .input_len = a_len,
+                                 .input = a_out};
+    ok = ok && mutation_plan_add_add_byte(&plan_b, 5, 3, 5, 0) == CA_STATUS_OK &&
+         mutation_plan_add_bit_flip(&plan_b, 7, 2u, 5, 0) == CA_STATUS_OK &&
+         mutation_plan_add_set_byte(&plan_b, 11, 'X', 4, 0) == CA_STATUS_OK &&
+         mutation_plan_add_delete_range(&plan_b, 12, 3, 3, 0) == CA_STATUS_OK &&
+         mutation_plan_add_insert_bytes(&plan_b, (uint32_t)a_len, insert_b, 4, 1, 0) ==
+             CA_STATUS_OK &&
+         mutation_plan_normalize(&plan_b, &b_limits, &b) == CA_STATUS_OK &&
+         b.op_count == 5;
+    size_t b_len = 0;
+    uint8_t *b_out = ok ? grow_apply_owned(&b, a_out, a_len, &b_len) : NULL;
+    ok = ok && b_out;
+
+    // Flip then add has no single-op form without the input byte.
+    if (ok && mutation_plan_compose(&a, &b, NULL, INPUT_LEN, &fused) !=
+                  CA_STATUS_INVALID_ARGUMENT) {
+        fprintf(stderr, "compose without input accepted a non-folding pair\n");
+        ok = false;
+    }
+    if (ok && mutation_plan_compose(&a, &b, seed, INPUT_LEN, &fused) != CA_STATUS_OK) {
+        fprintf(stderr, "compose failed\n");
+        ok = false;
+    }
+    if (ok) {
+        size_t fused_len = 0;
+        uint8_t *fused_out = grow_apply_owned(&fused, seed, INPUT_LEN, &fused_len);
+        bool cancelled = true;
+        for (size_t i = 0; i < fused.op_count; ++i) {
+            if (fused.ops[i].pos == 7) cancelled = false;
+        }
+        if (!same_bytes(fused_out, fused_len, b_out, b_len) || !cancelled) {
+            fprintf(stderr, "hand-built composition mismatch\n");
+            ok = false;
+        }
+        free(fused_out);
+    }
+
+    free(a_out);
+    free(b_out);
+    normalized_plan_free(&a);
+    normalized_plan_free(&b);
+    normalized_plan_free(&fused);
+    mutation_plan_destroy(&plan_a);
+    mutation_plan_destroy(&plan_b);
+    return ok;
+}
+
+// A point op accepted before a delete starting at the same byte stays in the plan;
+// apply drops the byte, and segments and composition must agree.
+static bool check_point_under_delete(const uint8_t *seed) {
+    ca_plan_limits_t limits = {.max_output_len = INPUT_LEN, .input_len = INPUT_LEN,
+                               .input = seed};
+    mutation_plan_t plan;
+    normalized_plan_t normalized = {0};
+    normalized_plan_t empty = {0};
+    normalized_plan_t fused = {0};
+    mutation_segments_t segments = {0};
+    bool ok = mutation_plan_init(&plan) == CA_STATUS_OK &&
+              mutation_plan_add_set_byte(&plan, 9, 0xEEu, 9, 0) == CA_STATUS_OK &&
+              mutation_plan_add_delete_range(&plan, 9, 4, 1, 0) == CA_STATUS_OK &&
+              mutation_plan_normalize(&plan, &limits, &normalized) == CA_STATUS_OK &&
+              normalized.op_count == 2;
+    size_t applied_len = 0;
+    uint8_t *applied = ok ? grow_apply_owned(&normalized, seed, INPUT_LEN, &applied_len) : NULL;
+    ok = ok && applied &&
+         mutation_plan_segments(&normalized, seed, INPUT_LEN, &segments, NULL) ==
+             CA_STATUS_OK &&
+         segments.total_len == applied_len;
+    for (size_t i = 0, offset = 0; ok && i < segments.count; ++i) {
+        ok = memcmp(segments.segments[i].data, applied + offset,
+                    segments.segments[i].len) == 0;
+        offset += segments.segments[i].len;
+    }
+    size_t fused_len = 0;
+    uint8_t *fused_out = NULL;
+    ok = ok &&
+         mutation_plan_compose(&empty, &normalized, NULL, INPUT_LEN, &fused) ==
+             CA_STATUS_OK &&
+         (fused_out = grow_apply_owned(&fused, seed, INPUT_LEN, &fused_len)) != NULL &&
+         same_bytes(fused_out, fused_len, applied, applied_len);
+    if (!ok) fprintf(stderr, "point under delete mismatch\n");
+
+    free(applied);
+    free(fused_out);
+    mutation_segments_free(&segments);
+    normalized_plan_free(&normalized);
+    normalized_plan_free(&fused);
+    mutation_plan_destroy(&plan);
+    return ok;
+}
+
+int main(void) {
+    table_rng_state_t rng = {0};
+    table_rng_init(&rng, kComposeSeq, sizeof(kComposeSeq) / sizeof(*kComposeSeq));
+    ca_rng_t rnd = {.below = table_rng_below, .context = &rng};
+
+    ca_engine_t *engine = NULL;
+    if (ca_engine_create_growing(&(ca_engine_config_t){.user_context = NULL}, rnd,
+                                &engine) != CA_STATUS_OK) {
+        return 1;
+    }
+
+    static uint8_t seed[INPUT_LEN];
+    for (size_t i = 0; i < INPUT_LEN; ++i) seed[i] = (uint8_t)(0x30u + (i * 13u) % 0x4Bu);
+
+    bool ok = check_folding(seed) && check_point_under_delete(seed);
+    size_t composed = 0;
+    for (size_t round = 0; round < 16 && ok; ++round) {
+        ok = check_stacked(engine, seed, round, &composed);
+    }
+    if (ok && composed < 16) {
+        fprintf(stderr, "too few plans composed: %zu\n", composed);
+        ok = false;
+    }
+
+    ca_engine_destroy(engine);
+    if (!ok) return 1;
+
+    printf("growing compose test: PASS\n");
+    return 0;
+}
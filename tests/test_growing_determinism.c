@@ -12,7 +12,8 @@ static const uint32_t kGrowingRngSeq[] = {
     29, 3, 27, 6, 12, 20, 17, 21, 22, 4, 28, 15, 24, 26, 10, 30,
 };
 
-static bool compare_session(const uint8_t *input, size_t input_len, size_t calls) {
+static bool compare_session(const uint8_t *input, size_t input_len, size_t calls,
+                            uint32_t flags) {
     table_rng_state_t rng1 = {0};
     table_rng_state_t rng2 = {0};
     table_rng_init(&rng1, kGrowingRngSeq, sizeof(kGrowingRngSeq) / sizeof(*kGrowingRngSeq));
@@ -23,12 +24,11 @@ static bool compare_session(const uint8_t *input, size_t input_len, size_t calls
 
     ca_engine_t *engine1 = NULL;
     ca_engine_t *engine2 = NULL;
-    if (ca_engine_create_growing(&(ca_engine_config_t){.user_context = NULL}, rnd1,
-                                &engine1) != CA_STATUS_OK) {
+    const ca_engine_config_t config = {.user_context = NULL, .flags = flags};
+    if (ca_engine_create_growing(&config, rnd1, &engine1) != CA_STATUS_OK) {
         return false;
     }
-    if (ca_engine_create_growing(&(ca_engine_config_t){.user_context = NULL}, rnd2,
-                                &engine2) != CA_STATUS_OK) {
+    if (ca_engine_create_growing(&config, rnd2, &engine2) != CA_STATUS_OK) {
         ca_engine_destroy(engine1);
         return false;
     }
@@ -110,13 +110,16 @@ int main(void) {
                           sizeof(case_binary2)};
     bool ok = true;
 
-    for (size_t i = 0; i < 2; ++i) {
-        ok &= compare_session(inputs[i], lens[i], 5);
-    }
+    static const uint32_t modes[] = {0u, CA_ENGINE_FLAG_ACTIVE_SET};
+    for (size_t m = 0; m < sizeof(modes) / sizeof(*modes); ++m) {
+        for (size_t i = 0; i < 2; ++i) {
+            ok &= compare_session(inputs[i], lens[i], 5, modes[m]);
+        }
 
-    ok &= compare_session(case_text, sizeof(case_text) - 1, 10);
-    ok &= compare_session(case_binary1, sizeof(case_binary1), 10);
-    ok &= compare_session(case_binary2, sizeof(case_binary2), 10);
+        ok &= compare_session(case_text, sizeof(case_text) - 1, 10, modes[m]);
+        ok &= compare_session(case_binary1, sizeof(case_binary1), 10, modes[m]);
+        ok &= compare_session(case_binary2, sizeof(case_binary2), 10, modes[m]);
+    }
 
     if (!ok) {
         return 1;
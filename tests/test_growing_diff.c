@@ -0,0 +1,237 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ca_engine.h"
+#include "mutation_plan.h"
+#include "table_rng.h"
+#include "growing_test_support.h"
+
+static const uint32_t kDiffSeq[] = {
+    6, 21, 13, 30, 2, 25, 9, 17, 0, 28, 11, 19, 4, 23, 15, 31,
+    8, 26, 1, 14, 29, 5, 20, 10, 27, 3, 18, 12, 24, 7, 22, 16,
+};
+
+#define INPUT_LEN 900u
+#define LARGE_LEN (96u * 1024u)
+#define SCATTER_LEN 14000u
+#define SCATTER_EDITS 14u
+
+// Diffs `old` to `new_buf` and checks the plan rebuilds `new_buf`; the op count is
+// returned through `op_count` when requested.
+static bool check_roundtrip(const uint8_t *old, size_t old_len, const uint8_t *new_buf,
+                            size_t new_len, const ca_plan_limits_t *limits,
+                            size_t *op_count, const char *label) {
+    normalized_plan_t plan = {0};
+    size_t out_len = 0;
+    uint8_t *out = NULL;
+    bool ok = mutation_plan_diff(old, old_len, new_buf, new_len, limits, &plan) ==
+                  CA_STATUS_OK &&
+              (out = grow_apply_owned(&plan, old, old_len, &out_len)) != NULL &&
+              out_len == new_len && memcmp(out, new_buf, new_len) == 0;
+    if (!ok) fprintf(stderr, "diff roundtrip failed: %s\n", label);
+    if (op_count) *op_count = plan.op_count;
+    free(out);
+    normalized_plan_free(&plan);
+    return ok;
+}
+
+// Hand-built edits with known shapes: no change, one insert in a buffer large enough
+// for the block-anchored path, a short overwrite, and the max_ops fallback.
+static bool check_shapes(const uint8_t *seed) {
+    size_t ops = 0;
+    bool ok = check_roundtrip(seed, INPUT_LEN, seed, INPUT_LEN, NULL, &ops, "identical") &&
+              ops == 0;
+
+    uint8_t *large = (uint8_t *)malloc(LARGE_LEN);
+    uint8_t *grown = (uint8_t *)malloc(LARGE_LEN + 8u);
+    ok = ok && large && grown;
+    if (ok) {
+        for (size_t i = 0; i < LARGE_LEN; ++i) {
+            large[i] = (uint8_t)((i * 2654435761u) >> 13);
+        }
+        memcpy(grown, large, 40000u);
+        memcpy(grown + 40000u, "INSERTED", 8u);
+        memcpy(grown + 40008u, large + 40000u, LARGE_LEN - 40000u);
+        ok = check_roundtrip(large, LARGE_LEN, grown, LARGE_LEN + 8u, NULL, &ops,
+                             "large insert") &&
+             ops == 1;
+    }
+    free(large);
+    free(grown);
+
+    uint8_t edited[INPUT_LEN];
+    memcpy(edited, seed, INPUT_LEN);
+    edited[100] ^= 0x5Au;
+    memcpy(edited + 400, "overwrite", 9u);
+    ok = ok && check_roundtrip(seed, INPUT_LEN, edited, INPUT_LEN, NULL, &ops, "overwrite");
+
+    // Spread edits need many ops; a two-op budget forces the single replacement.
+    for (size_t i = 50; i < 850; i += 40) edited[i] = (uint8_t)~edited[i];
+    ca_plan_limits_t limits = {.max_output_len = INPUT_LEN, .max_ops = 2};
+    ok = ok && check_roundtrip(seed, INPUT_LEN, edited, INPUT_LEN, &limits, &ops,
+                               "max_ops fallback") &&
+         ops <= 2;
+    limits.max_output_len = INPUT_LEN - 1u;
+    normalized_plan_t plan = {0};
+    if (ok && mutation_plan_diff(seed, INPUT_LEN, edited, INPUT_LEN, &limits, &plan) !=
+                  CA_STATUS_OUTPUT_TOO_LARGE) {
+        fprintf(stderr, "diff ignored max_output_len\n");
+        ok = false;
+    }
+    normalized_plan_free(&plan);
+    return ok;
+}
+
+// Edits scattered across a buffer under DIFF_DP_SPAN exceed the Myers edit budget
+// together; the anchored split must still keep the payload near the edited bytes
+// instead of carrying the whole middle as one literal.
+static bool check_scattered(void) {
+    uint8_t *old = (uint8_t *)malloc(SCATTER_LEN);
+    uint8_t *edited = (uint8_t *)malloc(SCATTER_LEN + SCATTER_EDITS * 40u);
+    normalized_plan_t plan = {0};
+    size_t out_len = 0;
+    uint8_t *out = NULL;
+    bool ok = old && edited;
+    size_t edited_bytes = 0;
+    size_t new_len = 0;
+    if (ok) {
+        // Xorshift bytes: unlike a multiplicative fill, no block repeats elsewhere.
+        uint32_t x = 0x9E3779B9u;
+        for (size_t i = 0; i < SCATTER_LEN; ++i) {
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            old[i] = (uint8_t)(x >> 24);
+        }
+        // Alternate 30-byte overwrites and 24-byte inserts every 1000 bytes.
+        size_t from = 0;
+        for (size_t e = 0; e < SCATTER_EDITS; ++e) {
+            size_t at = 500u + e * 1000u;
+            memcpy(edited + new_len, old + from, at - from);
+            new_len += at - from;
+            size_t len = (e & 1u) ? 24u : 30u;
+            memset(edited + new_len, 0xA0 + (int)e, len);
+            new_len += len;
+            edited_bytes += len;
+            from = (e & 1u) ? at : at + len;
+        }
+        memcpy(edited + new_len, old + from, SCATTER_LEN - from);
+        new_len += SCATTER_LEN - from;
+        ok = mutation_plan_diff(old, SCATTER_LEN, edited, new_len, NULL, &plan) ==
+                 CA_STATUS_OK &&
+             (out = grow_apply_owned(&plan, old, SCATTER_LEN, &out_len)) != NULL &&
+             out_len == new_len && memcmp(out, edited, new_len) == 0;
+        if (!ok) fprintf(stderr, "diff roundtrip failed: scattered\n");
+    }
+    if (ok && plan.extra_bytes_len > edited_bytes * 2u) {
+        fprintf(stderr, "scattered diff payload %zu for %zu edited bytes\n",
+                plan.extra_bytes_len, edited_bytes);
+        ok = false;
+    }
+    free(out);
+    free(old);
+    free(edited);
+    normalized_plan_free(&plan);
+    return ok;
+}
+
+// Diffs growing-engine outputs back against their input; the derived plan must
+// rebuild the output and survive renormalization unchanged.
+static bool check_engine_outputs(ca_engine_t *engine, const uint8_t *seed,
+                                 size_t *diffed) {
+    bool ok = true;
+    for (size_t call = 0; call < 48 && ok; ++call) {
+        ca_mutate_request_t request = {
+            .input = seed,
+            .input_len = INPUT_LEN,
+            .max_output_len = INPUT_LEN * 2u,
+            .mutation_id = (uint64_t)call,
+        };
+        ca_output_t output = {0};
+        if (ca_engine_mutate(engine, &request, &output) != CA_STATUS_OK) continue;
+        ca_plan_limits_t limits = {
+            .max_output_len = INPUT_LEN * 2u,
+            .input_len = INPUT_LEN,
+            .input = seed,
+        };
+        normalized_plan_t normalized = {0};
+        normalized_plan_t diffed_plan = {0};
+        normalized_plan_t renormalized = {0};
+        mutation_plan_t rebuilt;
+        size_t out_len = 0;
+        uint8_t *out = NULL;
+        bool built = false;
+        ok = mutation_plan_normalize(output.value.plan, &limits, &normalized) ==
+                 CA_STATUS_OK &&
+             (out = grow_apply_owned(&normalized, seed, INPUT_LEN, &out_len)) != NULL &&
+             check_roundtrip(seed, INPUT_LEN, out, out_len, &limits, NULL, "engine") &&
+             mutation_plan_diff(seed, INPUT_LEN, out, out_len, &limits, &diffed_plan) ==
+                 CA_STATUS_OK &&
+             (built = mutation_plan_init(&rebuilt) == CA_STATUS_OK);
+        // Re-adding each derived op must keep them all: the diff never emits
+        // overlapping or conflicting ops.
+        for (size_t i = 0; ok && i < diffed_plan.op_count; ++i) {
+            const mutation_op_t *op = &diffed_plan.ops[i];
+            ca_status_t st = CA_STATUS_OK;
+            switch ((mutation_op_kind_t)op->kind) {
+            case CA_OP_SET_BYTE:
+                st = mutation_plan_add_set_byte(&rebuilt, op->pos, op->arg, 1, 0);
+                break;
+            case CA_OP_DELETE_RANGE:
+                st = mutation_plan_add_delete_range(&rebuilt, op->pos, op->len, 1, 0);
+                break;
+            case CA_OP_INSERT_BYTES:
+                st = mutation_plan_add_insert_bytes(
+                    &rebuilt, op->pos, diffed_plan.extra_bytes + op->data_offset, op->len,
+                    1, 0);
+                break;
+            default:
+                st = CA_STATUS_INVALID_ARGUMENT;
+                break;
+            }
+            ok = st == CA_STATUS_OK;
+        }
+        ok = ok && mutation_plan_normalize(&rebuilt, &limits, &renormalized) ==
+                       CA_STATUS_OK &&
+             renormalized.op_count == diffed_plan.op_count;
+        if (!ok) fprintf(stderr, "engine output diff failed at call=%zu\n", call);
+        ++*diffed;
+        free(out);
+        if (built) mutation_plan_destroy(&rebuilt);
+        normalized_plan_free(&normalized);
+        normalized_plan_free(&diffed_plan);
+        normalized_plan_free(&renormalized);
+    }
+    return ok;
+}
+
+int main(void) {
+    table_rng_state_t rng = {0};
+    table_rng_init(&rng, kDiffSeq, sizeof(kDiffSeq) / sizeof(*kDiffSeq));
+    ca_rng_t rnd = {.below = table_rng_below, .context = &rng};
+
+    ca_engine_t *engine = NULL;
+    if (ca_engine_create_growing(&(ca_engine_config_t){.user_context = NULL}, rnd,
+                                &engine) != CA_STATUS_OK) {
+        return 1;
+    }
+
+    static uint8_t seed[INPUT_LEN];
+    for (size_t i = 0; i < INPUT_LEN; ++i) seed[i] = (uint8_t)(0x20u + (i * 7u) % 0x5Fu);
+
+    size_t diffed = 0;
+    bool ok = check_shapes(seed) && check_scattered() &&
+              check_engine_outputs(engine, seed, &diffed);
+    if (ok && diffed < 16) {
+        fprintf(stderr, "too few engine outputs diffed: %zu\n", diffed);
+        ok = false;
+    }
+
+    ca_engine_destroy(engine);
+    if (!ok) return 1;
+
+    printf("growing diff test: PASS\n");
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "afl_fuzz_count.h"
+
+static bool expect(uint32_t got, uint32_t want, const char *label) {
+    if (got == want) return true;
+    fprintf(stderr, "%s: fuzz count %u, expected %u\n", label, got, want);
+    return false;
+}
+
+// Cost scaling: execution time wins over length, missing data is neutral, and the
+// factor stays within AFL_FUZZ_COUNT_COST_SPAN.
+static bool check_cost(void) {
+    const uint32_t base = AFL_FUZZ_COUNT_BASE;
+    const afl_cost_t average = {.exec_us = 500, .mean_exec_us = 500, .len = 64,
+                                .mean_len = 64};
+    const afl_cost_t slow = {.exec_us = 1000, .mean_exec_us = 500, .len = 16,
+                             .mean_len = 64};
+    const afl_cost_t fast = {.exec_us = 250, .mean_exec_us = 500};
+    const afl_cost_t huge = {.len = 1u << 20, .mean_len = 1024};
+    const afl_cost_t tiny = {.exec_us = 1, .mean_exec_us = 1000000};
+    const afl_cost_t unknown = {0};
+    return expect(afl_fuzz_count_compute(base, NULL, NULL, NULL), base, "no cost") &&
+           expect(afl_fuzz_count_compute(base, &unknown, NULL, NULL), base, "unknown") &&
+           expect(afl_fuzz_count_compute(base, &average, NULL, NULL), base, "average") &&
+           expect(afl_fuzz_count_compute(base, &slow, NULL, NULL), base / 2u, "slow") &&
+           expect(afl_fuzz_count_compute(base, &fast, NULL, NULL), base * 2u, "fast") &&
+           expect(afl_fuzz_count_compute(base, &huge, NULL, NULL),
+                  base / AFL_FUZZ_COUNT_COST_SPAN, "huge") &&
+           expect(afl_fuzz_count_compute(base, &tiny, NULL, NULL),
+                  base * AFL_FUZZ_COUNT_COST_SPAN, "tiny");
+}
+
+// Yield scaling and the final clamp.
+static bool check_yield(void) {
+    const uint32_t base = AFL_FUZZ_COUNT_BASE;
+    const afl_yield_t none = {0};
+    const afl_yield_t total = {.found = 9, .elapsed_us = 9000000};
+    // Pays at the campaign rate: one find per second.
+    const afl_yield_t par = {.found = 3, .elapsed_us = 3000000};
+    // Three seconds without a find: a quarter of the base with the prior.
+    const afl_yield_t dry = {.found = 0, .elapsed_us = 3000000};
+    const afl_yield_t rich = {.found = 1000, .elapsed_us = 1000000};
+    const afl_yield_t barren = {.found = 0, .elapsed_us = 1000000000};
+    const afl_cost_t slow = {.exec_us = 4000, .mean_exec_us = 1000};
+    return expect(afl_fuzz_count_compute(base, NULL, &none, &total), base, "new") &&
+           expect(afl_fuzz_count_compute(base, NULL, &par, &total), base, "par") &&
+           expect(afl_fuzz_count_compute(base, NULL, &dry, &total), base / 4u, "dry") &&
+           expect(afl_fuzz_count_compute(base, &slow, &none, &total), base / 4u,
+                  "new slow") &&
+           expect(afl_fuzz_count_compute(base, NULL, &rich, &total), AFL_FUZZ_COUNT_MAX,
+                  "rich") &&
+           expect(afl_fuzz_count_compute(base, NULL, &barren, &total),
+                  AFL_FUZZ_COUNT_MIN, "barren") &&
+           expect(afl_fuzz_count_compute(1u, NULL, NULL, NULL), AFL_FUZZ_COUNT_MIN,
+                  "tiny base");
+}
+
+int main(void) {
+    if (!check_cost() || !check_yield()) return 1;
+
+    printf("growing fuzz count test: PASS\n");
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ca_engine.h"
+#include "mutation_plan.h"
+#include "table_rng.h"
+
+static const uint32_t kGapSeq[] = {
+    13, 2, 27, 8, 19, 30, 5, 22, 0, 16, 11, 25, 3, 28, 9, 20,
+    31, 6, 17, 24, 1, 14, 29, 10, 21, 4, 26, 15, 7, 18, 23, 12,
+};
+
+#define INPUT_LEN 64u
+#define ENGINE_INPUT_LEN 8192u
+
+static bool view_equals(const mutation_gap_buffer_t *buffer, const uint8_t *expected,
+                        size_t expected_len) {
+    mutation_segment_t segments[2];
+    size_t count = mutation_gap_buffer_view(buffer, segments);
+    size_t offset = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (offset + segments[i].len > expected_len ||
+            memcmp(segments[i].data, expected + offset, segments[i].len) != 0) {
+            return false;
+        }
+        offset += segments[i].len;
+    }
+    return offset == expected_len && buffer->len == expected_len;
+}
+
+// Applies `plan` both ways and checks the working copy, the changed flag and the
+// revert.
+static bool gap_matches_apply(const normalized_plan_t *plan, mutation_gap_buffer_t *buffer,
+                              const uint8_t *input, size_t input_len) {
+    size_t len = 0;
+    if (mutation_plan_measure(plan, input_len, &len) != CA_STATUS_OK) return false;
+    uint8_t *expected = (uint8_t *)malloc(len + 1u);
+    size_t written = 0;
+    bool want = false;
+    bool got = false;
+    bool ok = expected &&
+              mutation_plan_apply(plan, input, input_len, expected, len, &written,
+                                  &want) == CA_STATUS_OK &&
+              mutation_plan_apply_gap(plan, buffer, &got) == CA_STATUS_OK &&
+              got == want && view_equals(buffer, expected, written);
+    mutation_gap_buffer_revert(buffer);
+    ok = ok && view_equals(buffer, input, input_len);
+    free(expected);
+    return ok;
+}
+
+// An insert inside a delete, a point and a range around them; a second plan is
+// refused until the first is reverted; flatten gives the output in one block.
+static bool check_apply_revert(const uint8_t *input) {
+    static const uint8_t payload[] = {'X', 'Y', 'Z'};
+    ca_plan_limits_t limits = {.max_output_len = INPUT_LEN * 2u, .input_len = INPUT_LEN,
+                               .input = input};
+    mutation_gap_buffer_t buffer = {0};
+    mutation_plan_t plan;
+    normalized_plan_t normalized = {0};
+    bool ok = mutation_gap_buffer_load(&buffer, input, INPUT_LEN) == CA_STATUS_OK &&
+              mutation_plan_init(&plan) == CA_STATUS_OK &&
+              mutation_plan_add_delete_range(&plan, 10, 6, 5, 0) == CA_STATUS_OK &&
+              mutation_plan_add_insert_bytes(&plan, 12, payload, sizeof(payload), 9, 1) ==
+                  CA_STATUS_OK &&
+              mutation_plan_add_set_byte(&plan, 3, 0x00u, 5, 2) == CA_STATUS_OK &&
+              mutation_plan_add_fill_range(&plan, 40, 8, 0xEEu, 5, 3) == CA_STATUS_OK &&
+              mutation_plan_add_copy_range(&plan, 60, 0, 4, 5, 4) == CA_STATUS_OK &&
+              mutation_plan_normalize(&plan, &limits, &normalized) == CA_STATUS_OK &&
+              normalized.op_count == 5 &&
+              gap_matches_apply(&normalized, &buffer, input, INPUT_LEN);
+
+    bool changed = false;
+    uint8_t expected[INPUT_LEN + 1u];
+    size_t written = 0;
+    ok = ok &&
+         mutation_plan_apply(&normalized, input, INPUT_LEN, expected, sizeof(expected),
+                             &written, NULL) == CA_STATUS_OK &&
+         mutation_plan_apply_gap(&normalized, &buffer, &changed) == CA_STATUS_OK &&
+         mutation_plan_apply_gap(&normalized, &buffer, &changed) ==
+             CA_STATUS_INVALID_ARGUMENT;
+    const uint8_t *flat = ok ? mutation_gap_buffer_flatten(&buffer) : NULL;
+    ok = ok && flat && written == buffer.len && memcmp(flat, expected, written) == 0;
+    mutation_gap_buffer_revert(&buffer);
+    ok = ok && view_equals(&buffer, input, INPUT_LEN);
+    if (!ok) fprintf(stderr, "gap apply/revert mismatch\n");
+
+    normalized_plan_free(&normalized);
+    mutation_plan_destroy(&plan);
+    mutation_gap_buffer_free(&buffer);
+    return ok;
+}
+
+// A delete and an insert of the same bytes cancel out and are reported unchanged.
+static bool check_unchanged(const uint8_t *input) {
+    ca_plan_limits_t limits = {.max_output_len = INPUT_LEN * 2u, .input_len = INPUT_LEN,
+                               .input = input};
+    mutation_gap_buffer_t buffer = {0};
+    mutation_plan_t plan;
+    normalized_plan_t normalized = {0};
+    bool changed = true;
+    bool ok = mutation_gap_buffer_load(&buffer, input, INPUT_LEN) == CA_STATUS_OK &&
+              mutation_plan_init(&plan) == CA_STATUS_OK &&
+              mutation_plan_add_delete_range(&plan, 20, 2, 5, 0) == CA_STATUS_OK &&
+              mutation_plan_add_insert_bytes(&plan, 22, input + 20, 2, 5, 1) ==
+                  CA_STATUS_OK &&
+              mutation_plan_normalize(&plan, &limits, &normalized) == CA_STATUS_OK &&
+              normalized.op_count == 2 &&
+              mutation_plan_apply_gap(&normalized, &buffer, &changed) == CA_STATUS_OK &&
+              !changed && view_equals(&buffer, input, INPUT_LEN);
+    if (!ok) fprintf(stderr, "gap cancelling edit reported as changed\n");
+
+    normalized_plan_free(&normalized);
+    mutation_plan_destroy(&plan);
+    mutation_gap_buffer_free(&buffer);
+    return ok;
+}
+
+// A session of engine plans on one loaded copy, reverting after each, matches
+// mutation_plan_apply every time.
+static bool check_engine_session(void) {
+    static uint8_t input[ENGINE_INPUT_LEN];
+    for (size_t i = 0; i < ENGINE_INPUT_LEN; ++i) input[i] = (uint8_t)(i * 31u + (i >> 7));
+    table_rng_state_t rng = {0};
+    table_rng_init(&rng, kGapSeq, sizeof(kGapSeq) / sizeof(*kGapSeq));
+    ca_rng_t rnd = {.below = table_rng_below, .context = &rng};
+    ca_growing_params_t params;
+    ca_growing_params_init(&params);
+    for (size_t k = 0; k < CA_GROWING_KIND_COUNT - 1u; ++k) params.kind_weights[k] = 1u;
+    const ca_engine_config_t config = {.user_context = NULL, .growing_params = &params};
+    ca_engine_t *engine = NULL;
+    if (ca_engine_create_growing(&config, rnd, &engine) != CA_STATUS_OK) return false;
+
+    mutation_gap_buffer_t buffer = {0};
+    ca_mutate_request_t request = {
+        .input = input,
+        .input_len = ENGINE_INPUT_LEN,
+        .max_output_len = ENGINE_INPUT_LEN * 2u,
+    };
+    ca_plan_limits_t limits = {.max_output_len = ENGINE_INPUT_LEN * 2u,
+                               .input_len = ENGINE_INPUT_LEN, .input = input};
+    bool ok = mutation_gap_buffer_load(&buffer, input, ENGINE_INPUT_LEN) == CA_STATUS_OK &&
+              ca_engine_begin(engine, &request) == CA_STATUS_OK;
+    size_t applied = 0;
+    for (size_t call = 0; call < 200 && ok; ++call) {
+        ca_output_t output = {0};
+        if (ca_engine_next(engine, &output) != CA_STATUS_OK) continue;
+        normalized_plan_t normalized = {0};
+        ok = mutation_plan_normalize(output.value.plan, &limits, &normalized) ==
+                 CA_STATUS_OK &&
+             gap_matches_apply(&normalized, &buffer, input, ENGINE_INPUT_LEN);
+        normalized_plan_free(&normalized);
+        ++applied;
+    }
+    ca_engine_destroy(engine);
+    mutation_gap_buffer_free(&buffer);
+    if (!ok || applied < 100) {
+        fprintf(stderr, "gap session mismatch after %zu plans\n", applied);
+        ok = false;
+    }
+    return ok;
+}
+
+int main(void) {
+    static uint8_t input[INPUT_LEN];
+    for (size_t i = 0; i < INPUT_LEN; ++i) input[i] = (uint8_t)(0x41u + (i * 7u) % 26u);
+
+    bool ok = check_apply_revert(input) && check_unchanged(input) && check_engine_session();
+    if (!ok) return 1;
+
+    printf("growing gap test: PASS\n");
+    return 0;
+}
@@ -0,0 +1,233 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ca_engine.h"
+#include "mutation_plan.h"
+#include "table_rng.h"
+#include "growing_test_support.h"
+
+static const uint32_t kIntSeq[] = {
+    19, 4, 27, 12, 0, 23, 8, 31, 15, 2, 26, 10, 21, 6, 29, 17,
+    1, 24, 13, 30, 7, 18, 3, 28, 11, 22, 5, 25, 14, 9, 20, 16,
+};
+
+#define INPUT_LEN 256u
+#define ENGINE_INPUT_LEN 4096u
+
+// Checks that segments and patch agree with the expected output.
+static bool paths_agree(const normalized_plan_t *plan, const uint8_t *input,
+                        const uint8_t *expected) {
+    mutation_segments_t segments = {0};
+    bool changed = false;
+    bool ok = mutation_plan_segments(plan, input, INPUT_LEN, &segments, &changed) ==
+                  CA_STATUS_OK &&
+              segments.total_len == INPUT_LEN && changed;
+    for (size_t i = 0, offset = 0; ok && i < segments.count; ++i) {
+        ok = memcmp(segments.segments[i].data, expected + offset,
+                    segments.segments[i].len) == 0;
+        offset += segments.segments[i].len;
+    }
+    mutation_segments_free(&segments);
+
+    uint8_t patched[INPUT_LEN];
+    memcpy(patched, input, INPUT_LEN);
+    return ok &&
+           mutation_plan_patch(plan, patched, INPUT_LEN, &changed) == CA_STATUS_OK &&
+           changed && memcmp(patched, expected, INPUT_LEN) == 0;
+}
+
+// Carries across the field in both byte orders, wraps at the field width, and
+// sign-extends set values.
+static bool check_arithmetic(const uint8_t *input) {
+    ca_plan_limits_t limits = {.max_output_len = INPUT_LEN, .input_len = INPUT_LEN,
+                               .input = input};
+    mutation_plan_t plan;
+    normalized_plan_t normalized = {0};
+    bool ok = mutation_plan_init(&plan) == CA_STATUS_OK &&
+              mutation_plan_add_add_int(&plan, 10, 4, false, 1, 4, 0) == CA_STATUS_OK &&
+              mutation_plan_add_add_int(&plan, 20, 2, true, 1, 4, 1) == CA_STATUS_OK &&
+              mutation_plan_add_sub_int(&plan, 32, 8, false, 1, 4, 2) == CA_STATUS_OK &&
+              mutation_plan_add_set_int(&plan, 48, 8, true, -2, 4, 3) == CA_STATUS_OK &&
+              mutation_plan_add_sub_int(&plan, 64, 2, false, 0x10001u, 4, 4) ==
+                  CA_STATUS_OK &&
+              mutation_plan_normalize(&plan, &limits, &normalized) == CA_STATUS_OK &&
+              normalized.op_count == 5 && normalized.extra_bytes_len == 0;
+
+    uint8_t expected[INPUT_LEN];
+    memcpy(expected, input, INPUT_LEN);
+    static const uint8_t le_carry[] = {0x00, 0x00, 0x01, 0x00};
+    static const uint8_t be_carry[] = {0x01, 0x00};
+    static const uint8_t set_be[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE};
+    memcpy(expected + 10, le_carry, sizeof(le_carry));
+    memcpy(expected + 20, be_carry, sizeof(be_carry));
+    memset(expected + 32, 0xFF, 8);
+    memcpy(expected + 48, set_be, sizeof(set_be));
+    // 0x10001 wraps to a 16-bit delta of 1: 0x0000 - 1 = 0xFFFF.
+    memset(expected + 64, 0xFF, 2);
+
+    size_t out_len = 0;
+    uint8_t *out = ok ? grow_apply_owned(&normalized, input, INPUT_LEN, &out_len) : NULL;
+    ok = ok && out && out_len == INPUT_LEN && memcmp(out, expected, INPUT_LEN) == 0 &&
+         paths_agree(&normalized, input, expected);
+    if (!ok) fprintf(stderr, "integer arithmetic mismatch\n");
+
+    free(out);
+    normalized_plan_free(&normalized);
+    mutation_plan_destroy(&plan);
+    return ok;
+}
+
+// Integer ops own their field like ranges, and no-op or malformed ones are rejected.
+static bool check_validation(const uint8_t *input) {
+    ca_plan_limits_t limits = {.max_output_len = INPUT_LEN, .input_len = INPUT_LEN,
+                               .input = input};
+    mutation_plan_t plan;
+    normalized_plan_t normalized = {0};
+
+    // A SET_INT of the value already stored (zero at 6) and a delta of 0 are
+    // dropped; the point op inside the higher-ranked field loses; the width-3 field
+    // never enters the plan; and the field running past the end is dropped.
+    bool ok =
+        mutation_plan_init(&plan) == CA_STATUS_OK &&
+        mutation_plan_add_set_int(&plan, 6, 4, false, 0, 9, 0) == CA_STATUS_OK &&
+        mutation_plan_add_add_int(&plan, 100, 2, false, 0, 9, 1) == CA_STATUS_OK &&
+        mutation_plan_add_add_int(&plan, 120, 8, true, 3, 9, 2) == CA_STATUS_OK &&
+        mutation_plan_add_set_byte(&plan, 124, 0x55u, 1, 3) == CA_STATUS_OK &&
+        mutation_plan_add_add_int(&plan, 140, 3, false, 1, 9, 4) ==
+            CA_STATUS_INVALID_ARGUMENT &&
+        mutation_plan_add_sub_int(&plan, INPUT_LEN - 2u, 4, false, 1, 9, 5) ==
+            CA_STATUS_OK &&
+        mutation_plan_normalize(&plan, &limits, &normalized) == CA_STATUS_OK &&
+        normalized.op_count == 1 && normalized.ops[0].kind == CA_OP_ADD_INT &&
+        normalized.ops[0].pos == 120u;
+    if (!ok) fprintf(stderr, "integer op validation mismatch\n");
+    normalized_plan_free(&normalized);
+    mutation_plan_destroy(&plan);
+    return ok;
+}
+
+// Stacked integer ops on the same field compose into one plan; the composed
+// output must match applying both in turn.
+static bool check_compose(const uint8_t *input) {
+    ca_plan_limits_t limits = {.max_output_len = INPUT_LEN, .input_len = INPUT_LEN,
+                               .input = input};
+    mutation_plan_t plan_a;
+    mutation_plan_t plan_b;
+    normalized_plan_t a = {0};
+    normalized_plan_t b = {0};
+    normalized_plan_t fused = {0};
+    bool ok = mutation_plan_init(&plan_a) == CA_STATUS_OK &&
+              mutation_plan_init(&plan_b) == CA_STATUS_OK &&
+              mutation_plan_add_add_int(&plan_a, 30, 4, true, 35, 2, 0) == CA_STATUS_OK &&
+              mutation_plan_add_set_int(&plan_a, 90, 2, false, 1000, 2, 1) ==
+                  CA_STATUS_OK &&
+              mutation_plan_normalize(&plan_a, &limits, &a) == CA_STATUS_OK;
+    size_t a_len = 0;
+    uint8_t *a_out = ok ? grow_apply_owned(&a, input, INPUT_LEN, &a_len) : NULL;
+    ca_plan_limits_t b_limits = {.max_output_len = INPUT_LEN, .input_len = a_len,
+                                 .input = a_out};
+    ok = ok && a_out &&
+         mutation_plan_add_sub_int(&plan_b, 30, 4, true, 36, 2, 0) == CA_STATUS_OK &&
+         mutation_plan_add_set_int(&plan_b, 91, 4, false, -1, 2, 1) == CA_STATUS_OK &&
+         mutation_plan_normalize(&plan_b, &b_limits, &b) == CA_STATUS_OK &&
+         b.op_count == 2;
+    size_t b_len = 0;
+    uint8_t *b_out = ok ? grow_apply_owned(&b, a_out, a_len, &b_len) : NULL;
+    size_t fused_len = 0;
+    uint8_t *fused_out = NULL;
+    ok = ok && b_out &&
+         mutation_plan_compose(&a, &b, NULL, INPUT_LEN, &fused) ==
+             CA_STATUS_INVALID_ARGUMENT &&
+         mutation_plan_compose(&a, &b, input, INPUT_LEN, &fused) == CA_STATUS_OK &&
+         (fused_out = grow_apply_owned(&fused, input, INPUT_LEN, &fused_len)) != NULL &&
+         fused_len == b_len && memcmp(fused_out, b_out, b_len) == 0;
+    if (!ok) fprintf(stderr, "integer compose mismatch\n");
+
+    free(a_out);
+    free(b_out);
+    free(fused_out);
+    normalized_plan_free(&a);
+    normalized_plan_free(&b);
+    normalized_plan_free(&fused);
+    mutation_plan_destroy(&plan_a);
+    mutation_plan_destroy(&plan_b);
+    return ok;
+}
+
+// With only the integer kind weighted, the engine emits only integer ops, each
+// inside the input, and at least one of each width shows up over the session.
+static bool check_engine(void) {
+    static uint8_t input[ENGINE_INPUT_LEN];
+    table_rng_state_t rng = {0};
+    table_rng_init(&rng, kIntSeq, sizeof(kIntSeq) / sizeof(*kIntSeq));
+    ca_rng_t rnd = {.below = table_rng_below, .context = &rng};
+    ca_growing_params_t params;
+    ca_growing_params_init(&params);
+    params.kind_weights[6] = 1u;
+    const ca_engine_config_t config = {.user_context = NULL, .growing_params = &params};
+    ca_engine_t *engine = NULL;
+    if (ca_engine_create_growing(&config, rnd, &engine) != CA_STATUS_OK) return false;
+
+    bool ok = true;
+    bool seen_width[9] = {false};
+    size_t emitted = 0;
+    for (size_t call = 0; call < 64 && ok; ++call) {
+        // A fresh input per call moves the top-ranked cells around.
+        for (size_t i = 0; i < ENGINE_INPUT_LEN; ++i) {
+            input[i] = (uint8_t)(i * 29u + (i >> 5) * (call + 1u));
+        }
+        ca_mutate_request_t request = {
+            .input = input,
+            .input_len = ENGINE_INPUT_LEN,
+            .max_output_len = ENGINE_INPUT_LEN * 2u,
+            .mutation_id = (uint64_t)call,
+        };
+        ca_output_t output = {0};
+        if (ca_engine_mutate(engine, &request, &output) != CA_STATUS_OK) continue;
+        ca_plan_limits_t limits = {.max_output_len = ENGINE_INPUT_LEN * 2u,
+                                   .input_len = ENGINE_INPUT_LEN, .input = input};
+        normalized_plan_t normalized = {0};
+        ok = mutation_plan_normalize(output.value.plan, &limits, &normalized) ==
+             CA_STATUS_OK;
+        for (size_t i = 0; ok && i < normalized.op_count; ++i) {
+            const mutation_op_t *op = &normalized.ops[i];
+            ok = (op->kind == CA_OP_ADD_INT || op->kind == CA_OP_SUB_INT ||
+                  op->kind == CA_OP_SET_INT) &&
+                 op->pos + op->len <= ENGINE_INPUT_LEN;
+            if (ok) seen_width[op->len] = true;
+            ++emitted;
+        }
+        normalized_plan_free(&normalized);
+    }
+    ca_engine_destroy(engine);
+    if (!ok) {
+        fprintf(stderr, "engine emitted a non-integer op\n");
+    } else if (emitted < 16 || !seen_width[2] || !seen_width[4] || !seen_width[8]) {
+        fprintf(stderr, "engine integer ops too narrow: %zu emitted\n", emitted);
+        ok = false;
+    }
+    return ok;
+}
+
+int main(void) {
+    static uint8_t input[INPUT_LEN];
+    for (size_t i = 0; i < INPUT_LEN; ++i) input[i] = (uint8_t)(0x41u + (i * 7u) % 26u);
+    // Fields for the arithmetic checks: carries at 10 (LE) and 20 (BE), zeros at
+    // 32 and 64 to wrap, and a zero word at 6 for the no-op set.
+    static const uint8_t le_field[] = {0xFF, 0xFF, 0x00, 0x00};
+    static const uint8_t be_field[] = {0x00, 0xFF};
+    memset(input + 6, 0x00, 4);
+    memcpy(input + 10, le_field, sizeof(le_field));
+    memcpy(input + 20, be_field, sizeof(be_field));
+    memset(input + 32, 0x00, 8);
+    memset(input + 64, 0x00, 2);
+
+    bool ok = check_arithmetic(input) && check_validation(input) && check_compose(input) &&
+              check_engine();
+    if (!ok) return 1;
+
+    printf("growing int test: PASS\n");
+    return 0;
+}
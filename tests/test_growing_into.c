@@ -0,0 +1,105 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ca_engine.h"
+#include "table_rng.h"
+#include "growing_test_support.h"
+
+static const uint32_t kIntoSeq[] = {
+    21, 6, 14, 29, 3, 18, 10, 25, 1, 30, 12, 7, 23, 16, 4, 27,
+    9, 19, 0, 24, 13, 31, 5, 17, 28, 2, 22, 11, 26, 8, 15, 20,
+};
+
+#define INPUT_LEN 1024u
+#define DST_CAP (INPUT_LEN + 64u)
+
+// Drives ca_engine_mutate_into and the mutate + normalize + apply path on paired
+// engines and checks that both produce the same bytes and skips.
+static bool check_pair(uint32_t flags, const uint8_t *input, size_t input_len,
+                       size_t dst_cap) {
+    table_rng_state_t rng1 = {0};
+    table_rng_state_t rng2 = {0};
+    const size_t seq_len = sizeof(kIntoSeq) / sizeof(*kIntoSeq);
+    table_rng_init(&rng1, kIntoSeq, seq_len);
+    table_rng_init(&rng2, kIntoSeq, seq_len);
+    ca_rng_t rnd1 = {.below = table_rng_below, .context = &rng1};
+    ca_rng_t rnd2 = {.below = table_rng_below, .context = &rng2};
+    const ca_engine_config_t config = {.flags = flags};
+
+    ca_engine_t *into = NULL;
+    ca_engine_t *plan = NULL;
+    if (ca_engine_create_growing(&config, rnd1, &into) != CA_STATUS_OK) return false;
+    if (ca_engine_create_growing(&config, rnd2, &plan) != CA_STATUS_OK) {
+        ca_engine_destroy(into);
+        return false;
+    }
+
+    uint8_t *dst = (uint8_t *)malloc(dst_cap);
+    bool ok = dst != NULL;
+    size_t mutated = 0;
+    for (size_t call = 0; call < 24 && ok; ++call) {
+        // The request asks for more than `dst` holds: dst_cap must win.
+        ca_mutate_request_t request = {
+            .input = input,
+            .input_len = input_len,
+            .max_output_len = INPUT_LEN * 4u,
+            .mutation_id = (uint64_t)call,
+        };
+        size_t out_len = 0;
+        ca_status_t status = ca_engine_mutate_into(into, &request, dst, dst_cap, &out_len);
+
+        grow_result_t expected = {0};
+        if (!grow_mutate_to_owned_buffer(plan, input, input_len, dst_cap, (uint64_t)call,
+                                         &expected)) {
+            fprintf(stderr, "reference invoke failed at call=%zu\n", call);
+            ok = false;
+        } else if (expected.is_skip) {
+            if (status != CA_STATUS_SKIP && status != CA_STATUS_OUTPUT_TOO_LARGE) {
+                fprintf(stderr, "into did not skip at call=%zu (status=%d)\n", call,
+                        (int)status);
+                ok = false;
+            }
+        } else if (status != CA_STATUS_OK || out_len != expected.len ||
+                   memcmp(dst, expected.data, out_len) != 0) {
+            fprintf(stderr, "into mismatch at call=%zu\n", call);
+            ok = false;
+        } else if (out_len > dst_cap) {
+            fprintf(stderr, "into exceeded dst_cap at call=%zu\n", call);
+            ok = false;
+        } else {
+            ++mutated;
+        }
+        grow_result_free(&expected);
+    }
+
+    if (ok && mutated == 0) {
+        fprintf(stderr, "into produced no mutations (flags=%u)\n", flags);
+        ok = false;
+    }
+
+    free(dst);
+    ca_engine_destroy(into);
+    ca_engine_destroy(plan);
+    return ok;
+}
+
+int main(void) {
+    uint8_t *input = (uint8_t *)malloc(INPUT_LEN);
+    if (!input) return 1;
+    for (size_t i = 0; i < INPUT_LEN; ++i) {
+        input[i] = (uint8_t)(0x20u + (i * 53u) % 0x5Fu);
+    }
+
+    bool ok = true;
+    ok = ok && check_pair(0u, input, INPUT_LEN, DST_CAP);
+    ok = ok && check_pair(0u, input, INPUT_LEN, INPUT_LEN);
+    ok = ok && check_pair(CA_ENGINE_FLAG_LENGTH_PRESERVING, input, INPUT_LEN, INPUT_LEN);
+
+    free(input);
+    if (!ok) return 1;
+
+    printf("growing mutate-into test: PASS\n");
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ca_engine.h"
+#include "mutation_plan.h"
+#include "table_rng.h"
+
+static const uint32_t kLengthSeq[] = {
+    12, 3, 27, 18, 6, 31, 9, 22, 0, 15, 25, 4, 19, 11, 29, 7,
+    24, 1, 16, 30, 8, 21, 13, 2, 26, 10, 17, 5, 28, 14, 23, 20,
+};
+
+#define INPUT_LEN 2048u
+
+// Checks that length-preserving plans contain only point ops and that patching a copy
+// of the input in place matches the general apply path byte for byte.
+static bool check_plan(const mutation_plan_t *plan, const uint8_t *input, size_t call,
+                       size_t *changed_count) {
+    ca_plan_limits_t limits = {
+        .max_ops = 0,
+        .max_output_len = INPUT_LEN,
+        .input_len = INPUT_LEN,
+        .input = input,
+    };
+    normalized_plan_t normalized = {0};
+    if (mutation_plan_normalize(plan, &limits, &normalized) != CA_STATUS_OK) {
+        fprintf(stderr, "normalize failed at call=%zu\n", call);
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < plan->op_count; ++i) {
+        if (plan->ops[i].kind == CA_OP_INSERT_BYTES ||
+            plan->ops[i].kind == CA_OP_DELETE_RANGE) {
+            fprintf(stderr, "length-changing op at call=%zu\n", call);
+            ok = false;
+        }
+    }
+
+    uint8_t *applied = (uint8_t *)malloc(INPUT_LEN);
+    uint8_t *patched = (uint8_t *)malloc(INPUT_LEN);
+    if (!applied || !patched) ok = false;
+
+    size_t written = 0;
+    bool changed = false;
+    bool applied_changed = false;
+    if (ok && (mutation_plan_apply(&normalized, input, INPUT_LEN, applied, INPUT_LEN,
+                                   &written, &applied_changed) != CA_STATUS_OK ||
+               written != INPUT_LEN)) {
+        fprintf(stderr, "apply failed at call=%zu\n", call);
+        ok = false;
+    }
+    if (ok) {
+        memcpy(patched, input, INPUT_LEN);
+        if (mutation_plan_patch(&normalized, patched, INPUT_LEN, &changed) !=
+            CA_STATUS_OK) {
+            fprintf(stderr, "patch failed at call=%zu\n", call);
+            ok = false;
+        }
+    }
+    if (ok && memcmp(applied, patched, INPUT_LEN) != 0) {
+        fprintf(stderr, "patch and apply disagree at call=%zu\n", call);
+        ok = false;
+    }
+    if (ok && (changed != applied_changed ||
+               changed != (memcmp(patched, input, INPUT_LEN) != 0))) {
+        fprintf(stderr, "patch change flag wrong at call=%zu\n", call);
+        ok = false;
+    }
+    if (ok && changed) ++*changed_count;
+
+    free(applied);
+    free(patched);
+    normalized_plan_free(&normalized);
+    return ok;
+}
+
+int main(void) {
+    table_rng_state_t rng = {0};
+    table_rng_init(&rng, kLengthSeq, sizeof(kLengthSeq) / sizeof(*kLengthSeq));
+    ca_rng_t rnd = {.below = table_rng_below, .context = &rng};
+
+    ca_growing_params_t params;
+    ca_growing_params_init(&params);
+    const ca_engine_config_t plain = {.flags = CA_ENGINE_FLAG_LENGTH_PRESERVING};
+    const ca_engine_config_t weighted = {.flags = CA_ENGINE_FLAG_LENGTH_PRESERVING,
+                                         .growing_params = &params};
+    // Weights on insert/delete only: length-preserving mode must ignore them and fall
+    // back to the uniform point-op draw.
+    params.kind_weights[4] = 5u;
+    params.kind_weights[5] = 9u;
+
+    ca_engine_t *engines[2] = {NULL, NULL};
+    if (ca_engine_create_growing(&plain, rnd, &engines[0]) != CA_STATUS_OK ||
+        ca_engine_create_growing(&weighted, rnd, &engines[1]) != CA_STATUS_OK) {
+        ca_engine_destroy(engines[0]);
+        return 1;
+    }
+
+    uint8_t *input = (uint8_t *)malloc(INPUT_LEN);
+    if (!input) {
+        ca_engine_destroy(engines[0]);
+        ca_engine_destroy(engines[1]);
+        return 1;
+    }
+    for (size_t i = 0; i < INPUT_LEN; ++i) {
+        input[i] = (uint8_t)(0x20u + (i * 37u) % 0x5Fu);
+    }
+
+    bool ok = true;
+    size_t changed = 0;
+    for (size_t call = 0; call < 32 && ok; ++call) {
+        ca_engine_t *engine = engines[call & 1u];
+        ca_mutate_request_t request = {
+            .input = input,
+            .input_len = INPUT_LEN,
+            .max_output_len = INPUT_LEN,
+            .mutation_id = (uint64_t)call,
+        };
+        ca_output_t output = {0};
+        ca_status_t status = ca_engine_mutate(engine, &request, &output);
+        if (status == CA_STATUS_SKIP) continue;
+        if (status != CA_STATUS_OK || output.kind != CA_OUTPUT_PLAN ||
+            !output.value.plan) {
+            fprintf(stderr, "mutate failed at call=%zu\n", call);
+            ok = false;
+            break;
+        }
+        ok = check_plan(output.value.plan, input, call, &changed);
+    }
+
+    if (ok) {
+        // An empty input cannot be mutated without changing its length.
+        ca_mutate_request_t request = {.input = input, .max_output_len = INPUT_LEN};
+        ca_output_t output = {0};
+        if (ca_engine_mutate(engines[0], &request, &output) != CA_STATUS_SKIP) {
+            fprintf(stderr, "empty input was not skipped\n");
+            ok = false;
+        }
+    }
+
+    if (ok && changed == 0) {
+        fprintf(stderr, "length-preserving mode produced no changes\n");
+        ok = false;
+    }
+
+    free(input);
+    ca_engine_destroy(engines[0]);
+    ca_engine_destroy(engines[1]);
+    if (!ok) return 1;
+
+    printf("growing length-preserving test: PASS\n");
+    return 0;
+}
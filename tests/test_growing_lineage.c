@@ -0,0 +1,100 @@
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "ca_engine.h"
+#include "table_rng.h"
+#include "growing_test_support.h"
+
+static const uint32_t kLineageSeq[] = {
+    5, 27, 14, 3, 20, 9, 31, 12, 1, 24, 17, 6, 29, 10, 22, 15,
+    8, 26, 0, 19, 13, 30, 4, 21, 11, 28, 2, 16, 25, 7, 18, 23,
+};
+
+int main(void) {
+    const size_t seq_len = sizeof(kLineageSeq) / sizeof(*kLineageSeq);
+    table_rng_state_t rng1 = {0};
+    table_rng_state_t rng2 = {0};
+    table_rng_init(&rng1, kLineageSeq, seq_len);
+    table_rng_init(&rng2, kLineageSeq, seq_len);
+
+    ca_rng_t rnd1 = {.below = table_rng_below, .context = &rng1};
+    ca_rng_t rnd2 = {.below = table_rng_below, .context = &rng2};
+    const ca_engine_config_t lineage = {.user_context = NULL,
+                                        .flags = CA_ENGINE_FLAG_LINEAGE};
+
+    ca_engine_t *engine1 = NULL;
+    ca_engine_t *engine2 = NULL;
+    if (ca_engine_create_growing(&lineage, rnd1, &engine1) != CA_STATUS_OK) return 1;
+    if (ca_engine_create_growing(&lineage, rnd2, &engine2) != CA_STATUS_OK) {
+        ca_engine_destroy(engine1);
+        return 1;
+    }
+
+    static const uint8_t seed_a[] = {[0 ... 511] = 0x41};
+    static const uint8_t seed_b[] = "lineage mode switches to a different seed\n";
+
+    bool ok = true;
+    size_t distinct = 0;
+    grow_result_t prev = {.is_skip = 1};
+
+    // Same seed repeatedly: both engines must stay in lockstep while the evolved
+    // state keeps advancing between calls.
+    for (size_t call = 0; call < 32 && ok; ++call) {
+        grow_result_t r1 = {0};
+        grow_result_t r2 = {0};
+        if (!grow_mutate_to_owned_buffer(engine1, seed_a, sizeof(seed_a), 4096,
+                                        (uint64_t)call, &r1) ||
+            !grow_mutate_to_owned_buffer(engine2, seed_a, sizeof(seed_a), 4096,
+                                        (uint64_t)call, &r2)) {
+            fprintf(stderr, "invoke failed at call=%zu\n", call);
+            ok = false;
+        } else if (!grow_result_equal(&r1, &r2)) {
+            fprintf(stderr, "lineage determinism mismatch at call=%zu\n", call);
+            ok = false;
+        } else if (!r1.is_skip && !grow_result_equal(&r1, &prev)) {
+            ++distinct;
+        }
+
+        grow_result_free(&prev);
+        prev = r1;
+        grow_result_free(&r2);
+    }
+    grow_result_free(&prev);
+
+    if (ok && distinct < 2) {
+        fprintf(stderr, "lineage produced too few distinct outputs: %zu\n", distinct);
+        ok = false;
+    }
+
+    // Switching seeds must start a fresh lineage: a new engine with the same RNG
+    // position has to produce the same result.
+    if (ok) {
+        table_rng_state_t rng3 = rng1;
+        ca_rng_t rnd3 = {.below = table_rng_below, .context = &rng3};
+        ca_engine_t *fresh = NULL;
+        if (ca_engine_create_growing(&lineage, rnd3, &fresh) != CA_STATUS_OK) {
+            ok = false;
+        } else {
+            grow_result_t r1 = {0};
+            grow_result_t r3 = {0};
+            if (!grow_mutate_to_owned_buffer(engine1, seed_b, sizeof(seed_b) - 1, 4096,
+                                            100, &r1) ||
+                !grow_mutate_to_owned_buffer(fresh, seed_b, sizeof(seed_b) - 1, 4096,
+                                            100, &r3) ||
+                !grow_result_equal(&r1, &r3)) {
+                fprintf(stderr, "lineage did not reset after input switch\n");
+                ok = false;
+            }
+            grow_result_free(&r1);
+            grow_result_free(&r3);
+            ca_engine_destroy(fresh);
+        }
+    }
+
+    ca_engine_destroy(engine1);
+    ca_engine_destroy(engine2);
+    if (!ok) return 1;
+
+    printf("growing lineage test: PASS\n");
+    return 0;
+}
@@ -3,6 +3,7 @@
 #include <string.h>
 
 #include "ca_engine.h"
+#include "mutation_plan.h"
 #include "table_rng.h"
 #include "growing_test_support.h"
 
@@ -80,6 +81,45 @@ int main(void) {
     }
     grow_result_free(&r);
 
+    // A delete and an insert that cancel out must not be reported as a change, while
+    // the same shape with a different byte must be.
+    const uint8_t same_run[] = {0x41, 0x41, 0x41, 0x41, 0x42};
+    for (uint8_t value = 0x41; ok && value <= 0x42; ++value) {
+        mutation_plan_t plan = {0};
+        normalized_plan_t normalized = {0};
+        ca_plan_limits_t limits = {.max_output_len = 64,
+                                   .input_len = sizeof(same_run),
+                                   .input = same_run};
+        uint8_t out[64];
+        size_t written = 0;
+        bool changed = true;
+        if (mutation_plan_init(&plan) != CA_STATUS_OK ||
+            mutation_plan_add_delete_range(&plan, 0, 1, 2, 0) != CA_STATUS_OK ||
+            mutation_plan_add_insert_bytes(&plan, 2, &value, 1, 1, 0) != CA_STATUS_OK ||
+            mutation_plan_normalize(&plan, &limits, &normalized) != CA_STATUS_OK ||
+            normalized.op_count != 2 ||
+            mutation_plan_apply(&normalized, same_run, sizeof(same_run), out, sizeof(out),
+                                &written, &changed) != CA_STATUS_OK) {
+            fprintf(stderr, "cancelling plan could not be applied\n");
+            ok = false;
+        } else if (changed != (value != 0x41)) {
+            fprintf(stderr, "cancelling plan change flag wrong for value=%u\n", value);
+            ok = false;
+        } else {
+            mutation_segments_t segments = {0};
+            bool segments_changed = true;
+            if (mutation_plan_segments(&normalized, same_run, sizeof(same_run), &segments,
+                                       &segments_changed) != CA_STATUS_OK ||
+                segments.total_len != written || segments_changed != changed) {
+                fprintf(stderr, "cancelling plan segments wrong for value=%u\n", value);
+                ok = false;
+            }
+            mutation_segments_free(&segments);
+        }
+        normalized_plan_free(&normalized);
+        mutation_plan_destroy(&plan);
+    }
+
     ca_engine_destroy(engine);
     if (!ok) return 1;
 
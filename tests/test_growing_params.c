@@ -0,0 +1,148 @@
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "ca_engine.h"
+#include "growing_engine.h"
+#include "table_rng.h"
+#include "growing_test_support.h"
+
+static const uint32_t kParamsSeq[] = {
+    6, 21, 13, 28, 2, 17, 9, 30, 4, 25, 11, 19, 0, 23, 15, 8,
+    27, 3, 18, 12, 31, 7, 22, 1, 26, 14, 5, 29, 10, 20, 16, 24,
+};
+
+// Runs two engines built from `a` and `b` over the same RNG stream and reports
+// whether every output matched.
+static bool sessions_match(const ca_engine_config_t *a, const ca_engine_config_t *b,
+                           const uint8_t *input, size_t input_len) {
+    const size_t seq_len = sizeof(kParamsSeq) / sizeof(*kParamsSeq);
+    table_rng_state_t rng1 = {0};
+    table_rng_state_t rng2 = {0};
+    table_rng_init(&rng1, kParamsSeq, seq_len);
+    table_rng_init(&rng2, kParamsSeq, seq_len);
+    ca_rng_t rnd1 = {.below = table_rng_below, .context = &rng1};
+    ca_rng_t rnd2 = {.below = table_rng_below, .context = &rng2};
+
+    ca_engine_t *engine1 = NULL;
+    ca_engine_t *engine2 = NULL;
+    if (ca_engine_create_growing(a, rnd1, &engine1) != CA_STATUS_OK) return false;
+    if (ca_engine_create_growing(b, rnd2, &engine2) != CA_STATUS_OK) {
+        ca_engine_destroy(engine1);
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t call = 0; call < 16 && ok; ++call) {
+        grow_result_t r1 = {0};
+        grow_result_t r2 = {0};
+        ok = grow_mutate_to_owned_buffer(engine1, input, input_len, 8192,
+                                         (uint64_t)call, &r1) &&
+             grow_mutate_to_owned_buffer(engine2, input, input_len, 8192,
+                                         (uint64_t)call, &r2) &&
+             grow_result_equal(&r1, &r2);
+        grow_result_free(&r1);
+        grow_result_free(&r2);
+    }
+
+    ca_engine_destroy(engine1);
+    ca_engine_destroy(engine2);
+    return ok;
+}
+
+int main(void) {
+    static uint8_t input[4096];
+    for (size_t i = 0; i < sizeof(input); ++i) {
+        input[i] = (uint8_t)(0x20u + (i * 29u) % 0x5Fu);
+    }
+
+    bool ok = true;
+
+    // Explicit defaults must behave exactly like no parameter block.
+    ca_growing_params_t defaults;
+    ca_growing_params_init(&defaults);
+    const ca_engine_config_t implicit = {.user_context = NULL};
+    const ca_engine_config_t explicit_defaults = {.user_context = NULL,
+                                                  .growing_params = &defaults};
+    if (!sessions_match(&implicit, &explicit_defaults, input, sizeof(input))) {
+        fprintf(stderr, "default parameter block changed behavior\n");
+        ok = false;
+    }
+
+    // Adaptive block size and tuned stepping must stay deterministic.
+    ca_growing_params_t tuned = defaults;
+    tuned.max_cells = 16u;
+    tuned.min_steps = 2u;
+    tuned.max_steps = 3u;
+    tuned.update_percent = 100u;
+    tuned.weights[0] = 1;
+    tuned.weights[3] = 5;
+    const ca_engine_config_t tuned_config = {.user_context = NULL,
+                                             .growing_params = &tuned};
+    if (!sessions_match(&tuned_config, &tuned_config, input, sizeof(input))) {
+        fprintf(stderr, "tuned parameters are not deterministic\n");
+        ok = false;
+    }
+
+    // Kind weights: only SET_BYTE keeps the length, then switching at runtime to
+    // only INSERT_BYTES grows every output.
+    ca_growing_params_t set_only = defaults;
+    set_only.kind_weights[1] = 1u;
+    const ca_engine_config_t set_config = {.user_context = NULL,
+                                           .growing_params = &set_only};
+    table_rng_state_t kind_rng = {0};
+    table_rng_init(&kind_rng, kParamsSeq, sizeof(kParamsSeq) / sizeof(*kParamsSeq));
+    ca_rng_t kind_rnd = {.below = table_rng_below, .context = &kind_rng};
+    ca_engine_t *kind_engine = NULL;
+    if (ca_engine_create_growing(&set_config, kind_rnd, &kind_engine) != CA_STATUS_OK) {
+        ok = false;
+    }
+    static const uint32_t insert_only[] = {0, 0, 0, 0, 0, 1};
+    for (size_t call = 0; call < 32 && ok; ++call) {
+        if (call == 16 &&
+            ca_growing_set_kind_weights(kind_engine, insert_only,
+                                        sizeof(insert_only) / sizeof(*insert_only)) !=
+                CA_STATUS_OK) {
+            ok = false;
+            break;
+        }
+        grow_result_t r = {0};
+        if (!grow_mutate_to_owned_buffer(kind_engine, input, sizeof(input), 8192, call,
+                                        &r)) {
+            ok = false;
+        } else if (!r.is_skip && (call < 16) != (r.len == sizeof(input))) {
+            fprintf(stderr, "kind weights ignored at call=%zu (len=%zu)\n", call, r.len);
+            ok = false;
+        }
+        grow_result_free(&r);
+    }
+    ca_engine_destroy(kind_engine);
+
+    // Malformed blocks are rejected at creation.
+    ca_growing_params_t bad_version = defaults;
+    bad_version.version = CA_GROWING_PARAMS_VERSION + 1u;
+    ca_growing_params_t bad_steps = defaults;
+    bad_steps.min_steps = 4u;
+    bad_steps.max_steps = 2u;
+    ca_growing_params_t bad_block = defaults;
+    bad_block.block_size = 0u;
+    const ca_growing_params_t *rejected[] = {&bad_version, &bad_steps, &bad_block};
+    for (size_t i = 0; i < sizeof(rejected) / sizeof(*rejected); ++i) {
+        table_rng_state_t rng = {0};
+        table_rng_init(&rng, kParamsSeq, sizeof(kParamsSeq) / sizeof(*kParamsSeq));
+        ca_rng_t rnd = {.below = table_rng_below, .context = &rng};
+        const ca_engine_config_t config = {.user_context = NULL,
+                                           .growing_params = rejected[i]};
+        ca_engine_t *engine = NULL;
+        if (ca_engine_create_growing(&config, rnd, &engine) !=
+            CA_STATUS_INVALID_ARGUMENT) {
+            fprintf(stderr, "invalid parameter block %zu accepted\n", i);
+            ca_engine_destroy(engine);
+            ok = false;
+        }
+    }
+
+    if (!ok) return 1;
+
+    printf("growing params test: PASS\n");
+    return 0;
+}
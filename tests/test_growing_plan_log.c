@@ -0,0 +1,205 @@
+#define _GNU_SOURCE
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ca_engine.h"
+#include "mutation_plan.h"
+#include "plan_log.h"
+#include "table_rng.h"
+
+static const uint32_t kPlanLogSeq[] = {
+    14, 2, 29, 8, 21, 0, 17, 26, 5, 31, 11, 23, 3, 19, 9, 28,
+    1, 24, 15, 6, 30, 12, 20, 4, 27, 10, 18, 7, 25, 13, 22, 16,
+};
+
+#define INPUT_LEN 512u
+#define CALLS 24u
+
+typedef struct {
+    uint64_t mutation_id;
+    uint8_t *output;
+    size_t output_len;
+} expected_t;
+
+static bool apply_plan(const normalized_plan_t *plan, const uint8_t *input,
+                       uint8_t **output, size_t *output_len) {
+    size_t len = 0;
+    if (mutation_plan_measure(plan, INPUT_LEN, &len) != CA_STATUS_OK || len == 0) {
+        return false;
+    }
+    *output = (uint8_t *)malloc(len);
+    bool changed = false;
+    size_t written = 0;
+    if (!*output || mutation_plan_apply(plan, input, INPUT_LEN, *output, len, &written,
+                                        &changed) != CA_STATUS_OK ||
+        written != len) {
+        return false;
+    }
+    *output_len = len;
+    return true;
+}
+
+// Records every plan the growing engine produces, plus one hand-built plan with an
+// insert payload, then checks that replaying the mapped log reproduces each output.
+int main(void) {
+    table_rng_state_t rng = {0};
+    table_rng_init(&rng, kPlanLogSeq, sizeof(kPlanLogSeq) / sizeof(*kPlanLogSeq));
+    ca_rng_t rnd = {.below = table_rng_below, .context = &rng};
+
+    ca_engine_t *engine = NULL;
+    if (ca_engine_create_growing(&(ca_engine_config_t){.user_context = NULL}, rnd,
+                                &engine) != CA_STATUS_OK) {
+        return 1;
+    }
+
+    char path[] = "/tmp/ca_plan_log_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        ca_engine_destroy(engine);
+        return 1;
+    }
+    close(fd);
+
+    static uint8_t input[INPUT_LEN];
+    for (size_t i = 0; i < INPUT_LEN; ++i) input[i] = (uint8_t)(i * 29u + (i >> 4));
+    const uint64_t input_hash = plan_log_hash(input, INPUT_LEN);
+
+    expected_t expected[CALLS + 1u] = {{0}};
+    size_t expected_count = 0;
+    bool ok = true;
+    plan_log_writer_t *writer = NULL;
+
+    // Two writer sessions: reopening must append after the existing header.
+    for (size_t session = 0; session < 2 && ok; ++session) {
+        if (plan_log_writer_open(path, &writer) != CA_STATUS_OK) {
+            fprintf(stderr, "writer open failed in session %zu\n", session);
+            ok = false;
+            break;
+        }
+        for (size_t call = session * (CALLS / 2u); call < (session + 1u) * (CALLS / 2u);
+             ++call) {
+            ca_mutate_request_t request = {
+                .input = input,
+                .input_len = INPUT_LEN,
+                .max_output_len = INPUT_LEN * 2u,
+                .mutation_id = (uint64_t)call,
+            };
+            ca_output_t output = {0};
+            if (ca_engine_mutate(engine, &request, &output) != CA_STATUS_OK) continue;
+            ca_plan_limits_t limits = {
+                .max_output_len = INPUT_LEN * 2u,
+                .input_len = INPUT_LEN,
+                .input = input,
+            };
+            normalized_plan_t normalized = {0};
+            if (mutation_plan_normalize(output.value.plan, &limits, &normalized) ==
+                    CA_STATUS_OK &&
+                normalized.op_count > 0) {
+                expected_t *e = &expected[expected_count];
+                e->mutation_id = (uint64_t)call;
+                if (!apply_plan(&normalized, input, &e->output, &e->output_len) ||
+                    plan_log_append(writer, call, input_hash, INPUT_LEN, &normalized) !=
+                        CA_STATUS_OK) {
+                    fprintf(stderr, "record failed at call=%zu\n", call);
+                    ok = false;
+                }
+                ++expected_count;
+            }
+            normalized_plan_free(&normalized);
+        }
+        plan_log_writer_close(writer);
+        writer = NULL;
+    }
+
+    if (ok) {
+        mutation_plan_t plan;
+        normalized_plan_t normalized = {0};
+        static const uint8_t payload[] = "replayed insert";
+        ca_plan_limits_t limits = {
+            .max_output_len = INPUT_LEN * 2u,
+            .input_len = INPUT_LEN,
+            .input = input,
+        };
+        expected_t *e = &expected[expected_count];
+        e->mutation_id = 1000u;
+        ok = mutation_plan_init(&plan) == CA_STATUS_OK &&
+             mutation_plan_add_set_byte(&plan, 3, 0x7Fu, 1, 0) == CA_STATUS_OK &&
+             mutation_plan_add_insert_bytes(&plan, 40, payload, sizeof(payload) - 1u, 2,
+                                            1) == CA_STATUS_OK &&
+             mutation_plan_normalize(&plan, &limits, &normalized) == CA_STATUS_OK &&
+             apply_plan(&normalized, input, &e->output, &e->output_len) &&
+             plan_log_writer_open(path, &writer) == CA_STATUS_OK &&
+             plan_log_append(writer, e->mutation_id, input_hash, INPUT_LEN,
+                             &normalized) == CA_STATUS_OK;
+        if (ok) ++expected_count;
+        plan_log_writer_close(writer);
+        normalized_plan_free(&normalized);
+        mutation_plan_destroy(&plan);
+        if (!ok) fprintf(stderr, "insert plan record failed\n");
+    }
+
+    if (ok && expected_count < 4) {
+        fprintf(stderr, "too few plans recorded: %zu\n", expected_count);
+        ok = false;
+    }
+
+    plan_log_reader_t reader = {0};
+    if (ok && plan_log_reader_open(path, &reader) != CA_STATUS_OK) {
+        fprintf(stderr, "reader open failed\n");
+        ok = false;
+    }
+    size_t replayed = 0;
+    size_t log_size = reader.size;
+    while (ok) {
+        plan_log_record_t record;
+        ca_status_t status = plan_log_next(&reader, &record);
+        if (status == CA_STATUS_SKIP) break;
+        uint8_t *output = NULL;
+        size_t output_len = 0;
+        const expected_t *e = replayed < expected_count ? &expected[replayed] : NULL;
+        if (status != CA_STATUS_OK || !e || record.mutation_id != e->mutation_id ||
+            record.input_hash != input_hash || record.input_len != INPUT_LEN ||
+            !apply_plan(&record.plan, input, &output, &output_len) ||
+            output_len != e->output_len ||
+            memcmp(output, e->output, output_len) != 0) {
+            fprintf(stderr, "replay mismatch at record %zu\n", replayed);
+            ok = false;
+        }
+        free(output);
+        ++replayed;
+    }
+    plan_log_reader_close(&reader);
+    if (ok && replayed != expected_count) {
+        fprintf(stderr, "replayed %zu of %zu records\n", replayed, expected_count);
+        ok = false;
+    }
+
+    // A record cut short by a crash must be reported, not read past.
+    if (ok && truncate(path, (off_t)log_size - 4) != 0) ok = false;
+    if (ok) {
+        size_t seen = 0;
+        ca_status_t status = plan_log_reader_open(path, &reader);
+        while (status == CA_STATUS_OK) {
+            plan_log_record_t record;
+            status = plan_log_next(&reader, &record);
+            if (status == CA_STATUS_OK) ++seen;
+        }
+        plan_log_reader_close(&reader);
+        if (status != CA_STATUS_INVALID_ARGUMENT || seen + 1u != expected_count) {
+            fprintf(stderr, "truncated log not detected\n");
+            ok = false;
+        }
+    }
+
+    for (size_t i = 0; i < CALLS + 1u; ++i) free(expected[i].output);
+    unlink(path);
+    ca_engine_destroy(engine);
+    if (!ok) return 1;
+
+    printf("growing plan log test: PASS\n");
+    return 0;
+}
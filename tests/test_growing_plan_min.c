@@ -0,0 +1,100 @@
+#define _GNU_SOURCE
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ca_engine.h"
+#include "mutation_plan.h"
+#include "plan_log.h"
+
+#define INPUT_LEN 64u
+
+// Targets for ca-plan-min; "$0" is the candidate file passed through @@. Each one
+// only crashes on outputs holding the inserted "CRASH".
+static const char kSignalTarget[] = "grep -q CRASH \"$0\" && kill -SEGV $$; exit 0";
+static const char kExitTarget[] = "grep -q CRASH \"$0\" && exit 3; exit 0";
+// Crashes only when the user's ASAN_OPTIONS survived next to abort_on_error=1.
+static const char kAsanTarget[] =
+    "case \"$ASAN_OPTIONS\" in detect_leaks=0:*abort_on_error=1) ;; *) exit 0;; esac; "
+    "grep -q CRASH \"$0\" && kill -ABRT $$; exit 0";
+
+// Runs ca-plan-min on mutation 1 of `log` with `target` and checks that it keeps
+// exactly the insert, op 2 of 6.
+static bool check_min(const char *log, const char *input, const char *options,
+                      const char *target, const char *label) {
+    char command[1024];
+    snprintf(command, sizeof(command), "./ca-plan-min %s %s 1 %s -- sh -c '%s' @@",
+             options, log, input, target);
+    FILE *out = popen(command, "r");
+    if (!out) return false;
+    char line[256];
+    bool summary = false;
+    bool insert = false;
+    size_t lines = 0;
+    while (fgets(line, sizeof(line), out)) {
+        ++lines;
+        summary = summary || strstr(line, "1 of 6 ops crash the target") != NULL;
+        insert = insert || strstr(line, "op#2 kind=INSERT_BYTES") != NULL;
+    }
+    bool ok = pclose(out) == 0 && summary && insert && lines == 2u;
+    if (!ok) fprintf(stderr, "ca-plan-min did not isolate the insert: %s\n", label);
+    return ok;
+}
+
+// Logs one six-op plan of which only the insert triggers the targets, then lets
+// ca-plan-min reduce it by signal, by --crash-exit and through ASAN_OPTIONS.
+int main(void) {
+    char log[] = "/tmp/ca_plan_min_log_XXXXXX";
+    char input_path[] = "/tmp/ca_plan_min_input_XXXXXX";
+    int log_fd = mkstemp(log);
+    int input_fd = mkstemp(input_path);
+    if (log_fd < 0 || input_fd < 0) return 1;
+    close(log_fd);
+
+    uint8_t input[INPUT_LEN];
+    memset(input, 'a', sizeof(input));
+    bool ok = write(input_fd, input, sizeof(input)) == (ssize_t)sizeof(input);
+    close(input_fd);
+
+    mutation_plan_t plan;
+    normalized_plan_t normalized = {0};
+    plan_log_writer_t *writer = NULL;
+    static const uint8_t payload[] = "CRASH";
+    const ca_plan_limits_t limits = {
+        .max_output_len = INPUT_LEN * 2u,
+        .input_len = INPUT_LEN,
+        .input = input,
+    };
+    ok = ok && mutation_plan_init(&plan) == CA_STATUS_OK;
+    ok = ok && mutation_plan_add_set_byte(&plan, 2, 'x', 1, 0) == CA_STATUS_OK &&
+         mutation_plan_add_set_byte(&plan, 10, 'y', 1, 1) == CA_STATUS_OK &&
+         mutation_plan_add_insert_bytes(&plan, 20, payload, sizeof(payload) - 1u, 1, 2) ==
+             CA_STATUS_OK &&
+         mutation_plan_add_set_byte(&plan, 30, 'z', 1, 3) == CA_STATUS_OK &&
+         mutation_plan_add_set_byte(&plan, 40, 'w', 1, 4) == CA_STATUS_OK &&
+         mutation_plan_add_set_byte(&plan, 50, 'v', 1, 5) == CA_STATUS_OK &&
+         mutation_plan_normalize(&plan, &limits, &normalized) == CA_STATUS_OK &&
+         normalized.op_count == 6u &&
+         plan_log_writer_open(log, &writer) == CA_STATUS_OK &&
+         plan_log_append(writer, 0, plan_log_hash(input, INPUT_LEN), INPUT_LEN,
+                         &normalized) == CA_STATUS_OK;
+    plan_log_writer_close(writer);
+    mutation_plan_destroy(&plan);
+    normalized_plan_free(&normalized);
+    if (!ok) fprintf(stderr, "plan log setup failed\n");
+
+    ok = ok && check_min(log, input_path, "", kSignalTarget, "signal");
+    ok = ok && check_min(log, input_path, "--crash-exit 3", kExitTarget, "exit code");
+    ok = ok && setenv("ASAN_OPTIONS", "detect_leaks=0", 1) == 0 &&
+         check_min(log, input_path, "", kAsanTarget, "ASAN_OPTIONS");
+
+    unlink(log);
+    unlink(input_path);
+    if (!ok) return 1;
+
+    printf("growing plan min test: PASS\n");
+    return 0;
+}
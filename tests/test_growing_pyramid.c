@@ -0,0 +1,89 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ca_engine.h"
+#include "table_rng.h"
+#include "growing_test_support.h"
+
+static const uint32_t kPyramidSeq[] = {
+    9, 30, 3, 17, 24, 6, 13, 28, 1, 20, 11, 26, 4, 15, 31, 8,
+    22, 0, 18, 27, 5, 12, 29, 2, 21, 14, 25, 7, 16, 23, 10, 19,
+};
+
+#define INPUT_LEN (256u * 1024u)
+
+// Drives two pyramid-mode engines over a large input and checks that they agree and
+// that mutations stay within the output bound.
+int main(void) {
+    const size_t seq_len = sizeof(kPyramidSeq) / sizeof(*kPyramidSeq);
+    table_rng_state_t rng1 = {0};
+    table_rng_state_t rng2 = {0};
+    table_rng_init(&rng1, kPyramidSeq, seq_len);
+    table_rng_init(&rng2, kPyramidSeq, seq_len);
+
+    ca_rng_t rnd1 = {.below = table_rng_below, .context = &rng1};
+    ca_rng_t rnd2 = {.below = table_rng_below, .context = &rng2};
+    const ca_engine_config_t pyramid = {.user_context = NULL,
+                                        .flags = CA_ENGINE_FLAG_PYRAMID};
+
+    ca_engine_t *engine1 = NULL;
+    ca_engine_t *engine2 = NULL;
+    if (ca_engine_create_growing(&pyramid, rnd1, &engine1) != CA_STATUS_OK) return 1;
+    if (ca_engine_create_growing(&pyramid, rnd2, &engine2) != CA_STATUS_OK) {
+        ca_engine_destroy(engine1);
+        return 1;
+    }
+
+    uint8_t *input = (uint8_t *)malloc(INPUT_LEN);
+    if (!input) {
+        ca_engine_destroy(engine1);
+        ca_engine_destroy(engine2);
+        return 1;
+    }
+    for (size_t i = 0; i < INPUT_LEN; ++i) {
+        input[i] = (uint8_t)(0x20u + ((i * 7u) ^ (i >> 9)) % 0x5Fu);
+    }
+
+    bool ok = true;
+    size_t mutated = 0;
+    for (size_t call = 0; call < 16 && ok; ++call) {
+        grow_result_t r1 = {0};
+        grow_result_t r2 = {0};
+        if (!grow_mutate_to_owned_buffer(engine1, input, INPUT_LEN, INPUT_LEN * 2u,
+                                        (uint64_t)call, &r1) ||
+            !grow_mutate_to_owned_buffer(engine2, input, INPUT_LEN, INPUT_LEN * 2u,
+                                        (uint64_t)call, &r2)) {
+            fprintf(stderr, "invoke failed at call=%zu\n", call);
+            ok = false;
+        } else if (r1.status != r2.status || r1.is_skip != r2.is_skip ||
+                   r1.len != r2.len ||
+                   (!r1.is_skip && memcmp(r1.data, r2.data, r1.len) != 0)) {
+            fprintf(stderr, "pyramid mismatch at call=%zu\n", call);
+            ok = false;
+        } else if (!r1.is_skip) {
+            if (r1.len > INPUT_LEN * 2u) {
+                fprintf(stderr, "pyramid output too large at call=%zu\n", call);
+                ok = false;
+            }
+            ++mutated;
+        }
+
+        grow_result_free(&r1);
+        grow_result_free(&r2);
+    }
+
+    if (ok && mutated == 0) {
+        fprintf(stderr, "pyramid mode produced no mutations\n");
+        ok = false;
+    }
+
+    free(input);
+    ca_engine_destroy(engine1);
+    ca_engine_destroy(engine2);
+    if (!ok) return 1;
+
+    printf("growing pyramid test: PASS\n");
+    return 0;
+}
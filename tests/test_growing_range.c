@@ -0,0 +1,197 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mutation_plan.h"
+#include "growing_test_support.h"
+
+#define INPUT_LEN 5000u
+
+// Checks that segments and, for length-preserving plans, patch agree with apply.
+static bool paths_agree(const normalized_plan_t *plan, const uint8_t *input,
+                        const uint8_t *expected, size_t expected_len) {
+    mutation_segments_t segments = {0};
+    bool changed = false;
+    bool ok = mutation_plan_segments(plan, input, INPUT_LEN, &segments, &changed) ==
+                  CA_STATUS_OK &&
+              segments.total_len == expected_len && changed;
+    for (size_t i = 0, offset = 0; ok && i < segments.count; ++i) {
+        ok = memcmp(segments.segments[i].data, expected + offset,
+                    segments.segments[i].len) == 0;
+        offset += segments.segments[i].len;
+    }
+    mutation_segments_free(&segments);
+    if (ok && expected_len == INPUT_LEN) {
+        uint8_t *patched = (uint8_t *)malloc(INPUT_LEN);
+        ok = patched != NULL;
+        if (ok) memcpy(patched, input, INPUT_LEN);
+        ok = ok && mutation_plan_patch(plan, patched, INPUT_LEN, &changed) ==
+                       CA_STATUS_OK &&
+             changed && memcmp(patched, expected, INPUT_LEN) == 0;
+        free(patched);
+    }
+    return ok;
+}
+
+// A 4 KiB XOR with an odd-length key, a fill and a chunk duplicated by reference:
+// three ops, and only the key lands in the payload arena.
+static bool check_block_ops(const uint8_t *input) {
+    static const uint8_t key[] = {0x5Au, 0x00u, 0xC3u};
+    ca_plan_limits_t limits = {.max_output_len = INPUT_LEN * 2u, .input_len = INPUT_LEN,
+                               .input = input};
+    mutation_plan_t plan;
+    normalized_plan_t normalized = {0};
+    bool ok = mutation_plan_init(&plan) == CA_STATUS_OK &&
+              mutation_plan_add_xor_range(&plan, 7, 4096, key, sizeof(key), 3, 0) ==
+                  CA_STATUS_OK &&
+              mutation_plan_add_fill_range(&plan, 4200, 300, 0x00u, 2, 0) ==
+                  CA_STATUS_OK &&
+              mutation_plan_add_copy_range(&plan, 4800, 100, 64, 1, 0) == CA_STATUS_OK &&
+              mutation_plan_normalize(&plan, &limits, &normalized) == CA_STATUS_OK &&
+              normalized.op_count == 3 && normalized.extra_bytes_len == sizeof(key);
+
+    uint8_t *expected = (uint8_t *)malloc(INPUT_LEN + 64u);
+    ok = ok && expected;
+    if (ok) {
+        memcpy(expected, input, 4800u);
+        for (size_t i = 0; i < 4096u; ++i) expected[7 + i] ^= key[i % sizeof(key)];
+        memset(expected + 4200u, 0x00, 300u);
+        memcpy(expected + 4800u, input + 100u, 64u);
+        memcpy(expected + 4864u, input + 4800u, INPUT_LEN - 4800u);
+    }
+    size_t out_len = 0;
+    uint8_t *out = ok ? grow_apply_owned(&normalized, input, INPUT_LEN, &out_len) : NULL;
+    ok = ok && out && out_len == INPUT_LEN + 64u && memcmp(out, expected, out_len) == 0 &&
+         paths_agree(&normalized, input, expected, out_len);
+    if (!ok) fprintf(stderr, "block ops mismatch\n");
+
+    // Dropping the copy leaves a length-preserving plan that patch handles.
+    if (ok) {
+        normalized.op_count = 2;
+        memcpy(expected, input, INPUT_LEN);
+        for (size_t i = 0; i < 4096u; ++i) expected[7 + i] ^= key[i % sizeof(key)];
+        memset(expected + 4200u, 0x00, 300u);
+        ok = paths_agree(&normalized, input, expected, INPUT_LEN);
+        if (!ok) fprintf(stderr, "length-preserving range plan mismatch\n");
+    }
+    free(out);
+    free(expected);
+    normalized_plan_free(&normalized);
+    mutation_plan_destroy(&plan);
+    return ok;
+}
+
+// Moving a chunk is a copy plus a delete of the source.
+static bool check_move(const uint8_t *input) {
+    ca_plan_limits_t limits = {.max_output_len = INPUT_LEN, .input_len = INPUT_LEN,
+                               .input = input};
+    mutation_plan_t plan;
+    normalized_plan_t normalized = {0};
+    bool ok = mutation_plan_init(&plan) == CA_STATUS_OK &&
+              mutation_plan_add_copy_range(&plan, 3000, 200, 500, 1, 0) == CA_STATUS_OK &&
+              mutation_plan_add_delete_range(&plan, 200, 500, 1, 0) == CA_STATUS_OK &&
+              mutation_plan_normalize(&plan, &limits, &normalized) == CA_STATUS_OK &&
+              normalized.op_count == 2;
+    size_t out_len = 0;
+    uint8_t *out = ok ? grow_apply_owned(&normalized, input, INPUT_LEN, &out_len) : NULL;
+    ok = ok && out && out_len == INPUT_LEN && memcmp(out, input, 200u) == 0 &&
+         memcmp(out + 200u, input + 700u, 2300u) == 0 &&
+         memcmp(out + 2500u, input + 200u, 500u) == 0 &&
+         memcmp(out + 3000u, input + 3000u, INPUT_LEN - 3000u) == 0;
+    if (!ok) fprintf(stderr, "move mismatch\n");
+    free(out);
+    normalized_plan_free(&normalized);
+    mutation_plan_destroy(&plan);
+    return ok;
+}
+
+// A range owns its bytes: lower-ranked point ops, deletes, ranges and inserts inside
+// it are dropped, while an insert at its start and ops past its end stay.
+static bool check_conflicts(const uint8_t *input) {
+    static const uint8_t payload[] = "ins";
+    ca_plan_limits_t limits = {.max_output_len = INPUT_LEN * 2u, .input_len = INPUT_LEN,
+                               .input = input};
+    mutation_plan_t plan;
+    normalized_plan_t normalized = {0};
+    bool ok = mutation_plan_init(&plan) == CA_STATUS_OK &&
+              mutation_plan_add_fill_range(&plan, 100, 50, 0xAAu, 9, 0) == CA_STATUS_OK &&
+              mutation_plan_add_set_byte(&plan, 120, 0x01u, 5, 0) == CA_STATUS_OK &&
+              mutation_plan_add_delete_range(&plan, 90, 20, 5, 0) == CA_STATUS_OK &&
+              mutation_plan_add_fill_range(&plan, 149, 10, 0xBBu, 5, 0) == CA_STATUS_OK &&
+              mutation_plan_add_insert_bytes(&plan, 130, payload, 3, 5, 0) ==
+                  CA_STATUS_OK &&
+              mutation_plan_add_copy_range(&plan, 140, 0, 8, 5, 0) == CA_STATUS_OK &&
+              mutation_plan_add_insert_bytes(&plan, 100, payload, 3, 4, 0) ==
+                  CA_STATUS_OK &&
+              mutation_plan_add_set_byte(&plan, 150, 0x02u, 4, 0) == CA_STATUS_OK &&
+              mutation_plan_normalize(&plan, &limits, &normalized) == CA_STATUS_OK &&
+              normalized.op_count == 3 && normalized.ops[0].kind == CA_OP_FILL_RANGE &&
+              normalized.ops[1].kind == CA_OP_INSERT_BYTES &&
+              normalized.ops[2].kind == CA_OP_SET_BYTE && normalized.ops[2].pos == 150;
+    if (!ok) fprintf(stderr, "range conflicts not resolved\n");
+    normalized_plan_free(&normalized);
+    mutation_plan_destroy(&plan);
+    return ok;
+}
+
+// Range ops compose: `b` XORs bytes `a` filled and copies bytes `a` inserted.
+static bool check_compose(const uint8_t *input) {
+    static const uint8_t key[] = {0x0Fu, 0xF0u};
+    static const uint8_t payload[] = "payload";
+    ca_plan_limits_t limits = {.max_output_len = INPUT_LEN * 2u, .input_len = INPUT_LEN,
+                               .input = input};
+    mutation_plan_t plan_a;
+    mutation_plan_t plan_b;
+    normalized_plan_t a = {0};
+    normalized_plan_t b = {0};
+    normalized_plan_t fused = {0};
+    bool ok = mutation_plan_init(&plan_a) == CA_STATUS_OK &&
+              mutation_plan_init(&plan_b) == CA_STATUS_OK &&
+              mutation_plan_add_fill_range(&plan_a, 10, 40, 0x11u, 1, 0) ==
+                  CA_STATUS_OK &&
+              mutation_plan_add_insert_bytes(&plan_a, 60, payload, 7, 1, 0) ==
+                  CA_STATUS_OK &&
+              mutation_plan_normalize(&plan_a, &limits, &a) == CA_STATUS_OK;
+    size_t a_len = 0;
+    uint8_t *a_out = ok ? grow_apply_owned(&a, input, INPUT_LEN, &a_len) : NULL;
+    ca_plan_limits_t b_limits = {.max_output_len = INPUT_LEN * 2u, .input_len = a_len,
+                                 .input = a_out};
+    ok = ok && a_out &&
+         mutation_plan_add_xor_range(&plan_b, 0, 30, key, sizeof(key), 1, 0) ==
+             CA_STATUS_OK &&
+         mutation_plan_add_copy_range(&plan_b, 1000, 58, 12, 1, 0) == CA_STATUS_OK &&
+         mutation_plan_normalize(&plan_b, &b_limits, &b) == CA_STATUS_OK;
+    size_t b_len = 0;
+    uint8_t *b_out = ok ? grow_apply_owned(&b, a_out, a_len, &b_len) : NULL;
+    ok = ok && b_out &&
+         mutation_plan_compose(&a, &b, NULL, INPUT_LEN, &fused) ==
+             CA_STATUS_INVALID_ARGUMENT &&
+         mutation_plan_compose(&a, &b, input, INPUT_LEN, &fused) == CA_STATUS_OK;
+    size_t fused_len = 0;
+    uint8_t *fused_out = ok ? grow_apply_owned(&fused, input, INPUT_LEN, &fused_len) : NULL;
+    ok = ok && fused_out && fused_len == b_len && memcmp(fused_out, b_out, b_len) == 0;
+    if (!ok) fprintf(stderr, "range composition mismatch\n");
+
+    free(a_out);
+    free(b_out);
+    free(fused_out);
+    normalized_plan_free(&a);
+    normalized_plan_free(&b);
+    normalized_plan_free(&fused);
+    mutation_plan_destroy(&plan_a);
+    mutation_plan_destroy(&plan_b);
+    return ok;
+}
+
+int main(void) {
+    static uint8_t input[INPUT_LEN];
+    for (size_t i = 0; i < INPUT_LEN; ++i) input[i] = (uint8_t)(i * 31u + (i >> 5));
+
+    bool ok = check_block_ops(input) && check_move(input) && check_conflicts(input) &&
+              check_compose(input);
+    if (!ok) return 1;
+
+    printf("growing range ops test: PASS\n");
+    return 0;
+}
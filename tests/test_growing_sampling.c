@@ -0,0 +1,127 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ca_engine.h"
+#include "growing_engine.h"
+#include "table_rng.h"
+#include "growing_test_support.h"
+
+static const uint32_t kSamplingSeq[] = {
+    25, 8, 17, 30, 3, 12, 21, 6, 27, 14, 1, 19, 10, 28, 5, 23,
+    16, 0, 31, 9, 24, 13, 4, 29, 18, 7, 22, 11, 2, 26, 15, 20,
+};
+
+#define INPUT_LEN 8192u
+#define HOT_START 5000u
+#define HOT_LEN 64u
+
+static ca_engine_t *create_engine(table_rng_state_t *state, uint32_t mode) {
+    table_rng_init(state, kSamplingSeq, sizeof(kSamplingSeq) / sizeof(*kSamplingSeq));
+    ca_rng_t rnd = {.below = table_rng_below, .context = state};
+    ca_growing_params_t params;
+    ca_growing_params_init(&params);
+    params.position_mode = mode;
+    const ca_engine_config_t config = {.user_context = NULL, .growing_params = &params};
+
+    ca_engine_t *engine = NULL;
+    if (ca_engine_create_growing(&config, rnd, &engine) != CA_STATUS_OK) return NULL;
+    return engine;
+}
+
+int main(void) {
+    uint8_t *input = (uint8_t *)malloc(INPUT_LEN);
+    uint32_t *weights = (uint32_t *)calloc(INPUT_LEN, sizeof(*weights));
+    if (!input || !weights) {
+        free(input);
+        free(weights);
+        return 1;
+    }
+    for (size_t i = 0; i < INPUT_LEN; ++i) {
+        input[i] = (uint8_t)(0x20u + (i * 19u) % 0x5Fu);
+    }
+    for (size_t i = HOT_START; i < HOT_START + HOT_LEN; ++i) {
+        weights[i] = 1u;
+    }
+
+    bool ok = true;
+
+    // Feature-weighted modes must stay deterministic.
+    static const uint32_t modes[] = {CA_GROW_POSITION_ACTIVITY, CA_GROW_POSITION_ENTROPY,
+                                     CA_GROW_POSITION_PRINTABLE};
+    for (size_t m = 0; m < sizeof(modes) / sizeof(*modes) && ok; ++m) {
+        table_rng_state_t rng1 = {0};
+        table_rng_state_t rng2 = {0};
+        ca_engine_t *engine1 = create_engine(&rng1, modes[m]);
+        ca_engine_t *engine2 = create_engine(&rng2, modes[m]);
+        size_t mutated = 0;
+        for (size_t call = 0; call < 16 && ok && engine1 && engine2; ++call) {
+            grow_result_t r1 = {0};
+            grow_result_t r2 = {0};
+            if (!grow_mutate_to_owned_buffer(engine1, input, INPUT_LEN, INPUT_LEN * 2u,
+                                            call, &r1) ||
+                !grow_mutate_to_owned_buffer(engine2, input, INPUT_LEN, INPUT_LEN * 2u,
+                                            call, &r2) ||
+                r1.is_skip != r2.is_skip || r1.len != r2.len ||
+                (!r1.is_skip && memcmp(r1.data, r2.data, r1.len) != 0)) {
+                fprintf(stderr, "mode %u diverged at call=%zu\n", modes[m], call);
+                ok = false;
+            }
+            mutated += r1.is_skip ? 0u : 1u;
+            grow_result_free(&r1);
+            grow_result_free(&r2);
+        }
+        if (!engine1 || !engine2 || (ok && mutated == 0)) {
+            fprintf(stderr, "mode %u produced no mutations\n", modes[m]);
+            ok = false;
+        }
+        ca_engine_destroy(engine1);
+        ca_engine_destroy(engine2);
+    }
+
+    // External weights confine every op to the weighted range (deletes may run up
+    // to 8 bytes past a weighted cell).
+    table_rng_state_t rng = {0};
+    ca_engine_t *engine = create_engine(&rng, CA_GROW_POSITION_EXTERNAL);
+    if (!engine ||
+        ca_growing_set_position_weights(engine, weights, INPUT_LEN) != CA_STATUS_OK) {
+        ok = false;
+    }
+    size_t mutated = 0;
+    for (size_t call = 0; call < 32 && ok; ++call) {
+        grow_result_t r = {0};
+        if (!grow_mutate_to_owned_buffer(engine, input, INPUT_LEN, INPUT_LEN * 2u, call,
+                                        &r)) {
+            ok = false;
+        } else if (!r.is_skip) {
+            size_t prefix = 0;
+            while (prefix < r.len && prefix < INPUT_LEN && r.data[prefix] == input[prefix]) {
+                ++prefix;
+            }
+            size_t suffix = 0;
+            while (suffix < r.len && suffix < INPUT_LEN &&
+                   r.data[r.len - 1u - suffix] == input[INPUT_LEN - 1u - suffix]) {
+                ++suffix;
+            }
+            if (prefix < HOT_START - 16u || INPUT_LEN - suffix > HOT_START + HOT_LEN + 24u) {
+                fprintf(stderr, "op outside weighted range at call=%zu\n", call);
+                ok = false;
+            }
+            ++mutated;
+        }
+        grow_result_free(&r);
+    }
+    if (ok && mutated == 0) {
+        fprintf(stderr, "external weights produced no mutations\n");
+        ok = false;
+    }
+    ca_engine_destroy(engine);
+
+    free(input);
+    free(weights);
+    if (!ok) return 1;
+
+    printf("growing sampling test: PASS\n");
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "ca_engine.h"
+#include "table_rng.h"
+#include "growing_test_support.h"
+
+static const uint32_t kSessionSeq[] = {
+    18, 4, 29, 11, 23, 0, 15, 27, 8, 20, 2, 31, 13, 25, 6, 17,
+    10, 28, 1, 22, 14, 5, 30, 9, 19, 26, 3, 24, 12, 7, 21, 16,
+};
+
+int main(void) {
+    const size_t seq_len = sizeof(kSessionSeq) / sizeof(*kSessionSeq);
+    table_rng_state_t rng1 = {0};
+    table_rng_state_t rng2 = {0};
+    table_rng_init(&rng1, kSessionSeq, seq_len);
+    table_rng_init(&rng2, kSessionSeq, seq_len);
+    ca_rng_t rnd1 = {.below = table_rng_below, .context = &rng1};
+    ca_rng_t rnd2 = {.below = table_rng_below, .context = &rng2};
+    const ca_engine_config_t config = {.user_context = NULL};
+
+    ca_engine_t *session = NULL;
+    ca_engine_t *single = NULL;
+    if (ca_engine_create_growing(&config, rnd1, &session) != CA_STATUS_OK) return 1;
+    if (ca_engine_create_growing(&config, rnd2, &single) != CA_STATUS_OK) {
+        ca_engine_destroy(session);
+        return 1;
+    }
+
+    static uint8_t input[1024];
+    for (size_t i = 0; i < sizeof(input); ++i) {
+        input[i] = (uint8_t)(0x20u + (i * 37u) % 0x5Fu);
+    }
+
+    bool ok = true;
+    ca_output_t output = {0};
+    if (ca_engine_next(session, &output) != CA_STATUS_INVALID_ARGUMENT) {
+        fprintf(stderr, "next without begin did not fail\n");
+        ok = false;
+    }
+
+    // The first plan of a session must match a plain mutate call on the same RNG
+    // stream.
+    const ca_mutate_request_t request = {
+        .input = input,
+        .input_len = sizeof(input),
+        .max_output_len = 4096,
+        .mutation_id = 0,
+    };
+    grow_result_t first = {0};
+    grow_result_t reference = {0};
+    if (ok && (ca_engine_begin(session, &request) != CA_STATUS_OK ||
+               !grow_next_to_owned_buffer(session, input, sizeof(input), 4096, &first) ||
+               !grow_mutate_to_owned_buffer(single, input, sizeof(input), 4096, 0,
+                                            &reference) ||
+               !grow_result_equal(&first, &reference))) {
+        fprintf(stderr, "first session plan differs from mutate\n");
+        ok = false;
+    }
+    grow_result_free(&reference);
+
+    // Later plans are decoded from the same evolved state and should vary.
+    size_t distinct = 0;
+    for (size_t call = 1; call < 16 && ok; ++call) {
+        grow_result_t next = {0};
+        if (!grow_next_to_owned_buffer(session, input, sizeof(input), 4096, &next)) {
+            fprintf(stderr, "next failed at call=%zu\n", call);
+            ok = false;
+        } else if (!next.is_skip && !grow_result_equal(&next, &first)) {
+            ++distinct;
+        }
+        grow_result_free(&next);
+    }
+    grow_result_free(&first);
+
+    if (ok && distinct == 0) {
+        fprintf(stderr, "session produced no distinct plans\n");
+        ok = false;
+    }
+
+    ca_engine_destroy(session);
+    ca_engine_destroy(single);
+    if (!ok) return 1;
+
+    printf("growing session test: PASS\n");
+    return 0;
+}
@@ -0,0 +1,235 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ca_engine.h"
+#include "mutation_plan.h"
+#include "table_rng.h"
+#include "growing_test_support.h"
+
+static const uint32_t kSpliceSeq[] = {
+    7, 22, 3, 30, 14, 9, 26, 1, 18, 11, 29, 5, 24, 16, 0, 21,
+    12, 27, 8, 2, 31, 19, 6, 25, 15, 10, 28, 4, 23, 13, 20, 17,
+};
+
+#define INPUT_LEN 128u
+#define ADD_LEN 96u
+#define ENGINE_INPUT_LEN 4096u
+
+// An insert and an overwrite from the partner land where expected, and the
+// overwrite's segment points straight into `add_buf`.
+static bool check_apply(const uint8_t *input, const uint8_t *add) {
+    ca_plan_limits_t limits = {.max_output_len = INPUT_LEN * 2u, .input_len = INPUT_LEN,
+                               .input = input, .add_buf = add, .add_buf_len = ADD_LEN};
+    mutation_plan_t plan;
+    normalized_plan_t normalized = {0};
+    bool ok = mutation_plan_init(&plan) == CA_STATUS_OK &&
+              mutation_plan_add_insert_from_add(&plan, 16, 40, 8, 5, 0) == CA_STATUS_OK &&
+              mutation_plan_add_overwrite_from_add(&plan, 64, 10, 12, 5, 1) ==
+                  CA_STATUS_OK &&
+              mutation_plan_normalize(&plan, &limits, &normalized) == CA_STATUS_OK &&
+              normalized.op_count == 2 && normalized.extra_bytes_len == 0 &&
+              normalized.add_buf == add;
+
+    uint8_t expected[INPUT_LEN + 8u];
+    memcpy(expected, input, 16);
+    memcpy(expected + 16, add + 40, 8);
+    memcpy(expected + 24, input + 16, INPUT_LEN - 16u);
+    memcpy(expected + 72, add + 10, 12);
+
+    size_t out_len = 0;
+    uint8_t *out = ok ? grow_apply_owned(&normalized, input, INPUT_LEN, &out_len) : NULL;
+    ok = ok && out && out_len == sizeof(expected) &&
+         memcmp(out, expected, sizeof(expected)) == 0;
+
+    mutation_segments_t segments = {0};
+    bool changed = false;
+    bool borrowed = false;
+    ok = ok &&
+         mutation_plan_segments(&normalized, input, INPUT_LEN, &segments, &changed) ==
+             CA_STATUS_OK &&
+         changed && segments.total_len == sizeof(expected);
+    for (size_t i = 0, offset = 0; ok && i < segments.count; ++i) {
+        ok = memcmp(segments.segments[i].data, expected + offset,
+                    segments.segments[i].len) == 0;
+        borrowed = borrowed || segments.segments[i].data == add + 10;
+        offset += segments.segments[i].len;
+    }
+    ok = ok && borrowed;
+    if (!ok) fprintf(stderr, "splice apply mismatch\n");
+
+    free(out);
+    mutation_segments_free(&segments);
+    normalized_plan_free(&normalized);
+    mutation_plan_destroy(&plan);
+    return ok;
+}
+
+// Without a partner splices are dropped; spans past the partner's end and
+// overwrites with the bytes already there are dropped too; an overwrite patches in
+// place.
+static bool check_validation(uint8_t *input, const uint8_t *add) {
+    ca_plan_limits_t bare = {.max_output_len = INPUT_LEN * 2u, .input_len = INPUT_LEN,
+                             .input = input};
+    ca_plan_limits_t limits = bare;
+    limits.add_buf = add;
+    limits.add_buf_len = ADD_LEN;
+    memcpy(input + 100, add + 50, 4);
+
+    mutation_plan_t plan;
+    normalized_plan_t normalized = {0};
+    normalized_plan_t spliced = {0};
+    bool ok = mutation_plan_init(&plan) == CA_STATUS_OK &&
+              mutation_plan_add_insert_from_add(&plan, 0, 0, 0, 5, 0) ==
+                  CA_STATUS_INVALID_ARGUMENT &&
+              mutation_plan_add_overwrite_from_add(&plan, 8, 0, 4, 5, 0) == CA_STATUS_OK &&
+              mutation_plan_add_insert_from_add(&plan, 30, ADD_LEN - 2u, 4, 5, 1) ==
+                  CA_STATUS_OK &&
+              mutation_plan_add_overwrite_from_add(&plan, 100, 50, 4, 5, 2) ==
+                  CA_STATUS_OK &&
+              mutation_plan_normalize(&plan, &bare, &normalized) == CA_STATUS_OK &&
+              normalized.op_count == 0 &&
+              mutation_plan_normalize(&plan, &limits, &spliced) == CA_STATUS_OK &&
+              spliced.op_count == 1 && spliced.ops[0].pos == 8u;
+
+    uint8_t patched[INPUT_LEN];
+    memcpy(patched, input, INPUT_LEN);
+    bool changed = false;
+    ok = ok &&
+         mutation_plan_patch(&spliced, patched, INPUT_LEN, &changed) == CA_STATUS_OK &&
+         changed && memcmp(patched + 8, add, 4) == 0 &&
+         memcmp(patched + 12, input + 12, INPUT_LEN - 12u) == 0;
+    if (!ok) fprintf(stderr, "splice validation mismatch\n");
+
+    normalized_plan_free(&normalized);
+    normalized_plan_free(&spliced);
+    mutation_plan_destroy(&plan);
+    return ok;
+}
+
+// Composing a splice plan onto an empty one inlines the partner bytes, so the
+// result still applies after the partner is gone.
+static bool check_detach(const uint8_t *input, const uint8_t *add) {
+    uint8_t *partner = (uint8_t *)malloc(ADD_LEN);
+    if (!partner) return false;
+    memcpy(partner, add, ADD_LEN);
+    ca_plan_limits_t limits = {.max_output_len = INPUT_LEN * 2u, .input_len = INPUT_LEN,
+                               .input = input, .add_buf = partner,
+                               .add_buf_len = ADD_LEN};
+    mutation_plan_t plan;
+    normalized_plan_t normalized = {0};
+    normalized_plan_t empty = {0};
+    normalized_plan_t detached = {0};
+    bool ok = mutation_plan_init(&plan) == CA_STATUS_OK &&
+              mutation_plan_add_insert_from_add(&plan, 4, 60, 16, 5, 0) == CA_STATUS_OK &&
+              mutation_plan_add_overwrite_from_add(&plan, 90, 20, 9, 5, 1) ==
+                  CA_STATUS_OK &&
+              mutation_plan_normalize(&plan, &limits, &normalized) == CA_STATUS_OK &&
+              normalized.op_count == 2;
+    size_t want_len = 0;
+    uint8_t *want = ok ? grow_apply_owned(&normalized, input, INPUT_LEN, &want_len) : NULL;
+    ok = ok && want &&
+         mutation_plan_compose(&empty, &normalized, input, INPUT_LEN, &detached) ==
+             CA_STATUS_OK &&
+         detached.add_buf == NULL;
+    for (size_t i = 0; ok && i < detached.op_count; ++i) {
+        ok = detached.ops[i].kind != CA_OP_INSERT_FROM_ADD &&
+             detached.ops[i].kind != CA_OP_OVERWRITE_FROM_ADD;
+    }
+    memset(partner, 0, ADD_LEN);
+    size_t got_len = 0;
+    uint8_t *got = ok ? grow_apply_owned(&detached, input, INPUT_LEN, &got_len) : NULL;
+    ok = ok && got && got_len == want_len && memcmp(got, want, want_len) == 0;
+    if (!ok) fprintf(stderr, "splice detach mismatch\n");
+
+    free(want);
+    free(got);
+    free(partner);
+    normalized_plan_free(&normalized);
+    normalized_plan_free(&detached);
+    mutation_plan_destroy(&plan);
+    return ok;
+}
+
+// With only the splice kind weighted, the engine emits splices within both
+// buffers when given a partner, both kinds over the session, and none without one.
+static bool check_engine(bool length_preserving) {
+    static uint8_t input[ENGINE_INPUT_LEN];
+    static uint8_t add[ENGINE_INPUT_LEN / 2u];
+    table_rng_state_t rng = {0};
+    table_rng_init(&rng, kSpliceSeq, sizeof(kSpliceSeq) / sizeof(*kSpliceSeq));
+    ca_rng_t rnd = {.below = table_rng_below, .context = &rng};
+    ca_growing_params_t params;
+    ca_growing_params_init(&params);
+    params.kind_weights[7] = 1u;
+    const ca_engine_config_t config = {
+        .user_context = NULL,
+        .flags = length_preserving ? CA_ENGINE_FLAG_LENGTH_PRESERVING : 0u,
+        .growing_params = &params,
+    };
+    ca_engine_t *engine = NULL;
+    if (ca_engine_create_growing(&config, rnd, &engine) != CA_STATUS_OK) return false;
+
+    bool ok = true;
+    size_t seen[CA_OP_OVERWRITE_FROM_ADD + 1] = {0};
+    for (size_t call = 0; call < 32 && ok; ++call) {
+        for (size_t i = 0; i < ENGINE_INPUT_LEN; ++i) {
+            input[i] = (uint8_t)(i * 29u + (i >> 5) * (call + 1u));
+        }
+        for (size_t i = 0; i < sizeof(add); ++i) add[i] = (uint8_t)(i * 13u + call);
+        // Every fourth call has no partner.
+        const bool partner = (call & 3u) != 0;
+        ca_mutate_request_t request = {
+            .input = input,
+            .input_len = ENGINE_INPUT_LEN,
+            .add_buf = partner ? add : NULL,
+            .add_buf_len = partner ? sizeof(add) : 0,
+            .max_output_len = ENGINE_INPUT_LEN * 2u,
+            .mutation_id = (uint64_t)call,
+        };
+        ca_output_t output = {0};
+        if (ca_engine_mutate(engine, &request, &output) != CA_STATUS_OK) continue;
+        ca_plan_limits_t limits = {.max_output_len = ENGINE_INPUT_LEN * 2u,
+                                   .input_len = ENGINE_INPUT_LEN, .input = input,
+                                   .add_buf = request.add_buf,
+                                   .add_buf_len = request.add_buf_len};
+        normalized_plan_t normalized = {0};
+        ok = mutation_plan_normalize(output.value.plan, &limits, &normalized) ==
+             CA_STATUS_OK;
+        for (size_t i = 0; ok && i < normalized.op_count; ++i) {
+            const mutation_op_t *op = &normalized.ops[i];
+            const bool splice = op->kind == CA_OP_INSERT_FROM_ADD ||
+                                op->kind == CA_OP_OVERWRITE_FROM_ADD;
+            ok = splice ? partner && op->data_offset + op->len <= sizeof(add)
+                        : op->kind == CA_OP_BIT_FLIP;
+            if (ok) ++seen[op->kind];
+        }
+        normalized_plan_free(&normalized);
+    }
+    ca_engine_destroy(engine);
+
+    if (!ok) {
+        fprintf(stderr, "engine emitted an unexpected op\n");
+    } else if (seen[CA_OP_OVERWRITE_FROM_ADD] == 0 ||
+               (seen[CA_OP_INSERT_FROM_ADD] == 0) != length_preserving) {
+        fprintf(stderr, "engine splices missing: %zu inserts, %zu overwrites\n",
+                seen[CA_OP_INSERT_FROM_ADD], seen[CA_OP_OVERWRITE_FROM_ADD]);
+        ok = false;
+    }
+    return ok;
+}
+
+int main(void) {
+    static uint8_t input[INPUT_LEN];
+    static uint8_t add[ADD_LEN];
+    for (size_t i = 0; i < INPUT_LEN; ++i) input[i] = (uint8_t)(0x41u + (i * 7u) % 26u);
+    for (size_t i = 0; i < ADD_LEN; ++i) add[i] = (uint8_t)(0x80u + i);
+
+    bool ok = check_apply(input, add) && check_validation(input, add) &&
+              check_detach(input, add) && check_engine(false) && check_engine(true);
+    if (!ok) return 1;
+
+    printf("growing splice test: PASS\n");
+    return 0;
+}
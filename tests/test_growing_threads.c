@@ -0,0 +1,99 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ca_engine.h"
+#include "table_rng.h"
+#include "growing_test_support.h"
+
+static const uint32_t kThreadsSeq[] = {
+    3, 26, 12, 19, 30, 7, 22, 0, 15, 28, 9, 24, 5, 17, 31, 10,
+    21, 2, 27, 14, 6, 29, 11, 18, 1, 25, 8, 23, 16, 4, 20, 13,
+};
+
+#define INPUT_LEN (128u * 1024u)
+
+// Output in derived-RNG mode must not depend on the worker count.
+static bool run_session(uint32_t threads, uint32_t flags, const uint8_t *input,
+                        grow_result_t *results, size_t calls) {
+    table_rng_state_t rng = {0};
+    table_rng_init(&rng, kThreadsSeq, sizeof(kThreadsSeq) / sizeof(*kThreadsSeq));
+    ca_rng_t rnd = {.below = table_rng_below, .context = &rng};
+    const ca_engine_config_t config = {.user_context = NULL,
+                                       .flags = flags,
+                                       .worker_threads = threads};
+
+    ca_engine_t *engine = NULL;
+    if (ca_engine_create_growing(&config, rnd, &engine) != CA_STATUS_OK) return false;
+
+    bool ok = true;
+    for (size_t call = 0; call < calls && ok; ++call) {
+        ok = grow_mutate_to_owned_buffer(engine, input, INPUT_LEN, INPUT_LEN * 2u,
+                                         (uint64_t)call, &results[call]);
+    }
+
+    ca_engine_destroy(engine);
+    return ok;
+}
+
+int main(void) {
+    enum { kCalls = 8 };
+    static const uint32_t thread_counts[] = {2u, 3u, 8u};
+    static const uint32_t modes[] = {0u, CA_ENGINE_FLAG_PYRAMID};
+
+    uint8_t *input = (uint8_t *)malloc(INPUT_LEN);
+    if (!input) return 1;
+    for (size_t i = 0; i < INPUT_LEN; ++i) {
+        input[i] = (uint8_t)(0x20u + ((i * 11u) ^ (i >> 5)) % 0x5Fu);
+    }
+
+    bool ok = true;
+    for (size_t m = 0; m < sizeof(modes) / sizeof(*modes) && ok; ++m) {
+        grow_result_t reference[kCalls] = {{0}};
+        size_t mutated = 0;
+        if (!run_session(1u, modes[m], input, reference, kCalls)) {
+            fprintf(stderr, "single-thread session failed\n");
+            ok = false;
+        }
+        for (size_t call = 0; call < kCalls; ++call) {
+            mutated += reference[call].is_skip ? 0u : 1u;
+        }
+        if (ok && mutated == 0) {
+            fprintf(stderr, "derived-RNG mode produced no mutations\n");
+            ok = false;
+        }
+
+        for (size_t t = 0; t < sizeof(thread_counts) / sizeof(*thread_counts) && ok; ++t) {
+            grow_result_t results[kCalls] = {{0}};
+            if (!run_session(thread_counts[t], modes[m], input, results, kCalls)) {
+                fprintf(stderr, "session with %u threads failed\n", thread_counts[t]);
+                ok = false;
+            }
+            for (size_t call = 0; call < kCalls && ok; ++call) {
+                const grow_result_t *a = &reference[call];
+                const grow_result_t *b = &results[call];
+                if (a->status != b->status || a->is_skip != b->is_skip ||
+                    a->len != b->len ||
+                    (!a->is_skip && memcmp(a->data, b->data, a->len) != 0)) {
+                    fprintf(stderr, "threads=%u mode=%u diverged at call=%zu\n",
+                            thread_counts[t], modes[m], call);
+                    ok = false;
+                }
+            }
+            for (size_t call = 0; call < kCalls; ++call) {
+                grow_result_free(&results[call]);
+            }
+        }
+
+        for (size_t call = 0; call < kCalls; ++call) {
+            grow_result_free(&reference[call]);
+        }
+    }
+
+    free(input);
+    if (!ok) return 1;
+
+    printf("growing threads test: PASS\n");
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ca_engine.h"
+#include "growing_engine.h"
+#include "table_rng.h"
+
+static const uint32_t kTrimSeq[] = {
+    19, 4, 27, 11, 0, 30, 8, 15, 23, 2, 29, 13, 6, 21, 17, 9,
+    31, 1, 25, 14, 5, 28, 10, 18, 3, 22, 12, 26, 7, 20, 16, 24,
+};
+
+#define SMALL_LEN 1000u
+// Needs 6144 cells at the default 16-byte blocks, so the blocks widen to 32 bytes.
+#define LARGE_LEN (16u * 6144u)
+
+static ca_engine_t *make_engine(table_rng_state_t *rng) {
+    table_rng_init(rng, kTrimSeq, sizeof(kTrimSeq) / sizeof(*kTrimSeq));
+    ca_rng_t rnd = {.below = table_rng_below, .context = rng};
+    const ca_engine_config_t config = {.user_context = NULL};
+    ca_engine_t *engine = NULL;
+    if (ca_engine_create_growing(&config, rnd, &engine) != CA_STATUS_OK) return NULL;
+    return engine;
+}
+
+// Cell counts and block sizes follow the input, widening past
+// CA_GROWING_TRIM_MAX_CELLS, and equal RNG sequences give equal activity.
+static bool check_shape(const uint8_t *input) {
+    table_rng_state_t rng_a = {0};
+    table_rng_state_t rng_b = {0};
+    ca_engine_t *a = make_engine(&rng_a);
+    ca_engine_t *b = make_engine(&rng_b);
+    const uint8_t *activity_a = NULL;
+    const uint8_t *activity_b = NULL;
+    size_t count_a = 0;
+    size_t count_b = 0;
+    size_t block_a = 0;
+    size_t block_b = 0;
+    bool ok = a && b &&
+              ca_growing_cell_activity(a, input, SMALL_LEN, &activity_a, &count_a,
+                                       &block_a) == CA_STATUS_OK &&
+              ca_growing_cell_activity(b, input, SMALL_LEN, &activity_b, &count_b,
+                                       &block_b) == CA_STATUS_OK &&
+              block_a == 16u && count_a == (SMALL_LEN + 15u) / 16u && count_b == count_a &&
+              memcmp(activity_a, activity_b, count_a) == 0;
+
+    ok = ok &&
+         ca_growing_cell_activity(a, input, LARGE_LEN, &activity_a, &count_a, &block_a) ==
+             CA_STATUS_OK &&
+         block_a == 32u && count_a == LARGE_LEN / 32u &&
+         count_a <= CA_GROWING_TRIM_MAX_CELLS;
+    ok = ok &&
+         ca_growing_cell_activity(a, NULL, 0, &activity_a, &count_a, &block_a) ==
+             CA_STATUS_OK &&
+         count_a == 0 && activity_a == NULL;
+    if (!ok) fprintf(stderr, "trim activity shape mismatch\n");
+
+    ca_engine_destroy(a);
+    ca_engine_destroy(b);
+    return ok;
+}
+
+// The grid is rebuilt for the trimmed input, so an open plan session ends and the
+// next mutation starts a fresh one.
+static bool check_session(const uint8_t *input) {
+    table_rng_state_t rng = {0};
+    ca_engine_t *engine = make_engine(&rng);
+    ca_mutate_request_t request = {
+        .input = input,
+        .input_len = SMALL_LEN,
+        .max_output_len = SMALL_LEN * 2u,
+    };
+    const uint8_t *activity = NULL;
+    size_t count = 0;
+    size_t block = 0;
+    ca_output_t output = {0};
+    bool ok = engine && ca_engine_begin(engine, &request) == CA_STATUS_OK &&
+              ca_growing_cell_activity(engine, input, SMALL_LEN, &activity, &count,
+                                       &block) == CA_STATUS_OK &&
+              ca_engine_next(engine, &output) == CA_STATUS_INVALID_ARGUMENT;
+    ca_status_t status = CA_STATUS_SKIP;
+    for (uint64_t id = 0; ok && status == CA_STATUS_SKIP && id < 16u; ++id) {
+        request.mutation_id = id;
+        status = ca_engine_mutate(engine, &request, &output);
+    }
+    ok = ok && status == CA_STATUS_OK && output.kind == CA_OUTPUT_PLAN;
+    if (!ok) fprintf(stderr, "trim activity left the session open\n");
+
+    ca_engine_destroy(engine);
+    return ok;
+}
+
+int main(void) {
+    uint8_t *input = (uint8_t *)malloc(LARGE_LEN);
+    if (!input) return 1;
+    for (size_t i = 0; i < LARGE_LEN; ++i) input[i] = (uint8_t)(i * 13u + (i >> 6));
+
+    bool ok = check_shape(input) && check_session(input);
+    free(input);
+    if (!ok) return 1;
+
+    printf("growing trim test: PASS\n");
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ca_engine.h"
+#include "table_rng.h"
+#include "growing_test_support.h"
+
+static const uint32_t kWindowSeq[] = {
+    14, 2, 27, 9, 20, 31, 5, 17, 11, 24, 0, 29, 7, 19, 3, 22,
+    12, 26, 8, 30, 1, 16, 23, 6, 28, 13, 4, 21, 10, 25, 18, 15,
+};
+
+#define INPUT_LEN (1024u * 1024u)
+#define WINDOW_CELLS 32u
+
+// Length of the input range that differs from `out`, after trimming the common
+// prefix and suffix.
+static size_t changed_span(const uint8_t *in, size_t in_len, const uint8_t *out,
+                           size_t out_len) {
+    size_t shorter = in_len < out_len ? in_len : out_len;
+    size_t prefix = 0;
+    while (prefix < shorter && in[prefix] == out[prefix]) ++prefix;
+    size_t suffix = 0;
+    while (suffix < shorter - prefix &&
+           in[in_len - 1u - suffix] == out[out_len - 1u - suffix]) {
+        ++suffix;
+    }
+    return in_len - prefix - suffix;
+}
+
+// Window mode on a 1 MiB input: two engines must agree and every mutation must
+// stay inside one window's worth of bytes.
+int main(void) {
+    const size_t seq_len = sizeof(kWindowSeq) / sizeof(*kWindowSeq);
+    table_rng_state_t rng1 = {0};
+    table_rng_state_t rng2 = {0};
+    table_rng_init(&rng1, kWindowSeq, seq_len);
+    table_rng_init(&rng2, kWindowSeq, seq_len);
+
+    ca_rng_t rnd1 = {.below = table_rng_below, .context = &rng1};
+    ca_rng_t rnd2 = {.below = table_rng_below, .context = &rng2};
+    const ca_engine_config_t windowed = {.user_context = NULL,
+                                         .window_min_input = 64u * 1024u,
+                                         .window_cells = WINDOW_CELLS};
+
+    ca_engine_t *engine1 = NULL;
+    ca_engine_t *engine2 = NULL;
+    if (ca_engine_create_growing(&windowed, rnd1, &engine1) != CA_STATUS_OK) return 1;
+    if (ca_engine_create_growing(&windowed, rnd2, &engine2) != CA_STATUS_OK) {
+        ca_engine_destroy(engine1);
+        return 1;
+    }
+
+    uint8_t *input = (uint8_t *)malloc(INPUT_LEN);
+    if (!input) {
+        ca_engine_destroy(engine1);
+        ca_engine_destroy(engine2);
+        return 1;
+    }
+    for (size_t i = 0; i < INPUT_LEN; ++i) {
+        input[i] = (uint8_t)(0x20u + ((i * 13u) ^ (i >> 7)) % 0x5Fu);
+    }
+
+    bool ok = true;
+    size_t mutated = 0;
+    for (size_t call = 0; call < 16 && ok; ++call) {
+        grow_result_t r1 = {0};
+        grow_result_t r2 = {0};
+        if (!grow_mutate_to_owned_buffer(engine1, input, INPUT_LEN, INPUT_LEN * 2u,
+                                        (uint64_t)call, &r1) ||
+            !grow_mutate_to_owned_buffer(engine2, input, INPUT_LEN, INPUT_LEN * 2u,
+                                        (uint64_t)call, &r2)) {
+            fprintf(stderr, "invoke failed at call=%zu\n", call);
+            ok = false;
+        } else if (r1.status != r2.status || r1.is_skip != r2.is_skip ||
+                   r1.len != r2.len ||
+                   (!r1.is_skip && memcmp(r1.data, r2.data, r1.len) != 0)) {
+            fprintf(stderr, "window mismatch at call=%zu\n", call);
+            ok = false;
+        } else if (!r1.is_skip) {
+            size_t span = changed_span(input, INPUT_LEN, r1.data, r1.len);
+            // A delete in the last window block may reach up to 8 bytes past it.
+            if (span > WINDOW_CELLS * 16u + 8u) {
+                fprintf(stderr, "window mutation spans %zu bytes at call=%zu\n", span,
+                        call);
+                ok = false;
+            }
+            ++mutated;
+        }
+
+        grow_result_free(&r1);
+        grow_result_free(&r2);
+    }
+
+    if (ok && mutated == 0) {
+        fprintf(stderr, "window mode produced no mutations\n");
+        ok = false;
+    }
+
+    free(input);
+    ca_engine_destroy(engine1);
+    ca_engine_destroy(engine2);
+    if (!ok) return 1;
+
+    printf("growing window test: PASS\n");
+    return 0;
+}
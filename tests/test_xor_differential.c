@@ -14,7 +14,7 @@ static const uint32_t kRngSequence[] = {
 
 static bool check_case(const uint8_t *input, size_t input_len,
                       size_t max_output_len, size_t calls, const uint32_t *seed,
-                      size_t seed_len) {
+                      size_t seed_len, bool into) {
     table_rng_state_t ref_rng;
     table_rng_state_t eng_rng;
     table_rng_init(&ref_rng, seed, seed_len);
@@ -78,7 +78,16 @@ static bool check_case(const uint8_t *input, size_t input_len,
         };
 
         ca_output_t output = {0};
-        ca_status_t eng_status = ca_engine_mutate(engine, &request, &output);
+        ca_status_t eng_status;
+        if (into) {
+            eng_status = ca_engine_mutate_into(engine, &request, mut_out, max_in,
+                                               &mut_out_len);
+            output.kind = CA_OUTPUT_BUFFER;
+            output.value.buffer.data = mut_out;
+            output.value.buffer.len = mut_out_len;
+        } else {
+            eng_status = ca_engine_mutate(engine, &request, &output);
+        }
 
         if (eng_status != ref_status) {
             fprintf(stderr, "status mismatch at call=%zu: ref=%d eng=%d\n", call,
@@ -104,7 +113,7 @@ static bool check_case(const uint8_t *input, size_t input_len,
             break;
         }
 
-        memcpy(mut_out, output.value.buffer.data, mut_out_len);
+        if (!into) memcpy(mut_out, output.value.buffer.data, mut_out_len);
 
         if (mut_out_len != ref_out_len || memcmp(ref_out, mut_out, mut_out_len) != 0) {
             fprintf(stderr, "mismatch at call=%zu: ref_len=%zu eng_len=%zu\n", call,
@@ -146,14 +155,18 @@ int main(void) {
 
     bool ok = true;
 
-    ok &= check_case(case_0, 0, 1024, 4, seed, seed_len);
-    ok &= check_case(case_1, sizeof(case_1), 1024, 4, seed, seed_len);
-    ok &= check_case(case_255, sizeof(case_255), 1024, 4, seed, seed_len);
-    ok &= check_case(case_256, sizeof(case_256), 1024, 3, seed, seed_len);
-    ok &= check_case(case_257, sizeof(case_257), 1024, 3, seed, seed_len);
-
-    ok &= check_case(sequential_seed, sizeof(sequential_seed), 4096, 8, seed,
-                     seed_len);
+    // Every case runs through ca_engine_mutate and through ca_engine_mutate_into,
+    // which writes the last generation straight into the caller buffer.
+    for (int into = 0; into <= 1; ++into) {
+        ok &= check_case(case_0, 0, 1024, 4, seed, seed_len, into);
+        ok &= check_case(case_1, sizeof(case_1), 1024, 4, seed, seed_len, into);
+        ok &= check_case(case_255, sizeof(case_255), 1024, 4, seed, seed_len, into);
+        ok &= check_case(case_256, sizeof(case_256), 1024, 3, seed, seed_len, into);
+        ok &= check_case(case_257, sizeof(case_257), 1024, 3, seed, seed_len, into);
+        ok &= check_case(sequential_seed, sizeof(sequential_seed), 4096, 8, seed,
+                         seed_len, into);
+        ok &= check_case(case_257, sizeof(case_257), 100, 3, seed, seed_len, into);
+    }
 
     if (!ok) {
         return 1;